@@ -2,7 +2,9 @@
 // Created by Matthew McCall on 2/19/25.
 //
 
+#include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <ranges>
@@ -15,6 +17,7 @@
 #include <isocline.h>
 
 #include "Oasis/DifferentiateVisitor.hpp"
+#include "Oasis/RuleProfiler.hpp"
 #include "Oasis/SimplifyVisitor.hpp"
 
 template <typename FnT>
@@ -39,10 +42,25 @@ auto trim_whitespace(const std::string& str) -> std::string
 // Calling Oasis::FromInFix passed as template fails because defaulted parameters aren't represented in the type, so a wrapper is needed
 auto Parse(const std::string& in) -> Oasis::FromInFixResult { return Oasis::FromInFix(in); };
 
+auto PrintRuleStats(const std::vector<Oasis::RuleStats>& stats) -> void
+{
+    std::size_t nameWidth = std::string_view { "Rule" }.size();
+    for (const Oasis::RuleStats& ruleStats : stats)
+        nameWidth = std::max(nameWidth, ruleStats.name.size());
+
+    const auto toMicroseconds = [](std::chrono::nanoseconds time) { return std::chrono::duration<double, std::micro>(time).count(); };
+
+    fmt::println("  {:<{}}  {:>10}  {:>10}  {:>12}  {:>14}", "Rule", nameWidth, "Attempts", "Hits", "Match (us)", "Transform (us)");
+    for (const Oasis::RuleStats& ruleStats : stats)
+        fmt::println("  {:<{}}  {:>10}  {:>10}  {:>12.1f}  {:>14.1f}", ruleStats.name, nameWidth, ruleStats.attempts, ruleStats.hits,
+            toMicroseconds(ruleStats.matchTime), toMicroseconds(ruleStats.transformTime));
+}
+
 int main(int argc, char** argv)
 {
     Oasis::InFixSerializer serializer;
     Oasis::SimplifyVisitor simplifyVisitor;
+    const auto profiler = std::make_shared<Oasis::RuleProfiler>();
 
     constexpr auto err_style = fg(fmt::color::indian_red);
     constexpr auto success_style = fg(fmt::color::green);
@@ -59,6 +77,25 @@ int main(int argc, char** argv)
         if (input == "exit")
             break;
 
+        // "profile" toggles recording which simplification rules fire, and "stats" prints them
+        if (input == "profile") {
+            if constexpr (!Oasis::RuleProfiler::Enabled) {
+                fmt::println("  {}", fmt::styled("Oasis was built without OASIS_BUILD_PROFILING", err_style));
+            } else if (simplifyVisitor.GetProfiler()) {
+                simplifyVisitor.SetProfiler(nullptr);
+                fmt::println("  {}", fmt::styled("Profiling off", success_style));
+            } else {
+                simplifyVisitor.SetProfiler(profiler);
+                fmt::println("  {}", fmt::styled("Profiling on", success_style));
+            }
+            continue;
+        }
+        if (input == "stats") {
+            PrintRuleStats(profiler->GetStats());
+            profiler->Reset();
+            continue;
+        }
+
         // Calling Oasis::FromInFix passed as template fails because defaulted parameters aren't represented in the type, so a wrapper is needed
         auto result = (input | Oasis::PreProcessInFix | Parse)
                           .and_then([&simplifyVisitor](const std::unique_ptr<Oasis::Expression>& expr) -> std::expected<gsl_lite::not_null<std::unique_ptr<Oasis::Expression>>, std::string> {
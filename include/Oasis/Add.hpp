@@ -148,6 +148,11 @@ public:
     {
     }
 
+    Add(std::unique_ptr<AugendT>&& addend1, std::unique_ptr<AddendT>&& addend2)
+        : BinaryExpression<Add, AugendT, AddendT>(std::move(addend1), std::move(addend2))
+    {
+    }
+
     auto operator=(const Add& other) -> Add& = default;
 
     EXPRESSION_TYPE(Add)
@@ -8,9 +8,9 @@
 #include <algorithm>
 #include <cassert>
 #include <functional>
-#include <list>
 
 #include "Expression.hpp"
+#include "ExpressionArena.hpp"
 #include "Oasis/SimplifyVisitor.hpp"
 #include "RecursiveCast.hpp"
 #include "Visit.hpp"
@@ -32,14 +32,18 @@ template <template <typename, typename> typename T>
 concept IAssociativeAndCommutative = IExpression<T<Expression, Expression>> && ((T<Expression, Expression>::GetStaticCategory() & (Associative | Commutative)) == (Associative | Commutative));
 
 /**
- * Builds a reasonably balanced binary expression from a vector of operands.
+ * Builds a reasonably balanced binary expression from a vector of shared operands.
+ *
+ * Adjacent operands are paired up from left to right, and the pairs are paired up again until a
+ * single expression remains, which takes linear time. The operands are adopted, not copied.
+ *
  * @tparam T The type of the binary expression, e.g. Add or Multiply.
  * @param ops The vector of operands. Must have a minimum of 2 operands.
  * @return A binary expression with the operands in the vector, or a nullptr if ops.size() <=1.
  */
 template <template <typename, typename> typename T>
     requires IAssociativeAndCommutative<T>
-auto BuildFromVector(const std::vector<std::unique_ptr<Expression>>& ops) -> std::unique_ptr<T<Expression, Expression>>
+auto BuildFromVector(std::vector<std::shared_ptr<const Expression>> ops) -> std::unique_ptr<T<Expression, Expression>>
 {
     if (ops.size() <= 1) {
         return nullptr;
@@ -47,21 +51,68 @@ auto BuildFromVector(const std::vector<std::unique_ptr<Expression>>& ops) -> std
 
     using GeneralizedT = T<Expression, Expression>;
 
-    std::list<std::unique_ptr<Expression>> opsList;
-    opsList.resize(ops.size());
+    const auto pair = [](std::shared_ptr<const Expression>&& lhs, std::shared_ptr<const Expression>&& rhs) {
+        auto node = std::make_unique<GeneralizedT>();
+        node->SetMostSigOp(std::move(lhs));
+        node->SetLeastSigOp(std::move(rhs));
+        return node;
+    };
 
-    std::transform(ops.begin(), ops.end(), opsList.begin(), [](const auto& op) { return op->Copy(); });
+    while (ops.size() > 2) {
+        std::size_t paired = 0;
 
-    while (std::next(opsList.begin()) != opsList.end()) {
-        for (auto i = opsList.begin(); i != opsList.end() && std::next(i) != opsList.end();) {
-            auto node = std::make_unique<GeneralizedT>(**i, **std::next(i));
-            opsList.insert(i, std::move(node));
-            i = opsList.erase(i, std::next(i, 2));
+        for (std::size_t i = 0; i + 1 < ops.size(); i += 2) {
+            ops[paired++] = ShareOperand(pair(std::move(ops[i]), std::move(ops[i + 1])));
         }
+
+        if (ops.size() % 2 == 1) {
+            ops[paired++] = std::move(ops.back());
+        }
+
+        ops.resize(paired);
+    }
+
+    return pair(std::move(ops[0]), std::move(ops[1]));
+}
+
+/**
+ * Builds a reasonably balanced binary expression from a vector of operands, adopting them.
+ * @tparam T The type of the binary expression, e.g. Add or Multiply.
+ * @param ops The vector of operands. Must have a minimum of 2 operands.
+ * @return A binary expression with the operands in the vector, or a nullptr if ops.size() <=1.
+ */
+template <template <typename, typename> typename T>
+    requires IAssociativeAndCommutative<T>
+auto BuildFromVector(std::vector<std::unique_ptr<Expression>>&& ops) -> std::unique_ptr<T<Expression, Expression>>
+{
+    std::vector<std::shared_ptr<const Expression>> shared;
+    shared.reserve(ops.size());
+
+    for (auto& op : ops) {
+        shared.push_back(ShareOperand(std::move(op)));
+    }
+
+    return BuildFromVector<T>(std::move(shared));
+}
+
+/**
+ * Builds a reasonably balanced binary expression from a vector of operands.
+ * @tparam T The type of the binary expression, e.g. Add or Multiply.
+ * @param ops The vector of operands. Must have a minimum of 2 operands.
+ * @return A binary expression with the operands in the vector, or a nullptr if ops.size() <=1.
+ */
+template <template <typename, typename> typename T>
+    requires IAssociativeAndCommutative<T>
+auto BuildFromVector(const std::vector<std::unique_ptr<Expression>>& ops) -> std::unique_ptr<T<Expression, Expression>>
+{
+    std::vector<std::shared_ptr<const Expression>> shared;
+    shared.reserve(ops.size());
+
+    for (const auto& op : ops) {
+        shared.push_back(ShareOperand(op->Copy()));
     }
 
-    auto* result = dynamic_cast<GeneralizedT*>(opsList.front().release());
-    return std::unique_ptr<GeneralizedT>(result);
+    return BuildFromVector<T>(std::move(shared));
 }
 
 /**
@@ -87,15 +138,16 @@ class BinaryExpression : public Expression {
 
 public:
     BinaryExpression() = default;
+
+    /**
+     * Copies a binary expression. Operands are immutable, so the copy shares them with other
+     * instead of duplicating the subtrees.
+     */
     BinaryExpression(const BinaryExpression& other)
+        : Expression(other)
+        , mostSigOp(other.mostSigOp)
+        , leastSigOp(other.leastSigOp)
     {
-        if (other.HasMostSigOp()) {
-            SetMostSigOp(other.GetMostSigOp());
-        }
-
-        if (other.HasLeastSigOp()) {
-            SetLeastSigOp(other.GetLeastSigOp());
-        }
     }
 
     BinaryExpression(const MostSigOpT& mostSigOp, const LeastSigOpT& leastSigOp)
@@ -104,24 +156,33 @@ public:
         SetLeastSigOp(leastSigOp);
     }
 
+    /**
+     * Constructs a binary expression that takes ownership of its operands instead of copying them.
+     */
+    BinaryExpression(std::unique_ptr<MostSigOpT>&& mostSigOp, std::unique_ptr<LeastSigOpT>&& leastSigOp)
+        : mostSigOp(ShareOperand(std::move(mostSigOp)))
+        , leastSigOp(ShareOperand(std::move(leastSigOp)))
+    {
+    }
+
     template <IExpression Op1T, IExpression Op2T, IExpression... OpsT>
     BinaryExpression(const Op1T& op1, const Op2T& op2, const OpsT&... ops)
     {
         static_assert(IAssociativeAndCommutative<DerivedT>, "List initializer only supported for associative and commutative expressions");
         static_assert(std::is_same_v<DerivedGeneralized, DerivedSpecialized>, "List initializer only supported for generalized expressions");
 
-        std::vector<std::unique_ptr<Expression>> opsVec;
+        std::vector<std::shared_ptr<const Expression>> opsVec;
 
         for (auto opWrapper : std::vector<std::reference_wrapper<const Expression>> { static_cast<const Expression&>(op1), static_cast<const Expression&>(op2), (static_cast<const Expression&>(ops))... }) {
             const Expression& operand = opWrapper.get();
-            opsVec.emplace_back(operand.Copy());
+            opsVec.push_back(ShareOperand(operand.Copy()));
         }
 
         // build expression from vector
-        auto generalized = BuildFromVector<DerivedT>(opsVec);
+        auto generalized = BuildFromVector<DerivedT>(std::move(opsVec));
 
-        SetLeastSigOp(generalized->GetLeastSigOp());
-        SetMostSigOp(generalized->GetMostSigOp());
+        mostSigOp = generalized->mostSigOp;
+        leastSigOp = generalized->leastSigOp;
     }
 
     [[nodiscard]] auto Copy() const -> std::unique_ptr<Expression> final
@@ -131,7 +192,11 @@ public:
 
     [[nodiscard]] auto Equals(const Expression& other) const -> bool final
     {
-        if (this->GetType() != other.GetType()) {
+        if (this == &other) {
+            return true;
+        }
+
+        if (this->GetType() != other.GetType() || this->GetHash() != other.GetHash()) {
             return false;
         }
 
@@ -164,8 +229,8 @@ public:
             return false;
         }
 
-        auto thisFlattened = std::vector<std::unique_ptr<Expression>> {};
-        auto otherFlattened = std::vector<std::unique_ptr<Expression>> {};
+        auto thisFlattened = std::vector<const Expression*> {};
+        auto otherFlattened = std::vector<const Expression*> {};
 
         this->Flatten(thisFlattened);
         otherBinaryGeneralized.Flatten(otherFlattened);
@@ -184,17 +249,11 @@ public:
 
     [[nodiscard]] auto Generalize() const -> std::unique_ptr<Expression> final
     {
-        DerivedGeneralized generalized;
-
-        if (this->mostSigOp) {
-            generalized.SetMostSigOp(*this->mostSigOp->Copy());
-        }
-
-        if (this->leastSigOp) {
-            generalized.SetLeastSigOp(*this->leastSigOp->Copy());
-        }
+        auto generalized = std::make_unique<DerivedGeneralized>();
+        generalized->mostSigOp = this->mostSigOp;
+        generalized->leastSigOp = this->leastSigOp;
 
-        return std::make_unique<DerivedGeneralized>(generalized);
+        return generalized;
     }
 
     [[nodiscard]] auto Integrate(const Expression& integrationVariable) const -> std::unique_ptr<Expression> override
@@ -204,6 +263,10 @@ public:
 
     [[nodiscard]] auto StructurallyEquivalent(const Expression& other) const -> bool final
     {
+        if (this == &other) {
+            return true;
+        }
+
         if (this->GetType() != other.GetType()) {
             return false;
         }
@@ -243,24 +306,43 @@ public:
      */
     auto Flatten(std::vector<std::unique_ptr<Expression>>& out) const -> void
     {
-        if (mostSigOp) {
-            if (this->mostSigOp->template Is<DerivedGeneralized>()) {
-                auto generalizedMostSigOp = this->mostSigOp->Generalize();
-                const auto& mostSigOp = static_cast<const DerivedGeneralized&>(*generalizedMostSigOp);
-                mostSigOp.Flatten(out);
-            } else {
-                out.push_back(this->mostSigOp->Copy());
-            }
+        std::vector<const Expression*> operands;
+        Flatten(operands);
+
+        out.reserve(out.size() + operands.size());
+        for (const Expression* operand : operands) {
+            out.push_back(operand->Copy());
         }
+    }
+
+    /**
+     * Flattens this expression without copying its operands.
+     *
+     * Works like the overload above, but collects pointers to the operands in place. The pointers
+     * remain valid for as long as this expression is alive.
+     * @param out The vector to append pointers to the operands to.
+     */
+    auto Flatten(std::vector<const Expression*>& out) const -> void
+    {
+        for (const Expression* operand : { static_cast<const Expression*>(mostSigOp.get()), static_cast<const Expression*>(leastSigOp.get()) }) {
+            if (operand == nullptr) {
+                continue;
+            }
 
-        if (leastSigOp) {
-            if (this->leastSigOp->template Is<DerivedGeneralized>()) {
-                auto generalizedLeastSigOp = this->leastSigOp->Generalize();
-                const auto& leastSigOp = static_cast<const DerivedGeneralized&>(*generalizedLeastSigOp);
-                leastSigOp.Flatten(out);
-            } else {
-                out.push_back(this->leastSigOp->Copy());
+            if (!operand->template Is<DerivedGeneralized>()) {
+                out.push_back(operand);
+                continue;
             }
+
+            if (const auto* generalizedOperand = dynamic_cast<const DerivedGeneralized*>(operand)) {
+                generalizedOperand->Flatten(out);
+                continue;
+            }
+
+            // Generalizing shares the operands of the nested expression, so they outlive the
+            // temporary and are still owned by this expression.
+            const auto generalized = operand->Generalize();
+            static_cast<const DerivedGeneralized&>(*generalized).Flatten(out);
         }
     }
 
@@ -284,6 +366,23 @@ public:
         return *leastSigOp;
     }
 
+    [[nodiscard]] auto GetOperandAt(std::size_t index) const -> const Expression* final
+    {
+        switch (index) {
+        case 0:
+            return mostSigOp.get();
+        case 1:
+            return leastSigOp.get();
+        default:
+            return nullptr;
+        }
+    }
+
+    [[nodiscard]] auto GetOperandCount() const -> std::size_t final
+    {
+        return 2;
+    }
+
     /**
      * Gets whether this expression has a most significant operand.
      * @return True if this expression has a most significant operand, false otherwise.
@@ -311,17 +410,20 @@ public:
     auto SetMostSigOp(const T& op) -> bool
     {
         if constexpr (std::same_as<MostSigOpT, Expression>) {
-            this->mostSigOp = op.Copy();
+            this->mostSigOp = ShareOperand(op.Copy());
+            InvalidateHash();
             return true;
         }
 
         if constexpr (std::same_as<MostSigOpT, T> && !std::same_as<MostSigOpT, Expression>) {
-            this->mostSigOp = std::make_unique<MostSigOpT>(op);
+            this->mostSigOp = ShareOperand(std::make_unique<MostSigOpT>(op));
+            InvalidateHash();
             return true;
         }
 
         if (auto castedOp = Oasis::RecursiveCast<MostSigOpT>(op); castedOp) {
-            mostSigOp = std::move(castedOp);
+            mostSigOp = ShareOperand(std::move(castedOp));
+            InvalidateHash();
             return true;
         }
 
@@ -337,23 +439,74 @@ public:
     auto SetLeastSigOp(const T& op) -> bool
     {
         if constexpr (std::same_as<LeastSigOpT, Expression>) {
-            this->leastSigOp = op.Copy();
+            this->leastSigOp = ShareOperand(op.Copy());
+            InvalidateHash();
             return true;
         }
 
         if constexpr (std::same_as<LeastSigOpT, T> && !std::same_as<LeastSigOpT, Expression>) {
-            this->leastSigOp = std::make_unique<LeastSigOpT>(op);
+            this->leastSigOp = ShareOperand(std::make_unique<LeastSigOpT>(op));
+            InvalidateHash();
             return true;
         }
 
         if (auto castedOp = Oasis::RecursiveCast<LeastSigOpT>(op); castedOp) {
-            leastSigOp = std::move(castedOp);
+            leastSigOp = ShareOperand(std::move(castedOp));
+            InvalidateHash();
             return true;
         }
 
         return false;
     }
 
+    /**
+     * Sets the most significant operand of this expression, taking ownership of it instead of
+     * copying it.
+     * @param op The operand to set.
+     */
+    template <typename T>
+        requires std::derived_from<T, MostSigOpT>
+    auto SetMostSigOp(std::unique_ptr<T>&& op) -> void
+    {
+        this->mostSigOp = ShareOperand(std::move(op));
+        InvalidateHash();
+    }
+
+    /**
+     * Sets the least significant operand of this expression, taking ownership of it instead of
+     * copying it.
+     * @param op The operand to set.
+     */
+    template <typename T>
+        requires std::derived_from<T, LeastSigOpT>
+    auto SetLeastSigOp(std::unique_ptr<T>&& op) -> void
+    {
+        this->leastSigOp = ShareOperand(std::move(op));
+        InvalidateHash();
+    }
+
+    /**
+     * Sets the most significant operand of this expression without copying it. The operand may be
+     * shared with other expressions, e.g. nodes interned by an ExpressionStore.
+     * @param op The operand to set.
+     */
+    auto SetMostSigOp(std::shared_ptr<const MostSigOpT> op) -> void
+    {
+        this->mostSigOp = std::move(op);
+        InvalidateHash();
+    }
+
+    /**
+     * Sets the least significant operand of this expression without copying it. The operand may be
+     * shared with other expressions, e.g. nodes interned by an ExpressionStore.
+     * @param op The operand to set.
+     */
+    auto SetLeastSigOp(std::shared_ptr<const LeastSigOpT> op) -> void
+    {
+        this->leastSigOp = std::move(op);
+        InvalidateHash();
+    }
+
     auto Substitute(const Expression& var, const Expression& val) -> std::unique_ptr<Expression> override
     {
         // TODO: FIX WITH VISITOR?
@@ -381,13 +534,45 @@ public:
 
     auto AcceptInternal(Visitor& visitor) const -> any override
     {
-        const auto generalized = Generalize();
-        const auto& derivedGeneralized = dynamic_cast<const DerivedGeneralized&>(*generalized);
-        return visitor.Visit(derivedGeneralized);
+        assert(this->GetType() == DerivedGeneralized::GetStaticType());
+
+        // Generalized nodes are handed to the visitor as-is. Only specialized nodes (e.g. the
+        // results of RecursiveCast) need to be converted before they can be visited.
+        if constexpr (std::is_same_v<DerivedSpecialized, DerivedGeneralized>) {
+            return visitor.Visit(*static_cast<const DerivedGeneralized*>(this));
+        } else {
+            const auto generalized = Generalize();
+            return visitor.Visit(static_cast<const DerivedGeneralized&>(*generalized));
+        }
     }
 
-    std::unique_ptr<MostSigOpT> mostSigOp;
-    std::unique_ptr<LeastSigOpT> leastSigOp;
+    std::shared_ptr<const MostSigOpT> mostSigOp;
+    std::shared_ptr<const LeastSigOpT> leastSigOp;
+
+protected:
+    [[nodiscard]] auto ComputeHash() const -> std::uint64_t override
+    {
+        const std::uint64_t seed = Expression::ComputeHash();
+
+        if (!(this->GetCategory() & Associative)) {
+            const std::uint64_t mostSigOpHash = mostSigOp ? mostSigOp->GetHash() : 0;
+            const std::uint64_t leastSigOpHash = leastSigOp ? leastSigOp->GetHash() : 0;
+            return CombineHash(CombineHash(seed, mostSigOpHash), leastSigOpHash);
+        }
+
+        // Operands of associative expressions are summed, so neither their order nor their
+        // grouping matters. An operand of the same type contributes its own sum, which yields
+        // the same hash as flattening it into this expression.
+        const auto operandHash = [this, seed](const Expression* op) -> std::uint64_t {
+            if (op == nullptr) {
+                return 0;
+            }
+
+            return op->GetType() == this->GetType() ? op->GetHash() - seed : MixHash(op->GetHash());
+        };
+
+        return seed + operandHash(mostSigOp.get()) + operandHash(leastSigOp.get());
+    }
 };
 
 } // Oasis
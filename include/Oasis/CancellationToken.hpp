@@ -0,0 +1,222 @@
+#ifndef OASIS_CANCELLATIONTOKEN_HPP
+#define OASIS_CANCELLATIONTOKEN_HPP
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+#include "Expression.hpp"
+
+namespace Oasis {
+
+/**
+ * Why a computation was stopped early.
+ */
+enum class CancellationReason : std::uint8_t {
+    Cancelled = 1,
+    DeadlineExceeded,
+    VisitBudgetExceeded,
+    MemoryBudgetExceeded,
+};
+
+/**
+ * Stops long-running computations cooperatively.
+ *
+ * A token carries a deadline, a budget of expression nodes to visit and a budget of memory to
+ * allocate for expression nodes, and may also be cancelled explicitly from any thread. While a
+ * CancellationScope makes a token current on a thread, SimplifyVisitor, DifferentiateVisitor and
+ * Expression::Integrate count every node they visit against it. Once the token has expired, they
+ * stop working and return the rest of their input unevaluated: SimplifyVisitor leaves
+ * subexpressions as they are, DifferentiateVisitor wraps them in a Derivative and Integrate in an
+ * Integral. The result is therefore always equal to the exact one, only less evaluated.
+ *
+ * Limits must be set before the computation starts. Use WithCancellation to run a computation and
+ * tell a complete result apart from a partial one.
+ */
+class CancellationToken {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    CancellationToken() = default;
+    CancellationToken(const CancellationToken& other) = delete;
+    auto operator=(const CancellationToken& other) -> CancellationToken& = delete;
+
+    /**
+     * Sets the point in time after which computations stop.
+     * @param time The deadline.
+     */
+    auto SetDeadline(Clock::time_point time) -> void;
+
+    /**
+     * Sets the deadline relative to now.
+     * @param timeout The time computations may take from now.
+     */
+    auto SetTimeout(Clock::duration timeout) -> void;
+
+    /**
+     * Sets the number of expression nodes that may be visited.
+     * @param budget The budget of visits.
+     */
+    auto SetVisitBudget(std::uint64_t budget) -> void;
+
+    /**
+     * Sets the number of bytes that may be allocated for expression nodes, without subtracting
+     * memory that was freed.
+     * @param bytes The budget of memory.
+     */
+    auto SetMemoryBudget(std::size_t bytes) -> void;
+
+    /**
+     * Stops the computations using this token as soon as they next check it. Safe to call from any
+     * thread.
+     */
+    auto Cancel() -> void;
+
+    /**
+     * Counts the visit of an expression node and checks every limit of this token.
+     * @return Whether the computation should stop.
+     */
+    auto Visit() -> bool;
+
+    /**
+     * Counts memory allocated for expression nodes.
+     * @param bytes The number of bytes allocated.
+     */
+    auto Allocate(std::size_t bytes) -> void;
+
+    /**
+     * Gets whether this token has expired or was cancelled.
+     * @return Whether computations using this token should stop.
+     */
+    [[nodiscard]] auto IsCancelled() const -> bool;
+
+    /**
+     * Gets the reason this token expired.
+     * @return The reason, or std::nullopt if it has not.
+     */
+    [[nodiscard]] auto GetReason() const -> std::optional<CancellationReason>;
+
+    /**
+     * Gets the number of expression nodes visited so far.
+     * @return The number of visits.
+     */
+    [[nodiscard]] auto GetVisits() const -> std::uint64_t;
+
+    /**
+     * Gets the number of bytes allocated for expression nodes so far.
+     * @return The number of bytes.
+     */
+    [[nodiscard]] auto GetBytesAllocated() const -> std::size_t;
+
+    /**
+     * Gets the token that is current on this thread.
+     * @return The current token, or nullptr if computations on this thread cannot be cancelled.
+     */
+    [[nodiscard]] static auto Current() -> CancellationToken*;
+
+private:
+    auto Expire(CancellationReason expiredReason) -> bool;
+
+    std::atomic<std::uint8_t> reason = 0;
+    std::atomic<std::uint64_t> visits = 0;
+    std::atomic<std::size_t> bytesAllocated = 0;
+
+    Clock::time_point deadline = Clock::time_point::max();
+    std::uint64_t visitBudget = std::numeric_limits<std::uint64_t>::max();
+    std::size_t memoryBudget = std::numeric_limits<std::size_t>::max();
+};
+
+/**
+ * Makes a token current on this thread for as long as it is alive. Scopes nest, restoring the
+ * previously current token when they are destroyed.
+ */
+class CancellationScope {
+public:
+    explicit CancellationScope(CancellationToken& token);
+
+    /**
+     * Makes a token current on this thread.
+     * @param token The token, or nullptr to make computations on this thread uncancellable.
+     */
+    explicit CancellationScope(CancellationToken* token);
+
+    CancellationScope(const CancellationScope& other) = delete;
+    auto operator=(const CancellationScope& other) -> CancellationScope& = delete;
+
+    ~CancellationScope();
+
+private:
+    CancellationToken* previous;
+};
+
+/**
+ * Counts a visit against the token current on this thread, if any.
+ * @return Whether the computation should stop.
+ */
+auto CheckCancellation() -> bool;
+
+/**
+ * The error of a computation run with WithCancellation.
+ */
+struct ComputationError {
+    /**
+     * A description of the error.
+     */
+    std::string message;
+
+    /**
+     * Why the computation was stopped, or std::nullopt if it failed for another reason.
+     */
+    std::optional<CancellationReason> reason {};
+
+    /**
+     * If the computation was stopped, the partially evaluated result it had reached.
+     */
+    std::unique_ptr<Expression> partialResult {};
+};
+
+/**
+ * Runs a computation with a token current on this thread.
+ *
+ * @param token The token limiting the computation.
+ * @param computation A callable returning either the result of Expression::Accept with
+ * SimplifyVisitor or DifferentiateVisitor, or the result of Expression::Integrate.
+ * @return The result if the computation finished, or an error holding the partial result if the
+ * token expired.
+ */
+template <typename ComputationT>
+auto WithCancellation(CancellationToken& token, ComputationT&& computation) -> std::expected<std::unique_ptr<Expression>, ComputationError>
+{
+    std::unique_ptr<Expression> result;
+    {
+        CancellationScope scope { token };
+
+        if constexpr (std::convertible_to<std::invoke_result_t<ComputationT>, std::unique_ptr<Expression>>) {
+            result = std::forward<ComputationT>(computation)();
+        } else {
+            auto computed = std::forward<ComputationT>(computation)();
+            if (!computed) {
+                return std::unexpected { ComputationError { .message = std::string { computed.error() }, .reason = token.GetReason() } };
+            }
+            result = std::move(computed).value();
+        }
+    }
+
+    if (const auto reason = token.GetReason()) {
+        return std::unexpected { ComputationError { .message = "Computation was cancelled", .reason = reason, .partialResult = std::move(result) } };
+    }
+
+    return result;
+}
+
+} // Oasis
+
+#endif // OASIS_CANCELLATIONTOKEN_HPP
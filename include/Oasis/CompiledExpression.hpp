@@ -0,0 +1,189 @@
+#ifndef OASIS_COMPILEDEXPRESSION_HPP
+#define OASIS_COMPILEDEXPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "SymbolTable.hpp"
+
+namespace Oasis {
+
+class Expression;
+
+/**
+ * An expression compiled to a flat program, for evaluating it at many points.
+ *
+ * A program is a list of instructions over a file of registers, each instruction reading up to
+ * two registers and writing one. Evaluating it is a single loop over contiguous instructions, so
+ * it avoids the pointer chasing and virtual calls of walking the expression.
+ *
+ * Instructions are grouped into stages, one per variable, by the last variable in the order
+ * they depend on. Instructions that depend on no variable are in the first stage. Evaluating
+ * points that share the values of the first few variables, as on a grid, only needs the stages
+ * of the remaining variables to be rerun, since the values computed by earlier stages are kept.
+ *
+ * Programs are made by Compile, and evaluate with doubles. Results that would be complex, such
+ * as the logarithm of a negative number, are NaN.
+ */
+class CompiledExpression {
+public:
+    /**
+     * The operation of an instruction.
+     */
+    enum class OpCode : std::uint8_t {
+        /** Loads the immediate. */
+        Constant,
+        /** Loads the value of the variable at index first. */
+        Variable,
+        /** Adds first and second. */
+        Add,
+        /** Subtracts second from first. */
+        Subtract,
+        /** Multiplies first by second. */
+        Multiply,
+        /** Divides first by second. */
+        Divide,
+        /** Negates first. */
+        Negate,
+        /** Takes the square root of first. */
+        Sqrt,
+        /** Raises first to the integer immediate, by repeated squaring. */
+        IntegerPower,
+        /** Raises first to second. */
+        Power,
+        /** Raises e to first. */
+        Exp,
+        /** Takes the logarithm of second in base first. */
+        Log,
+        /** Takes the natural logarithm of first. */
+        NaturalLog,
+        /** Takes the sine of first. */
+        Sine,
+        /** Takes the absolute value of first. */
+        Abs
+    };
+
+    /**
+     * An instruction of a program.
+     */
+    struct Instruction {
+        OpCode op = OpCode::Constant;
+
+        /**
+         * The register written by the instruction.
+         */
+        std::uint32_t result = 0;
+
+        /**
+         * The first register read by the instruction, or the index of a variable.
+         */
+        std::uint32_t first = 0;
+
+        /**
+         * The second register read by the instruction.
+         */
+        std::uint32_t second = 0;
+
+        /**
+         * The constant or integer power of the instruction.
+         */
+        double immediate = 0.0;
+    };
+
+    /**
+     * Evaluates the program, using caller provided registers so that nothing is allocated.
+     * @param values The values of the variables, in the order the program was compiled with.
+     * @param registers Space for at least GetRegisterCount() values.
+     * @return The value of the expression.
+     */
+    [[nodiscard]] auto Evaluate(std::span<const double> values, std::span<double> registers) const -> double;
+
+    /**
+     * Evaluates the program, using registers kept for the calling thread.
+     * @param values The values of the variables, in the order the program was compiled with.
+     * @return The value of the expression.
+     */
+    [[nodiscard]] auto Evaluate(std::span<const double> values) const -> double;
+
+    /**
+     * Gets the instructions of the program, in the order they run.
+     * @return The instructions.
+     */
+    [[nodiscard]] auto GetInstructions() const -> std::span<const Instruction>;
+
+    /**
+     * Gets the instructions of a stage, which depend on the variable at an index and on no
+     * variable after it.
+     * @param variable The index of the variable of the stage.
+     * @return The instructions of the stage, in the order they run.
+     */
+    [[nodiscard]] auto GetStage(std::size_t variable) const -> std::span<const Instruction>;
+
+    /**
+     * Gets the number of stages of the program, which is the number of variables, or one if
+     * there are none.
+     * @return The number of stages.
+     */
+    [[nodiscard]] auto GetStageCount() const -> std::size_t;
+
+    /**
+     * Gets the number of registers the program needs.
+     * @return The number of registers.
+     */
+    [[nodiscard]] auto GetRegisterCount() const -> std::size_t;
+
+    /**
+     * Gets the variables of the program, in the order their values are passed.
+     * @return The symbols of the variables.
+     */
+    [[nodiscard]] auto GetVariables() const -> std::span<const SymbolId>;
+
+    /**
+     * Gets the register holding the value of the expression once the program has run.
+     * @return The result register.
+     */
+    [[nodiscard]] auto GetResultRegister() const -> std::uint32_t;
+
+private:
+    friend auto Compile(const Expression& expression, std::span<const SymbolId> variables) -> std::expected<CompiledExpression, std::string>;
+
+    std::vector<Instruction> instructions;
+    std::vector<SymbolId> variables;
+    std::vector<std::size_t> stageEnds;
+    std::size_t registerCount = 0;
+    std::uint32_t resultRegister = 0;
+};
+
+/**
+ * Compiles an expression to a program.
+ *
+ * Subexpressions that appear more than once are computed once, subexpressions without variables
+ * are folded into constants, and constant powers are reduced to cheaper operations, such as
+ * multiplications for small integer powers. Registers are reused once their values are no longer
+ * needed.
+ *
+ * @param expression The expression to compile.
+ * @param variables The variables of the expression, in the order their values will be passed.
+ * @return The program, or an error if the expression has a variable not in the order, or an
+ * expression that cannot be evaluated to a real number, such as the imaginary unit or a matrix.
+ */
+auto Compile(const Expression& expression, std::span<const SymbolId> variables) -> std::expected<CompiledExpression, std::string>;
+
+/**
+ * Compiles an expression to a program.
+ * @param expression The expression to compile.
+ * @param variables The names of the variables of the expression, in the order their values will
+ * be passed.
+ * @return The program, or an error if the expression cannot be compiled.
+ */
+auto Compile(const Expression& expression, std::initializer_list<std::string_view> variables) -> std::expected<CompiledExpression, std::string>;
+
+} // Oasis
+
+#endif // OASIS_COMPILEDEXPRESSION_HPP
@@ -0,0 +1,93 @@
+#ifndef OASIS_COMPILEDEXPRESSIONCACHE_HPP
+#define OASIS_COMPILEDEXPRESSIONCACHE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <expected>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CompiledExpression.hpp"
+#include "Expression.hpp"
+
+namespace Oasis {
+
+/**
+ * A bounded cache of compiled expressions, so that an expression evaluated again and again is
+ * compiled once.
+ *
+ * Entries are keyed by the structural hash of an expression together with its variable order, and
+ * are verified with Equals on lookup. When the cache is full, the least recently used entry is
+ * evicted. The cache is thread safe, and expressions are compiled outside of its lock.
+ */
+class CompiledExpressionCache {
+public:
+    /**
+     * Creates a cache.
+     * @param capacity The maximum number of entries held by the cache.
+     */
+    explicit CompiledExpressionCache(std::size_t capacity);
+
+    CompiledExpressionCache(const CompiledExpressionCache& other) = delete;
+
+    /**
+     * Gets the compiled form of an expression, compiling and caching it if it is not cached.
+     * @param expression The expression to compile.
+     * @param variables The variables of the expression, in the order their values will be passed.
+     * @return The compiled expression, or an error if the expression cannot be compiled.
+     */
+    auto Get(const Expression& expression, std::span<const SymbolId> variables) -> std::expected<std::shared_ptr<const CompiledExpression>, std::string>;
+
+    /**
+     * Removes every entry from the cache. The hit and miss counters are kept.
+     */
+    auto Clear() -> void;
+
+    /**
+     * Gets the number of lookups that found a compiled expression.
+     * @return The number of hits.
+     */
+    [[nodiscard]] auto GetHits() const -> std::size_t;
+
+    /**
+     * Gets the number of lookups that did not find a compiled expression.
+     * @return The number of misses.
+     */
+    [[nodiscard]] auto GetMisses() const -> std::size_t;
+
+    /**
+     * Gets the number of entries in the cache.
+     * @return The number of entries.
+     */
+    [[nodiscard]] auto Size() const -> std::size_t;
+
+    auto operator=(const CompiledExpressionCache& other) -> CompiledExpressionCache& = delete;
+
+private:
+    struct Entry {
+        std::uint64_t key;
+        std::shared_ptr<const Expression> expression;
+        std::shared_ptr<const CompiledExpression> compiled;
+    };
+
+    auto Find(std::uint64_t key, const Expression& expression, std::span<const SymbolId> variables) -> std::shared_ptr<const CompiledExpression>;
+
+    std::size_t capacity;
+    std::atomic<std::size_t> hits = 0;
+    std::atomic<std::size_t> misses = 0;
+
+    mutable std::mutex mutex;
+
+    // Most recently used entries are at the front.
+    std::list<Entry> entries;
+    std::unordered_map<std::uint64_t, std::list<Entry>::iterator> entriesByKey;
+};
+
+} // Oasis
+
+#endif // OASIS_COMPILEDEXPRESSIONCACHE_HPP
@@ -17,6 +17,7 @@ public:
     Derivative(const Derivative<Expression, Expression>& other) = default;
 
     Derivative(const Expression& Exp, const Expression& Var);
+    Derivative(std::unique_ptr<Expression>&& Exp, std::unique_ptr<Expression>&& Var);
 
     EXPRESSION_TYPE(Derivative)
     EXPRESSION_CATEGORY(BinExp)
@@ -70,6 +71,11 @@ public:
     {
     }
 
+    Derivative(std::unique_ptr<DependentT>&& exp, std::unique_ptr<IndependentT>&& var)
+        : BinaryExpression<Derivative, DependentT, IndependentT>(std::move(exp), std::move(var))
+    {
+    }
+
     auto operator=(const Derivative& other) -> Derivative& = default;
 
     EXPRESSION_TYPE(Derivative)
@@ -5,11 +5,16 @@
 #ifndef DIFFERENTIATEVISITOR_HPP
 #define DIFFERENTIATEVISITOR_HPP
 
+#include <cstddef>
 #include <format>
+#include <memory>
 #include <string>
+#include <utility>
 
 #include <gsl-lite/gsl-lite.hpp>
 
+#include "Oasis/SimplifyVisitor.hpp"
+#include "Oasis/ThreadPool.hpp"
 #include "Oasis/Visit.hpp"
 
 namespace Oasis {
@@ -46,9 +51,31 @@ public:
     auto TypedVisit(const Pi&) -> RetT override;
     auto TypedVisit(const Magnitude<Expression>& magnitude) -> RetT override;
 
+    /**
+     * Lets this visitor differentiate both operands of large sums, differences and products
+     * concurrently, each on a copy of this visitor. Small expressions are always differentiated
+     * sequentially.
+     *
+     * @param pool The pool to differentiate on, or nullptr to differentiate sequentially.
+     * @param threshold The number of nodes both operands of an expression must have together to be
+     * differentiated concurrently.
+     */
+    auto SetThreadPool(std::shared_ptr<ThreadPool> pool, std::size_t threshold = SimplifyVisitor::DefaultParallelThreshold) -> void;
+
+    /**
+     * Gets the pool this visitor differentiates on.
+     * @return The pool, or nullptr if this visitor differentiates sequentially.
+     */
+    [[nodiscard]] auto GetThreadPool() const -> std::shared_ptr<ThreadPool>;
+
 private:
+    auto DifferentiateOperands(const Expression& mostSigOp, const Expression& leastSigOp) -> std::pair<RetT, RetT>;
+
     std::unique_ptr<Expression> differentiationVariable;
     DifferentiationOpts opts;
+    std::shared_ptr<ThreadPool> threadPool;
+    std::size_t parallelThreshold = SimplifyVisitor::DefaultParallelThreshold;
+    std::size_t depth = 0;
 };
 
 } // Oasis
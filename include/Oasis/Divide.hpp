@@ -17,6 +17,7 @@ public:
     Divide(const Divide<Expression, Expression>& other) = default;
 
     Divide(const Expression& dividend, const Expression& divisor);
+    Divide(std::unique_ptr<Expression>&& dividend, std::unique_ptr<Expression>&& divisor);
 
     [[nodiscard]] auto Integrate(const Expression& integrationVariable) const -> std::unique_ptr<Expression> final;
 
@@ -123,6 +124,11 @@ public:
     {
     }
 
+    Divide(std::unique_ptr<DividendT>&& addend1, std::unique_ptr<DivisorT>&& addend2)
+        : BinaryExpression<Divide, DividendT, DivisorT>(std::move(addend1), std::move(addend2))
+    {
+    }
+
     auto operator=(const Divide& other) -> Divide& = default;
 
     EXPRESSION_TYPE(Divide)
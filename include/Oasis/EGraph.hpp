@@ -0,0 +1,296 @@
+#ifndef OASIS_EGRAPH_HPP
+#define OASIS_EGRAPH_HPP
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Expression.hpp"
+
+namespace Oasis {
+
+/**
+ * The id of an equivalence class in an EGraph.
+ */
+using EClassId = std::uint32_t;
+
+/**
+ * A node of an EGraph. A node is an operator applied to equivalence classes rather than to
+ * expressions, so a single node stands for every combination of the expressions in its operands'
+ * classes.
+ */
+struct ENode {
+    /**
+     * The type of the expression this node stands for.
+     */
+    ExpressionType type = ExpressionType::None;
+
+    /**
+     * The expression this node stands for if it is a leaf, such as a Real or a Variable, and
+     * nullptr otherwise.
+     */
+    std::shared_ptr<const Expression> leaf {};
+
+    /**
+     * The classes of the operands, in the order of Expression::GetOperandAt.
+     */
+    std::vector<EClassId> children {};
+
+    [[nodiscard]] auto GetHash() const -> std::uint64_t;
+
+    auto operator==(const ENode& other) const -> bool;
+};
+
+/**
+ * A cost function for extracting expressions from an EGraph. It is given a node and the costs of
+ * the cheapest expressions in each of its operands' classes, and must return a cost greater than
+ * each of them.
+ */
+using CostFunction = std::function<double(const ENode& node, std::span<const double> childCosts)>;
+
+/**
+ * A cost function that counts the nodes of an expression. Numbers count as half a node, so that
+ * 2x is preferred over x + x and x^3 over x * x * x.
+ */
+auto NodeCountCost(const ENode& node, std::span<const double> childCosts) -> double;
+
+/**
+ * A cost function that estimates how expensive an expression is to evaluate, weighing division,
+ * exponentiation and transcendental functions more than addition and multiplication.
+ */
+auto EvaluationCost(const ENode& node, std::span<const double> childCosts) -> double;
+
+class EGraph;
+
+/**
+ * A rewrite identity applied by EGraph::Saturate. It is called with every node of the graph
+ * together with the class of that node, and adds the equivalent forms it finds to the graph with
+ * EGraph::Add and EGraph::Merge. It must not remove anything, as an EGraph only ever grows.
+ */
+struct EGraphRewrite {
+    /**
+     * The name of the identity.
+     */
+    std::string name;
+
+    /**
+     * Applies the identity to a node of class eClass.
+     */
+    std::function<void(EGraph& graph, EClassId eClass, const ENode& node)> apply;
+};
+
+/**
+ * Gets the rewrite identities used by SimplifyVisitor, such as constant folding, combining like
+ * terms, merging exponents and merging logarithms, together with commutativity and associativity.
+ * @return The rewrites.
+ */
+auto DefaultRewrites() -> std::vector<EGraphRewrite>;
+
+/**
+ * An equality graph.
+ *
+ * An EGraph compactly stores many expressions that are known to be equal by grouping nodes into
+ * equivalence classes. Rewrites add equal forms of an expression instead of replacing it, so they
+ * can be applied in any order without one rewrite hiding an opportunity for another. Once the
+ * graph stops growing, or a limit is reached, the cheapest expression in a class can be extracted.
+ */
+class EGraph {
+public:
+    /**
+     * Adds an expression and all of its subexpressions to the graph.
+     * @param expression The expression to add.
+     * @return The class of the expression.
+     */
+    auto Add(const Expression& expression) -> EClassId;
+
+    /**
+     * Adds a node to the graph, unless an equal node is already present.
+     * @param node The node to add.
+     * @return The class of the node.
+     */
+    auto Add(ENode node) -> EClassId;
+
+    /**
+     * Adds a node for an operator applied to the given classes.
+     * @param type The type of the operator.
+     * @param children The classes of the operands.
+     * @return The class of the node.
+     */
+    auto Add(ExpressionType type, std::vector<EClassId> children) -> EClassId;
+
+    /**
+     * Adds a Real to the graph.
+     * @param value The value of the real number.
+     * @return The class of the real number.
+     */
+    auto AddReal(double value) -> EClassId;
+
+    /**
+     * Extracts the cheapest expression of a class.
+     * @param eClass The class to extract an expression from.
+     * @param costFunction The cost function to minimize.
+     * @return The cheapest expression of the class.
+     */
+    [[nodiscard]] auto Extract(EClassId eClass, const CostFunction& costFunction = NodeCountCost) const -> std::unique_ptr<Expression>;
+
+    /**
+     * Finds the canonical id of a class. Ids of classes that were merged have the same canonical
+     * id.
+     * @param eClass The class.
+     * @return The canonical id of the class.
+     */
+    [[nodiscard]] auto Find(EClassId eClass) const -> EClassId;
+
+    /**
+     * Gets the nodes of a class that have the given type.
+     * @param eClass The class.
+     * @param type The type of the nodes.
+     * @return Copies of the matching nodes.
+     */
+    [[nodiscard]] auto FindNodes(EClassId eClass, ExpressionType type) const -> std::vector<ENode>;
+
+    /**
+     * Gets the number of classes in the graph.
+     * @return The number of classes.
+     */
+    [[nodiscard]] auto GetClassCount() const -> std::size_t;
+
+    /**
+     * Gets the number of nodes in the graph.
+     * @return The number of nodes.
+     */
+    [[nodiscard]] auto GetNodeCount() const -> std::size_t;
+
+    /**
+     * Gets the value of a class if it contains a Real.
+     * @param eClass The class.
+     * @return The value of the real number, or std::nullopt if the class does not contain one.
+     */
+    [[nodiscard]] auto GetReal(EClassId eClass) const -> std::optional<double>;
+
+    /**
+     * Gets whether the graph has reached the node limit passed to Saturate. Rewrites that may add
+     * many nodes at once should stop once it has.
+     * @return Whether the graph is full.
+     */
+    [[nodiscard]] auto IsFull() const -> bool;
+
+    /**
+     * Records that two classes are equal.
+     *
+     * Nodes whose operands became equal are not merged until Rebuild is called.
+     * @param a The first class.
+     * @param b The second class.
+     * @return Whether the classes were different before.
+     */
+    auto Merge(EClassId a, EClassId b) -> bool;
+
+    /**
+     * Restores the invariants of the graph after calls to Merge by merging the classes of nodes
+     * that became equal, until no more such nodes remain.
+     */
+    auto Rebuild() -> void;
+
+    /**
+     * Applies rewrites to every node of the graph until they no longer change it, or until a limit
+     * is reached.
+     * @param rewrites The rewrites to apply.
+     * @param maxIterations The maximum number of times every rewrite is applied to every node.
+     * @param maxNodes The number of nodes after which no more rewrites are applied.
+     * @return Whether the graph stopped changing before a limit was reached.
+     */
+    auto Saturate(std::span<const EGraphRewrite> rewrites, std::size_t maxIterations, std::size_t maxNodes) -> bool;
+
+private:
+    struct ENodeHash {
+        auto operator()(const ENode& node) const -> std::size_t;
+    };
+
+    auto Canonicalize(ENode& node) const -> void;
+
+    // Indexed by class id. Only canonical ids have nodes, and classes are merged by size.
+    std::vector<EClassId> parents;
+    std::vector<std::vector<ENode>> classes;
+
+    // Every node that was ever added, including those dropped from classes that folded to a number.
+    std::unordered_map<ENode, EClassId, ENodeHash> memo;
+    std::size_t nodeCount = 0;
+    std::size_t nodeLimit = std::numeric_limits<std::size_t>::max();
+
+    // Incremented whenever a node is added or two classes are merged.
+    std::size_t version = 0;
+};
+
+/**
+ * Options for SimplifyWithEGraph.
+ */
+struct EGraphOpts {
+    /**
+     * The rewrites to saturate the graph with.
+     */
+    std::vector<EGraphRewrite> rewrites = DefaultRewrites();
+
+    /**
+     * The cost function to extract the result with.
+     */
+    CostFunction costFunction = NodeCountCost;
+
+    /**
+     * The maximum number of times every rewrite is applied to every node.
+     */
+    std::size_t maxIterations = 12;
+
+    /**
+     * The number of nodes after which no more rewrites are applied.
+     */
+    std::size_t maxNodes = 10000;
+};
+
+/**
+ * The result of SimplifyWithEGraph.
+ */
+struct EGraphResult {
+    /**
+     * The cheapest expression that was found.
+     */
+    std::unique_ptr<Expression> expression;
+
+    /**
+     * Whether the rewrites stopped changing the graph before a limit was reached. If so, no
+     * cheaper expression can be found with the same rewrites.
+     */
+    bool saturated = false;
+
+    /**
+     * The number of classes in the final graph.
+     */
+    std::size_t classes = 0;
+
+    /**
+     * The number of nodes in the final graph.
+     */
+    std::size_t nodes = 0;
+};
+
+/**
+ * Simplifies an expression by equality saturation.
+ *
+ * Unlike SimplifyVisitor, which applies the first identity that matches and discards the
+ * original, this adds the expression to an EGraph, applies every rewrite to every form it has
+ * found until nothing changes or a limit is reached, and extracts the cheapest equal expression.
+ *
+ * @param expression The expression to simplify.
+ * @param opts The rewrites, cost function and limits.
+ * @return The simplified expression.
+ */
+auto SimplifyWithEGraph(const Expression& expression, const EGraphOpts& opts = {}) -> EGraphResult;
+
+} // Oasis
+
+#endif // OASIS_EGRAPH_HPP
@@ -0,0 +1,83 @@
+#ifndef OASIS_EVALUATEBATCH_HPP
+#define OASIS_EVALUATEBATCH_HPP
+
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <span>
+#include <string>
+
+#include "CompiledExpression.hpp"
+#include "ThreadPool.hpp"
+
+namespace Oasis {
+
+/**
+ * The number of points EvaluateBatch runs each instruction over at once.
+ */
+constexpr std::size_t BatchBlockSize = 256;
+
+/**
+ * Evaluates a compiled expression at many points.
+ *
+ * Points are evaluated in blocks of BatchBlockSize, running each instruction over a whole block
+ * before the next, so that instructions are decoded once per block and arithmetic runs in tight
+ * loops over contiguous values. Those loops are built for AVX-512, AVX2 and baseline x86-64 where
+ * the compiler supports it, and the best version for the processor is picked when the program
+ * starts. Results match CompiledExpression::Evaluate up to rounding.
+ *
+ * @param compiled The expression to evaluate.
+ * @param values The values of each variable, in the order the expression was compiled with. The
+ * values of every variable at the i-th point are at index i of their span.
+ * @param results The span to write the value at each point to.
+ * @param threadPool A pool to evaluate blocks on concurrently, or nullptr to evaluate them on the
+ * calling thread.
+ * @return Nothing, or an error if there are not as many spans of values as variables, or fewer
+ * values in a span than results.
+ */
+auto EvaluateBatch(const CompiledExpression& compiled, std::span<const std::span<const double>> values, std::span<double> results, const std::shared_ptr<ThreadPool>& threadPool = nullptr) -> std::expected<void, std::string>;
+
+/**
+ * The values of a variable along one axis of a grid, evenly spaced from first to last.
+ */
+struct GridAxis {
+    /**
+     * The first value of the variable.
+     */
+    double first = 0.0;
+
+    /**
+     * The last value of the variable.
+     */
+    double last = 0.0;
+
+    /**
+     * The number of values of the variable.
+     */
+    std::size_t count = 1;
+};
+
+/**
+ * Evaluates a compiled expression at every point of a grid.
+ *
+ * The grid is the tensor product of an axis per variable. Points are visited one row at a time,
+ * where a row holds the points that differ only in the last variable. The stages of the
+ * expression that do not depend on the last variable are evaluated once per row, and only the
+ * stages of variables whose values changed since the previous row are rerun. The last stage is
+ * evaluated over the row in blocks, as by EvaluateBatch. Rows are divided into tiles of a few
+ * thousand points that are evaluated concurrently.
+ *
+ * @param compiled The expression to evaluate.
+ * @param axes The axis of each variable, in the order the expression was compiled with.
+ * @param results The span to write the value at each point to, in row-major order, so that the
+ * last variable changes fastest. Nothing else is allocated per point.
+ * @param threadPool A pool to evaluate tiles on concurrently, or nullptr to evaluate them on the
+ * calling thread.
+ * @return Nothing, or an error if there is not an axis for every variable, or results does not
+ * hold exactly one value per point.
+ */
+auto EvaluateGrid(const CompiledExpression& compiled, std::span<const GridAxis> axes, std::span<double> results, const std::shared_ptr<ThreadPool>& threadPool = nullptr) -> std::expected<void, std::string>;
+
+} // Oasis
+
+#endif // OASIS_EVALUATEBATCH_HPP
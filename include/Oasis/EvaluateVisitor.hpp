@@ -0,0 +1,130 @@
+#ifndef OASIS_EVALUATEVISITOR_HPP
+#define OASIS_EVALUATEVISITOR_HPP
+
+#include <complex>
+#include <cstddef>
+#include <expected>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "SymbolTable.hpp"
+#include "Visit.hpp"
+
+namespace Oasis {
+
+/**
+ * Values bound to variables for numeric evaluation.
+ *
+ * Values are stored densely by the SymbolId of their variable, so looking up a variable while
+ * evaluating is a single array access.
+ */
+class VariableBindings {
+public:
+    /**
+     * Binds a value to a variable, replacing any value bound to it before.
+     * @param symbol The symbol of the variable.
+     * @param value The value of the variable.
+     * @return This object, so that bindings may be chained.
+     */
+    auto Bind(SymbolId symbol, std::complex<double> value) -> VariableBindings&;
+
+    /**
+     * Binds a value to a variable, replacing any value bound to it before.
+     * @param name The name of the variable.
+     * @param value The value of the variable.
+     * @return This object, so that bindings may be chained.
+     */
+    auto Bind(std::string_view name, std::complex<double> value) -> VariableBindings&;
+
+    /**
+     * Gets the value bound to a variable.
+     * @param symbol The symbol of the variable.
+     * @return The value, or nullptr if the variable is not bound.
+     */
+    [[nodiscard]] auto Find(SymbolId symbol) const -> const std::complex<double>*;
+
+    /**
+     * Gets whether every bound value is a real number.
+     * @return Whether no bound value has an imaginary part.
+     */
+    [[nodiscard]] auto IsReal() const -> bool;
+
+private:
+    std::vector<std::optional<std::complex<double>>> values;
+    std::size_t complexValues = 0;
+};
+
+/**
+ * Evaluates an expression numerically, given values for its variables.
+ *
+ * The expression is evaluated with doubles in a single traversal that allocates nothing, unless
+ * it involves the imaginary unit, a complex value of a variable, the logarithm of a negative
+ * number or a non-integer power of a negative number. It is then evaluated again with
+ * std::complex<double>. Angles are in radians. Undefined evaluates to NaN, while matrices,
+ * derivatives and integrals cannot be evaluated.
+ */
+class EvaluateVisitor final : public TypedVisitor<std::expected<std::complex<double>, std::string>> {
+public:
+    /**
+     * Creates a visitor.
+     * @param bindings The values of the variables of the expressions to evaluate.
+     */
+    explicit EvaluateVisitor(VariableBindings bindings = {});
+
+    auto TypedVisit(const Real& real) -> RetT override;
+    auto TypedVisit(const Imaginary& imaginary) -> RetT override;
+    auto TypedVisit(const Variable& variable) -> RetT override;
+    auto TypedVisit(const Undefined& undefined) -> RetT override;
+    auto TypedVisit(const Add<Expression, Expression>& add) -> RetT override;
+    auto TypedVisit(const Subtract<Expression, Expression>& subtract) -> RetT override;
+    auto TypedVisit(const Multiply<Expression, Expression>& multiply) -> RetT override;
+    auto TypedVisit(const Divide<Expression, Expression>& divide) -> RetT override;
+    auto TypedVisit(const Exponent<Expression, Expression>& exponent) -> RetT override;
+    auto TypedVisit(const Log<Expression, Expression>& log) -> RetT override;
+    auto TypedVisit(const Negate<Expression>& negate) -> RetT override;
+    auto TypedVisit(const Sine<Expression>& sine) -> RetT override;
+    auto TypedVisit(const Derivative<Expression, Expression>& derivative) -> RetT override;
+    auto TypedVisit(const Integral<Expression, Expression>& integral) -> RetT override;
+    auto TypedVisit(const Matrix& matrix) -> RetT override;
+    auto TypedVisit(const EulerNumber& e) -> RetT override;
+    auto TypedVisit(const Pi& pi) -> RetT override;
+    auto TypedVisit(const Magnitude<Expression>& magnitude) -> RetT override;
+
+    /**
+     * Gets the values of variables, which may be changed between evaluations.
+     * @return The bindings of this visitor.
+     */
+    auto GetBindings() -> VariableBindings&;
+
+    /**
+     * Gets the values of variables.
+     * @return The bindings of this visitor.
+     */
+    [[nodiscard]] auto GetBindings() const -> const VariableBindings&;
+
+private:
+    auto Evaluate(const Expression& expression) -> RetT;
+
+    template <typename T>
+    auto EvaluateAs(const Expression& expression) -> std::optional<T>;
+
+    VariableBindings bindings;
+
+    // Set by EvaluateAs when it fails, so that failing is the only path that allocates.
+    std::string error;
+    bool needsComplex = false;
+};
+
+/**
+ * Evaluates an expression to a real number.
+ * @param expression The expression to evaluate.
+ * @param bindings The values of the variables of the expression.
+ * @return The value of the expression, or an error if it cannot be evaluated or is not real.
+ */
+auto Evaluate(const Expression& expression, const VariableBindings& bindings = {}) -> std::expected<double, std::string>;
+
+} // Oasis
+
+#endif // OASIS_EVALUATEVISITOR_HPP
@@ -18,6 +18,7 @@ public:
     Exponent(const Exponent<Expression, Expression>& other) = default;
 
     Exponent(const Expression& base, const Expression& power);
+    Exponent(std::unique_ptr<Expression>&& base, std::unique_ptr<Expression>&& power);
 
     [[nodiscard]] auto Integrate(const Expression& integrationVariable) const -> std::unique_ptr<Expression> final;
 
@@ -92,6 +93,11 @@ public:
     {
     }
 
+    Exponent(std::unique_ptr<BaseT>&& base, std::unique_ptr<PowerT>&& power)
+        : BinaryExpression<Exponent, BaseT, PowerT>(std::move(base), std::move(power))
+    {
+    }
+
     auto operator=(const Exponent& other) -> Exponent& = default;
 
     EXPRESSION_TYPE(Exponent)
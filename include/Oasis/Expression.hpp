@@ -1,8 +1,11 @@
 #ifndef OASIS_EXPRESSION_HPP
 #define OASIS_EXPRESSION_HPP
 
+#include <atomic>
 #include <cstdint>
 #include <expected>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -42,6 +45,11 @@ enum class ExpressionType {
     Sine
 };
 
+/**
+ * The number of expression types. Must be updated whenever a type is added to ExpressionType.
+ */
+constexpr std::size_t ExpressionTypeCount = static_cast<std::size_t>(ExpressionType::Sine) + 1;
+
 /**
  * The category of an expression.
  */
@@ -62,6 +70,9 @@ enum ExpressionCategory : uint32_t {
  */
 class Expression {
 public:
+    Expression() = default;
+    Expression(const Expression& other);
+
     /**
      * Copies this expression.
      * @return A copy of this expression.
@@ -100,6 +111,35 @@ public:
      */
     [[nodiscard]] virtual auto GetCategory() const -> uint32_t;
 
+    /**
+     * Gets the structural hash of this expression.
+     *
+     * The hash is computed on first use and cached on the node. Expressions that are Equals
+     * always have the same hash, so a mismatch proves inequality without visiting any operands.
+     * Operands of associative expressions, such as Add and Multiply, are combined without regard
+     * to order or grouping.
+     *
+     * @return The hash of this expression.
+     */
+    [[nodiscard]] auto GetHash() const -> std::uint64_t;
+
+    /**
+     * Gets an operand of this expression without copying or generalizing it.
+     *
+     * For binary expressions, index 0 is the most significant operand and index 1 is the least
+     * significant operand. Unary expressions have a single operand at index 0.
+     *
+     * @param index The index of the operand.
+     * @return The operand, or nullptr if this expression has no operand at that index.
+     */
+    [[nodiscard]] virtual auto GetOperandAt(std::size_t index) const -> const Expression*;
+
+    /**
+     * Gets the number of operands of this expression.
+     * @return The number of operands, which is zero for leaf expressions.
+     */
+    [[nodiscard]] virtual auto GetOperandCount() const -> std::size_t;
+
     /**
      * Gets the type of this expression.
      * @return The type of this expression.
@@ -193,13 +233,133 @@ public:
 
     virtual ~Expression() = default;
 
+    /**
+     * Allocates an expression node, from the current ExpressionArena if there is one.
+     * @param size The size of the node.
+     */
+    static auto operator new(std::size_t size) -> void*;
+
+    /**
+     * Frees an expression node allocated with operator new.
+     * @param ptr The node to free.
+     */
+    static auto operator delete(void* ptr) noexcept -> void;
+
+    auto operator=(const Expression& other) -> Expression&;
+
 protected:
+    /**
+     * Computes the structural hash of this expression.
+     *
+     * Leaf expressions hash their type along with their value, if any. Expressions with operands
+     * combine their type with the hashes of their operands.
+     *
+     * @return The hash of this expression.
+     */
+    [[nodiscard]] virtual auto ComputeHash() const -> std::uint64_t;
+
+    /**
+     * Discards the cached hash of this expression. Must be called whenever an operand is replaced.
+     */
+    auto InvalidateHash() -> void;
+
     /**
      * This function serializes the expression object.
      *
      * @param visitor The serializer class object to write the Expression data.
      */
     virtual any AcceptInternal(Visitor& visitor) const = 0;
+
+private:
+    /**
+     * The cached hash of this expression, or zero if it has not been computed yet.
+     */
+    mutable std::atomic<std::uint64_t> hash = 0;
+};
+
+/**
+ * Scrambles the bits of a hash.
+ * @param value The hash to scramble.
+ * @return The scrambled hash.
+ */
+constexpr auto MixHash(std::uint64_t value) -> std::uint64_t
+{
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+/**
+ * Combines a hash into a seed, where the order of combination matters.
+ * @param seed The seed.
+ * @param value The hash to combine into the seed.
+ * @return The combined hash.
+ */
+constexpr auto CombineHash(std::uint64_t seed, std::uint64_t value) -> std::uint64_t
+{
+    return MixHash(seed + 0x9e3779b97f4a7c15ULL + MixHash(value));
+}
+
+/**
+ * Counts the nodes of an expression, stopping once a limit is reached, so that finding whether an
+ * expression is larger than some size takes time proportional to that size.
+ * @param expression The expression to count the nodes of.
+ * @param limit The count at which to stop.
+ * @return The number of nodes, or the limit if the expression has at least as many.
+ */
+auto CountNodes(const Expression& expression, std::size_t limit = std::numeric_limits<std::size_t>::max()) -> std::size_t;
+
+/**
+ * A hash function for expressions, suitable for unordered containers.
+ *
+ * Accepts expressions by reference or through smart pointers, so containers keyed on owning
+ * pointers can be searched with a plain reference.
+ */
+struct ExpressionHash {
+    using is_transparent = void;
+
+    auto operator()(const Expression& expression) const -> std::size_t
+    {
+        return expression.GetHash();
+    }
+
+    template <typename PtrT>
+        requires std::is_convertible_v<decltype(*std::declval<const PtrT&>()), const Expression&>
+    auto operator()(const PtrT& expression) const -> std::size_t
+    {
+        return (*this)(static_cast<const Expression&>(*expression));
+    }
+};
+
+/**
+ * An equality predicate for expressions, suitable for unordered containers.
+ *
+ * @see ExpressionHash
+ */
+struct ExpressionEqual {
+    using is_transparent = void;
+
+    template <typename LhsT, typename RhsT>
+    auto operator()(const LhsT& lhs, const RhsT& rhs) const -> bool
+    {
+        return Deref(lhs).Equals(Deref(rhs));
+    }
+
+private:
+    static auto Deref(const Expression& expression) -> const Expression&
+    {
+        return expression;
+    }
+
+    template <typename PtrT>
+        requires std::is_convertible_v<decltype(*std::declval<const PtrT&>()), const Expression&>
+    static auto Deref(const PtrT& expression) -> const Expression&
+    {
+        return *expression;
+    }
 };
 
 template <IVisitor T>
@@ -223,15 +383,15 @@ auto Expression::Accept(T& visitor) const -> typename T::RetT
     }
 }
 
-#define EXPRESSION_TYPE(type)                       \
-    auto GetType() const -> ExpressionType override \
-    {                                               \
-        return ExpressionType::type;                \
-    }                                               \
-                                                    \
-    static auto GetStaticType() -> ExpressionType   \
-    {                                               \
-        return ExpressionType::type;                \
+#define EXPRESSION_TYPE(type)                               \
+    auto GetType() const -> ExpressionType override         \
+    {                                                       \
+        return ExpressionType::type;                        \
+    }                                                       \
+                                                            \
+    constexpr static auto GetStaticType() -> ExpressionType \
+    {                                                       \
+        return ExpressionType::type;                        \
     }
 
 #define EXPRESSION_CATEGORY(category)                     \
@@ -247,6 +407,14 @@ auto Expression::Accept(T& visitor) const -> typename T::RetT
 
 } // namespace Oasis
 
+template <>
+struct std::hash<Oasis::Expression> {
+    auto operator()(const Oasis::Expression& expression) const -> std::size_t
+    {
+        return expression.GetHash();
+    }
+};
+
 std::unique_ptr<Oasis::Expression> operator+(const std::unique_ptr<Oasis::Expression>& lhs, const std::unique_ptr<Oasis::Expression>& rhs);
 std::unique_ptr<Oasis::Expression> operator-(const std::unique_ptr<Oasis::Expression>& lhs, const std::unique_ptr<Oasis::Expression>& rhs);
 std::unique_ptr<Oasis::Expression> operator*(const std::unique_ptr<Oasis::Expression>& lhs, const std::unique_ptr<Oasis::Expression>& rhs);
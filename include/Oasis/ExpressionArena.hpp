@@ -0,0 +1,179 @@
+#ifndef OASIS_EXPRESSIONARENA_HPP
+#define OASIS_EXPRESSIONARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+#include "Expression.hpp"
+
+namespace Oasis {
+
+/**
+ * A scoped arena for expression nodes.
+ *
+ * While an arena is alive, every expression node allocated on the thread that created it,
+ * together with the reference counts of shared operands, is bump-allocated from the arena instead
+ * of the global heap. Freeing such a node only runs its destructor; the memory itself is
+ * released all at once when the arena is destroyed. This makes arenas a good fit for a single
+ * simplify or differentiate call, which creates and discards many short-lived nodes.
+ *
+ * Nodes allocated from an arena must not outlive it. Use Relocate to move the final result of a
+ * computation onto the heap before the arena goes out of scope. Likewise, caches such as an
+ * ExpressionStore must not retain arena nodes past the lifetime of the arena.
+ *
+ * Arenas nest: creating an arena while another is active on the same thread suspends the outer
+ * one until the inner arena is destroyed.
+ *
+ * @section ex1 Example Usage:
+ * @code
+ * std::unique_ptr<Oasis::Expression> result;
+ * {
+ *     Oasis::ExpressionArena arena;
+ *     auto simplified = expression.Accept(simplifyVisitor).value();
+ *     result = arena.Relocate(*simplified);
+ * }
+ * @endcode
+ */
+class ExpressionArena {
+public:
+    /**
+     * Creates an arena backed by the default memory resource and makes it current.
+     */
+    ExpressionArena();
+
+    /**
+     * Creates an arena and makes it current.
+     * @param upstream The memory resource the arena requests blocks of memory from.
+     * @param initialSize The size of the first block requested from upstream, in bytes.
+     */
+    explicit ExpressionArena(std::pmr::memory_resource* upstream, std::size_t initialSize = 64 * 1024);
+
+    ExpressionArena(const ExpressionArena& other) = delete;
+    ExpressionArena(ExpressionArena&& other) = delete;
+
+    /**
+     * Gets the arena expression nodes are currently allocated from on this thread.
+     * @return The current arena, or nullptr if nodes are allocated from the heap.
+     */
+    [[nodiscard]] static auto Current() -> ExpressionArena*;
+
+    /**
+     * Gets the number of bytes allocated from this arena so far.
+     * @return The number of bytes allocated, including bookkeeping.
+     */
+    [[nodiscard]] auto BytesAllocated() const -> std::size_t;
+
+    /**
+     * Gets the memory resource backing this arena.
+     * @return The memory resource.
+     */
+    [[nodiscard]] auto GetResource() -> std::pmr::memory_resource*;
+
+    /**
+     * Deep-copies an expression onto the heap so it may outlive this arena. Operands shared
+     * within the expression remain shared in the copy.
+     *
+     * @param expression The expression to relocate.
+     * @return A copy of the expression that does not reference memory owned by any arena.
+     */
+    [[nodiscard]] auto Relocate(const Expression& expression) const -> std::unique_ptr<Expression>;
+
+    auto operator=(const ExpressionArena& other) -> ExpressionArena& = delete;
+    auto operator=(ExpressionArena&& other) -> ExpressionArena& = delete;
+
+    ~ExpressionArena();
+
+private:
+    friend auto AllocateExpressionMemory(std::size_t size) -> void*;
+
+    std::pmr::monotonic_buffer_resource resource;
+    ExpressionArena* previous = nullptr;
+    std::size_t bytesAllocated = 0;
+};
+
+/**
+ * Suspends the current arena on this thread for as long as it is alive, so that expression nodes
+ * are allocated from the heap, then restores it when destroyed.
+ */
+class ArenaSuspension {
+public:
+    ArenaSuspension();
+
+    ArenaSuspension(const ArenaSuspension& other) = delete;
+    auto operator=(const ArenaSuspension& other) -> ArenaSuspension& = delete;
+
+    ~ArenaSuspension();
+
+private:
+    ExpressionArena* suspended;
+};
+
+/**
+ * Allocates memory for an expression node from the current arena, or from the heap if there is
+ * none.
+ * @param size The number of bytes to allocate.
+ * @return The allocated memory, aligned for any expression.
+ */
+auto AllocateExpressionMemory(std::size_t size) -> void*;
+
+/**
+ * Frees memory returned by AllocateExpressionMemory. Memory that came from an arena is reclaimed
+ * when the arena is destroyed, so only heap memory is actually freed.
+ * @param ptr The memory to free.
+ */
+auto DeallocateExpressionMemory(void* ptr) noexcept -> void;
+
+/**
+ * An allocator for the control blocks of shared operands, following the same placement rules as
+ * expression nodes.
+ * @tparam T The type to allocate.
+ */
+template <typename T>
+struct ExpressionAllocator {
+    using value_type = T;
+
+    ExpressionAllocator() = default;
+
+    template <typename U>
+    ExpressionAllocator(const ExpressionAllocator<U>&) noexcept
+    {
+    }
+
+    auto allocate(std::size_t n) -> T*
+    {
+        return static_cast<T*>(AllocateExpressionMemory(n * sizeof(T)));
+    }
+
+    auto deallocate(T* ptr, std::size_t) noexcept -> void
+    {
+        DeallocateExpressionMemory(ptr);
+    }
+
+    template <typename U>
+    auto operator==(const ExpressionAllocator<U>&) const noexcept -> bool
+    {
+        return true;
+    }
+};
+
+/**
+ * Converts an owned operand into a shared one, allocating its reference count alongside
+ * expression nodes.
+ * @tparam T The type of the operand.
+ * @param op The operand.
+ * @return The shared operand.
+ */
+template <typename T>
+auto ShareOperand(std::unique_ptr<T> op) -> std::shared_ptr<const T>
+{
+    if (!op) {
+        return nullptr;
+    }
+
+    return std::shared_ptr<const T>(op.release(), std::default_delete<T> {}, ExpressionAllocator<T> {});
+}
+
+} // Oasis
+
+#endif // OASIS_EXPRESSIONARENA_HPP
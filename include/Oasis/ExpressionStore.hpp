@@ -0,0 +1,102 @@
+#ifndef OASIS_EXPRESSIONSTORE_HPP
+#define OASIS_EXPRESSIONSTORE_HPP
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Expression.hpp"
+#include "SymbolTable.hpp"
+
+namespace Oasis {
+
+/**
+ * A store of hash-consed expressions.
+ *
+ * Interning an expression rebuilds it bottom-up so that every structurally identical subtree is
+ * represented by exactly one node, shared by reference count. Expressions returned by the same
+ * store can therefore be compared by address, and copying them is O(1), since operands are never
+ * duplicated.
+ *
+ * The store holds a reference to every node it has interned until it is cleared or destroyed.
+ * It is not thread-safe.
+ *
+ * @section ex1 Example Usage:
+ * @code
+ * Oasis::ExpressionStore store;
+ * auto square = Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 2.0 } };
+ * auto first = store.Intern(Oasis::Add { square, Oasis::Real { 1.0 } });
+ * auto second = store.Intern(Oasis::Multiply { square, Oasis::Real { 3.0 } });
+ * // Both expressions now share the same x^2 node.
+ * @endcode
+ */
+class ExpressionStore {
+public:
+    ExpressionStore() = default;
+    ExpressionStore(const ExpressionStore& other) = delete;
+    ExpressionStore(ExpressionStore&& other) noexcept = default;
+
+    /**
+     * Interns an expression.
+     *
+     * @param expression The expression to intern.
+     * @return The canonical node for the expression. Structurally identical expressions interned
+     * by this store always yield the same node.
+     */
+    [[nodiscard]] auto Intern(const Expression& expression) -> std::shared_ptr<const Expression>;
+
+    /**
+     * Checks whether an expression is a node owned by this store.
+     *
+     * @param expression The expression to check.
+     * @return Whether the expression was returned by Intern, or is a subtree of such an expression.
+     */
+    [[nodiscard]] auto Contains(const Expression& expression) const -> bool;
+
+    /**
+     * Gets the number of unique nodes in this store.
+     *
+     * @return The number of unique nodes.
+     */
+    [[nodiscard]] auto Size() const -> std::size_t;
+
+    /**
+     * Releases every node held by this store. Expressions previously returned by Intern remain
+     * valid, but are no longer shared with expressions interned afterward.
+     */
+    auto Clear() -> void;
+
+    auto operator=(const ExpressionStore& other) -> ExpressionStore& = delete;
+    auto operator=(ExpressionStore&& other) noexcept -> ExpressionStore& = default;
+
+private:
+    class Interner;
+
+    /**
+     * Identifies a node by its type, its own payload, and the addresses of its already interned
+     * operands, so that a lookup never has to compare whole subtrees.
+     */
+    struct NodeKey {
+        ExpressionType type = ExpressionType::None;
+        std::vector<double> values {};
+        SymbolId symbol = 0;
+        const Expression* mostSigOp = nullptr;
+        const Expression* leastSigOp = nullptr;
+
+        auto operator==(const NodeKey& other) const -> bool = default;
+    };
+
+    struct NodeKeyHash {
+        auto operator()(const NodeKey& key) const -> std::size_t;
+    };
+
+    auto Find(const NodeKey& key) const -> std::shared_ptr<const Expression>;
+    auto Insert(NodeKey key, std::shared_ptr<const Expression> node) -> std::shared_ptr<const Expression>;
+
+    std::unordered_map<NodeKey, const Expression*, NodeKeyHash> nodesByKey;
+    std::unordered_map<const Expression*, std::shared_ptr<const Expression>> nodes;
+};
+
+} // Oasis
+
+#endif // OASIS_EXPRESSIONSTORE_HPP
@@ -21,6 +21,7 @@ public:
     Integral(const Integral<Expression, Expression>& other) = default;
 
     Integral(const Expression& integrand, const Expression& differential);
+    Integral(std::unique_ptr<Expression>&& integrand, std::unique_ptr<Expression>&& differential);
     auto operator=(const Integral& integral) const -> Integral<Expression, Expression>;
 
     [[nodiscard]] auto IntegrateWithBounds(const Expression& lower, const Expression& upper) const -> std::unique_ptr<Expression>;
@@ -72,6 +73,11 @@ public:
     {
     }
 
+    Integral(std::unique_ptr<IntegrandT>&& integrand, std::unique_ptr<DifferentialT>&& differential)
+        : BinaryExpression<Integral, IntegrandT, DifferentialT>(std::move(integrand), std::move(differential))
+    {
+    }
+
     auto operator=(const Integral& other) -> Integral& = default;
 
     EXPRESSION_TYPE(Integral)
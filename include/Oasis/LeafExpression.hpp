@@ -5,6 +5,8 @@
 #ifndef OASIS_LEAFEXPRESSION_HPP
 #define OASIS_LEAFEXPRESSION_HPP
 
+#include <cassert>
+
 #include "Expression.hpp"
 #include "Visit.hpp"
 
@@ -42,9 +44,8 @@ public:
 
     auto AcceptInternal(Visitor& visitor) const -> any override
     {
-        const auto generalized = Generalize();
-        const auto& derivedGeneralized = dynamic_cast<const DerivedT&>(*generalized);
-        return visitor.Visit(derivedGeneralized);
+        assert(this->GetType() == DerivedT::GetStaticType());
+        return visitor.Visit(*static_cast<const DerivedT*>(this));
     }
 };
 
@@ -18,6 +18,7 @@ public:
     Log(const Log<Expression, Expression>& other) = default;
 
     Log(const Expression& base, const Expression& argument);
+    Log(std::unique_ptr<Expression>&& base, std::unique_ptr<Expression>&& argument);
 
     [[nodiscard]] auto Integrate(const Expression& integrationVariable) const -> std::unique_ptr<Expression> final;
 
@@ -44,6 +45,11 @@ public:
     Log(const BaseT& base, const ArgumentT& argument)
         : BinaryExpression<Log, BaseT, ArgumentT>(base, argument) { }
 
+    Log(std::unique_ptr<BaseT>&& base, std::unique_ptr<ArgumentT>&& argument)
+        : BinaryExpression<Log, BaseT, ArgumentT>(std::move(base), std::move(argument))
+    {
+    }
+
         ;
 
     auto operator=(const Log& other) -> Log& = default;
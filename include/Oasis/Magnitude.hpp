@@ -39,6 +39,11 @@ public:
     {
     }
 
+    explicit Magnitude(std::unique_ptr<OperandT>&& operand)
+        : UnaryExpression<Magnitude, OperandT>(std::move(operand))
+    {
+    }
+
     [[nodiscard]] auto Integrate(const Expression& integrationVar) const -> std::unique_ptr<Expression> override
     {
         // TODO: Implement
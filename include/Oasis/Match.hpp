@@ -0,0 +1,264 @@
+#ifndef OASIS_MATCH_HPP
+#define OASIS_MATCH_HPP
+
+#include <optional>
+
+#include "Expression.hpp"
+
+namespace Oasis {
+
+/**
+ * Checks whether a pattern has operands that are matched recursively.
+ *
+ * @tparam T The pattern to check.
+ */
+template <typename T>
+concept CompositePattern = DerivedFromBinaryExpression<T> || DerivedFromUnaryExpression<T>;
+
+template <IExpression T>
+class MatchView;
+
+/**
+ * Matches an expression against a pattern without copying it.
+ *
+ * This is the non-owning counterpart of RecursiveCast. Where RecursiveCast builds a specialized
+ * copy of the matched tree, Match returns a view of references into the original tree and never
+ * allocates. The view is only valid for as long as the matched expression is.
+ *
+ * Like RecursiveCast, operands of commutative expressions are matched in either order.
+ *
+ * @section ex1 Example Usage:
+ * @code
+ * if (auto likeTerms = Oasis::Match<Oasis::Add<Oasis::Multiply<Oasis::Real, Oasis::Expression>>>(expression)) {
+ *     const Oasis::Real& coefficient = likeTerms->GetMostSigOp().GetMostSigOp();
+ *     const Oasis::Expression& term = likeTerms->GetMostSigOp().GetLeastSigOp();
+ * }
+ * @endcode
+ *
+ * @tparam T The pattern to match, e.g. `Add<Real, Expression>`.
+ * @param expression The expression to match.
+ * @return A view of the matched expression, or std::nullopt if it does not match the pattern.
+ */
+template <IExpression T>
+auto Match(const Expression& expression) -> std::optional<MatchView<T>>
+{
+    return MatchView<T>::TryMatch(expression);
+}
+
+/**
+ * A view of an expression matched by a leaf pattern, such as `Real` or `Expression`.
+ *
+ * @tparam T The pattern that was matched.
+ */
+template <IExpression T>
+class MatchView {
+public:
+    explicit MatchView(const T& expression)
+        : expression(&expression)
+    {
+    }
+
+    /**
+     * Gets the matched expression.
+     * @return The matched expression.
+     */
+    [[nodiscard]] auto Get() const -> const T&
+    {
+        return *expression;
+    }
+
+    /**
+     * Gets the matched expression.
+     * @return The matched expression.
+     */
+    [[nodiscard]] auto GetExpression() const -> const Expression&
+    {
+        return *expression;
+    }
+
+    static auto TryMatch(const Expression& other) -> std::optional<MatchView>
+    {
+        if constexpr (std::same_as<T, Expression>) {
+            return MatchView { other };
+        } else {
+            if (!other.Is<T>()) {
+                return std::nullopt;
+            }
+
+            return MatchView { static_cast<const T&>(other) };
+        }
+    }
+
+private:
+    const T* expression;
+};
+
+/**
+ * Unwraps a view of an operand, so that operands matched by leaf patterns are accessed directly.
+ *
+ * @param view The view of the operand.
+ * @return The operand itself if it was matched by a leaf pattern, otherwise the view.
+ */
+template <IExpression T>
+auto UnwrapMatchView(const MatchView<T>& view) -> decltype(auto)
+{
+    if constexpr (CompositePattern<T>) {
+        return (view);
+    } else {
+        return view.Get();
+    }
+}
+
+/**
+ * A view of an expression matched by a binary pattern, such as `Add<Real, Expression>`.
+ *
+ * @tparam DerivedT The type of the binary expression.
+ * @tparam MostSigOpT The pattern the most significant operand matched.
+ * @tparam LeastSigOpT The pattern the least significant operand matched.
+ */
+template <template <typename, typename> typename DerivedT, typename MostSigOpT, typename LeastSigOpT>
+    requires DerivedFromBinaryExpression<DerivedT<MostSigOpT, LeastSigOpT>>
+class MatchView<DerivedT<MostSigOpT, LeastSigOpT>> {
+public:
+    MatchView(const Expression& expression, MatchView<MostSigOpT> mostSigOp, MatchView<LeastSigOpT> leastSigOp)
+        : expression(&expression)
+        , mostSigOp(mostSigOp)
+        , leastSigOp(leastSigOp)
+    {
+    }
+
+    /**
+     * Gets the matched expression.
+     * @return The matched expression.
+     */
+    [[nodiscard]] auto GetExpression() const -> const Expression&
+    {
+        return *expression;
+    }
+
+    /**
+     * Gets the operand that matched the most significant operand of the pattern. For commutative
+     * expressions, this may be the least significant operand of the matched expression.
+     * @return The operand if it matched a leaf pattern, otherwise a view of it.
+     */
+    [[nodiscard]] auto GetMostSigOp() const -> decltype(auto)
+    {
+        return UnwrapMatchView(mostSigOp);
+    }
+
+    /**
+     * Gets the operand that matched the least significant operand of the pattern. For commutative
+     * expressions, this may be the most significant operand of the matched expression.
+     * @return The operand if it matched a leaf pattern, otherwise a view of it.
+     */
+    [[nodiscard]] auto GetLeastSigOp() const -> decltype(auto)
+    {
+        return UnwrapMatchView(leastSigOp);
+    }
+
+    static auto TryMatch(const Expression& other) -> std::optional<MatchView>
+    {
+        if (!other.Is<DerivedT>()) {
+            return std::nullopt;
+        }
+
+        const Expression* otherMostSigOp = other.GetOperandAt(0);
+        const Expression* otherLeastSigOp = other.GetOperandAt(1);
+
+        if (otherMostSigOp == nullptr || otherLeastSigOp == nullptr) {
+            return std::nullopt;
+        }
+
+        if (auto view = TryMatchOperands(other, *otherMostSigOp, *otherLeastSigOp)) {
+            return view;
+        }
+
+        if (!(other.GetCategory() & Commutative)) {
+            return std::nullopt;
+        }
+
+        return TryMatchOperands(other, *otherLeastSigOp, *otherMostSigOp);
+    }
+
+private:
+    static auto TryMatchOperands(const Expression& other, const Expression& otherMostSigOp, const Expression& otherLeastSigOp) -> std::optional<MatchView>
+    {
+        auto mostSigOpView = Match<MostSigOpT>(otherMostSigOp);
+        if (!mostSigOpView) {
+            return std::nullopt;
+        }
+
+        auto leastSigOpView = Match<LeastSigOpT>(otherLeastSigOp);
+        if (!leastSigOpView) {
+            return std::nullopt;
+        }
+
+        return MatchView { other, *mostSigOpView, *leastSigOpView };
+    }
+
+    const Expression* expression;
+    MatchView<MostSigOpT> mostSigOp;
+    MatchView<LeastSigOpT> leastSigOp;
+};
+
+/**
+ * A view of an expression matched by a unary pattern, such as `Negate<Real>`.
+ *
+ * @tparam DerivedT The type of the unary expression.
+ * @tparam OperandT The pattern the operand matched.
+ */
+template <template <typename> typename DerivedT, typename OperandT>
+    requires DerivedFromUnaryExpression<DerivedT<OperandT>>
+class MatchView<DerivedT<OperandT>> {
+public:
+    MatchView(const Expression& expression, MatchView<OperandT> operand)
+        : expression(&expression)
+        , operand(operand)
+    {
+    }
+
+    /**
+     * Gets the matched expression.
+     * @return The matched expression.
+     */
+    [[nodiscard]] auto GetExpression() const -> const Expression&
+    {
+        return *expression;
+    }
+
+    /**
+     * Gets the operand of the matched expression.
+     * @return The operand if it matched a leaf pattern, otherwise a view of it.
+     */
+    [[nodiscard]] auto GetOperand() const -> decltype(auto)
+    {
+        return UnwrapMatchView(operand);
+    }
+
+    static auto TryMatch(const Expression& other) -> std::optional<MatchView>
+    {
+        if (!other.Is<DerivedT>()) {
+            return std::nullopt;
+        }
+
+        const Expression* otherOperand = other.GetOperandAt(0);
+        if (otherOperand == nullptr) {
+            return std::nullopt;
+        }
+
+        auto operandView = Match<OperandT>(*otherOperand);
+        if (!operandView) {
+            return std::nullopt;
+        }
+
+        return MatchView { other, *operandView };
+    }
+
+private:
+    const Expression* expression;
+    MatchView<OperandT> operand;
+};
+
+} // Oasis
+
+#endif // OASIS_MATCH_HPP
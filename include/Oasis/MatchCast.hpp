@@ -18,15 +18,22 @@
 #define OASIS_MATCHCAST_HPP
 
 #include <boost/callable_traits/args.hpp>
-#include <boost/mpl/for_each.hpp>
+#include <boost/mpl/at.hpp>
 #include <boost/mpl/push_back.hpp>
+#include <boost/mpl/size.hpp>
 #include <boost/mpl/vector.hpp>
 
 #include <gsl-lite/gsl-lite.hpp>
 
+#include <array>
+#include <cassert>
+#include <chrono>
 #include <concepts>
 #include <functional>
 #include <tuple>
+#include <utility>
+
+#include "Expression.hpp"
 
 namespace Oasis {
 template <typename Lambda>
@@ -37,8 +44,161 @@ concept TransformerAcceptsCheckArg = requires(TransformerF f, const lambda_argum
     { f(t, nullptr) } -> std::same_as<std::expected<gsl_lite::not_null<std::unique_ptr<ArgumentT>>, std::string_view>>;
 } && std::predicate<CheckF, const lambda_argument_type<CheckF>&>;
 
+/**
+ * The shape of a MatchCast case: the type of the root of its pattern and the types of the
+ * operands of the root. A type of ExpressionType::None matches any expression.
+ */
+struct MatchCastKey {
+    ExpressionType type = ExpressionType::None;
+    ExpressionType mostSigOpType = ExpressionType::None;
+    ExpressionType leastSigOpType = ExpressionType::None;
+    bool commutative = false;
+};
+
+template <typename T>
+consteval auto GetPatternType() -> ExpressionType
+{
+    if constexpr (std::same_as<T, Expression>) {
+        return ExpressionType::None;
+    } else {
+        return T::GetStaticType();
+    }
+}
+
+template <typename T>
+consteval auto GetMatchCastKey() -> MatchCastKey
+{
+    if constexpr (DerivedFromBinaryExpression<T>) {
+        using MostSigOpT = std::remove_cvref_t<decltype(std::declval<const T&>().GetMostSigOp())>;
+        using LeastSigOpT = std::remove_cvref_t<decltype(std::declval<const T&>().GetLeastSigOp())>;
+        return { T::GetStaticType(), GetPatternType<MostSigOpT>(), GetPatternType<LeastSigOpT>(), (T::GetStaticCategory() & Commutative) != 0 };
+    } else if constexpr (DerivedFromUnaryExpression<T>) {
+        using OperandT = std::remove_cvref_t<decltype(std::declval<const T&>().GetOperand())>;
+        return { T::GetStaticType(), GetPatternType<OperandT>() };
+    } else {
+        return { GetPatternType<T>() };
+    }
+}
+
 template <typename ArgumentT, typename Cases>
 class MatchCastImpl {
+    using ResultT = std::expected<std::unique_ptr<ArgumentT>, std::string_view>;
+
+    static constexpr std::size_t CaseCount = boost::mpl::size<Cases>::value;
+
+    template <std::size_t I>
+    using CaseAt = typename boost::mpl::at_c<Cases, I>::type;
+
+    /**
+     * The indices of the cases whose root may match each expression type, in the order the cases
+     * were added.
+     */
+    struct Buckets {
+        std::array<std::array<std::size_t, CaseCount>, ExpressionTypeCount> cases {};
+        std::array<std::size_t, ExpressionTypeCount> sizes {};
+    };
+
+    static constexpr auto keys = []<std::size_t... I>(std::index_sequence<I...>) {
+        return std::array<MatchCastKey, CaseCount> { GetMatchCastKey<lambda_argument_type<typename CaseAt<I>::first_type>>()... };
+    }(std::make_index_sequence<CaseCount> {});
+
+    static constexpr auto buckets = [] {
+        Buckets result;
+        for (std::size_t type = 0; type < ExpressionTypeCount; ++type) {
+            for (std::size_t i = 0; i < CaseCount; ++i) {
+                if (keys[i].type == ExpressionType::None || static_cast<std::size_t>(keys[i].type) == type) {
+                    result.cases[type][result.sizes[type]++] = i;
+                }
+            }
+        }
+        return result;
+    }();
+
+    static auto OperandHasType(const Expression* operand, ExpressionType type) -> bool
+    {
+        return type == ExpressionType::None || (operand != nullptr && operand->GetType() == type);
+    }
+
+    /**
+     * Checks the operand types of a case against an expression, so that RecursiveCast is only
+     * attempted on cases that may succeed.
+     */
+    static auto MayMatch(const MatchCastKey& key, const Expression& arg) -> bool
+    {
+        if (key.mostSigOpType == ExpressionType::None && key.leastSigOpType == ExpressionType::None) {
+            return true;
+        }
+
+        const Expression* mostSigOp = arg.GetOperandAt(0);
+        const Expression* leastSigOp = arg.GetOperandAt(1);
+
+        if (OperandHasType(mostSigOp, key.mostSigOpType) && OperandHasType(leastSigOp, key.leastSigOpType)) {
+            return true;
+        }
+
+        return key.commutative && OperandHasType(leastSigOp, key.mostSigOpType) && OperandHasType(mostSigOp, key.leastSigOpType);
+    }
+
+    template <std::size_t I, typename VisitorPtrT, typename ObserverT>
+    static auto TryCase(const ArgumentT& arg, VisitorPtrT visitor, ResultT& result, ObserverT& observer) -> void
+    {
+        using Check = typename CaseAt<I>::first_type;
+        using Transformer = typename CaseAt<I>::second_type;
+        using CaseType = lambda_argument_type<Check>;
+
+        const auto transform = [&](const CaseType& castResult) {
+            result = Transformer {}(castResult, visitor).transform([](gsl_lite::not_null<std::unique_ptr<ArgumentT>>&& transformResult) { return std::move(transformResult); });
+        };
+
+        if constexpr (std::same_as<ObserverT, std::nullptr_t>) {
+            if (std::unique_ptr<CaseType> castResult = RecursiveCast<CaseType>(arg); castResult && Check {}(*castResult))
+                transform(*castResult);
+        } else {
+            using Clock = std::chrono::steady_clock;
+
+            const auto matchStart = Clock::now();
+            std::unique_ptr<CaseType> castResult = RecursiveCast<CaseType>(arg);
+            const bool matched = castResult && Check {}(*castResult);
+            const auto matchEnd = Clock::now();
+
+            if (!matched) {
+                observer(I, false, matchEnd - matchStart, std::chrono::nanoseconds {});
+                return;
+            }
+
+            transform(*castResult);
+            observer(I, true, matchEnd - matchStart, Clock::now() - matchEnd);
+        }
+    }
+
+    template <typename VisitorPtrT, typename ObserverT>
+    auto ExecuteImpl(const ArgumentT& arg, VisitorPtrT visitor, ObserverT& observer) const -> ResultT
+    {
+        using CaseFn = auto (*)(const ArgumentT&, VisitorPtrT, ResultT&, ObserverT&) -> void;
+        static constexpr auto cases = []<std::size_t... I>(std::index_sequence<I...>) {
+            return std::array<CaseFn, CaseCount> { &TryCase<I, VisitorPtrT, ObserverT>... };
+        }(std::make_index_sequence<CaseCount> {});
+
+        ResultT result = nullptr;
+
+        const auto type = static_cast<std::size_t>(arg.GetType());
+        assert(type < ExpressionTypeCount);
+
+        for (std::size_t i = 0; i < buckets.sizes[type]; ++i) {
+            const std::size_t index = buckets.cases[type][i];
+            if (!MayMatch(keys[index], arg)) {
+                continue;
+            }
+
+            cases[index](arg, visitor, result, observer);
+            if (!result.has_value() || *result) {
+                break;
+            }
+        }
+
+        return result;
+    }
+
 public:
     template <typename Check, typename Transformer>
         requires TransformerAcceptsCheckArg<Check, Transformer, ArgumentT>
@@ -49,22 +209,42 @@ public:
         return {};
     }
 
+    /**
+     * Applies the first case whose pattern and check match an expression.
+     *
+     * Cases are bucketed at compile time by the type of the root of their pattern, so only the
+     * cases for the type of the expression are considered, and the types of its operands are
+     * compared before any cast is attempted.
+     *
+     * @param arg The expression to match.
+     * @param visitor The visitor passed to the transformer of the matching case.
+     * @return The result of the transformer, nullptr if no case matched, or an error.
+     */
     template <typename VisitorPtrT>
         requires IVisitor<std::remove_pointer_t<VisitorPtrT>> || std::same_as<VisitorPtrT, std::nullptr_t>
-    auto Execute(const ArgumentT& arg, VisitorPtrT visitor) const -> std::expected<std::unique_ptr<ArgumentT>, std::string_view>
+    auto Execute(const ArgumentT& arg, VisitorPtrT visitor) const -> ResultT
     {
-        std::expected<std::unique_ptr<ArgumentT>, std::string_view> result = nullptr;
-        boost::mpl::for_each<Cases>(
-            [&]<typename Check, typename Transformer>(std::pair<Check, Transformer> checkAndTransformer) {
-                using CaseType = lambda_argument_type<Check>;
-                if (!result.has_value() || (result.has_value() && *result))
-                    return;
-
-                auto [check, transformer] = checkAndTransformer;
-                if (std::unique_ptr<CaseType> castResult = RecursiveCast<CaseType>(arg); castResult && check(*castResult))
-                    result = transformer(*castResult, visitor).transform([](gsl_lite::not_null<std::unique_ptr<ArgumentT>>&& transformResult) { return std::move(transformResult); });
-            });
-        return result;
+        std::nullptr_t observer = nullptr;
+        return ExecuteImpl(arg, visitor, observer);
+    }
+
+    /**
+     * Applies the first case whose pattern and check match an expression, and reports every case
+     * that was tried to an observer.
+     *
+     * @param arg The expression to match.
+     * @param visitor The visitor passed to the transformer of the matching case.
+     * @param observer Called for every case whose pattern was matched against the expression with
+     * the index of the case, whether it matched, the time spent matching its pattern and the time
+     * spent in its transformer.
+     * @return The result of the transformer, nullptr if no case matched, or an error.
+     */
+    template <typename VisitorPtrT, typename ObserverT>
+        requires(IVisitor<std::remove_pointer_t<VisitorPtrT>> || std::same_as<VisitorPtrT, std::nullptr_t>)
+        && std::invocable<ObserverT&, std::size_t, bool, std::chrono::nanoseconds, std::chrono::nanoseconds>
+    auto Execute(const ArgumentT& arg, VisitorPtrT visitor, ObserverT&& observer) const -> ResultT
+    {
+        return ExecuteImpl(arg, visitor, observer);
     }
 };
 
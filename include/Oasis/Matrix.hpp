@@ -63,6 +63,9 @@ public:
 
     auto operator=(const Matrix& other) -> Matrix& = default;
 
+protected:
+    [[nodiscard]] auto ComputeHash() const -> std::uint64_t final;
+
 private:
     MatrixXXD matrix {};
 };
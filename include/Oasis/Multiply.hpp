@@ -132,6 +132,11 @@ public:
     {
     }
 
+    Multiply(std::unique_ptr<MultiplicandT>&& addend1, std::unique_ptr<MultiplierT>&& addend2)
+        : BinaryExpression<Multiply, MultiplicandT, MultiplierT>(std::move(addend1), std::move(addend2))
+    {
+    }
+
     auto operator=(const Multiply& other) -> Multiply& = default;
 
     EXPRESSION_TYPE(Multiply)
@@ -24,6 +24,11 @@ public:
     {
     }
 
+    explicit Negate(std::unique_ptr<OperandT>&& operand)
+        : UnaryExpression<Negate, OperandT>(std::move(operand))
+    {
+    }
+
     EXPRESSION_TYPE(Negate)
     EXPRESSION_CATEGORY(UnExp)
 };
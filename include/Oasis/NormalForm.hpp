@@ -0,0 +1,84 @@
+#ifndef OASIS_NORMALFORM_HPP
+#define OASIS_NORMALFORM_HPP
+
+#include <cstddef>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "Expression.hpp"
+#include "SimplifyVisitor.hpp"
+
+namespace Oasis {
+
+/**
+ * Options for SimplifyToNormalForm.
+ */
+struct NormalFormOpts {
+    /**
+     * The options each pass simplifies with.
+     */
+    SimplifyOpts simplifyOpts {};
+
+    /**
+     * The maximum number of simplification passes.
+     */
+    std::size_t maxPasses = 16;
+
+    /**
+     * The maximum number of subexpressions that may be simplified, summed over all passes.
+     * Subexpressions that were already simplified in an earlier pass are not counted again. The
+     * budget is checked between passes, so no pass is started once it is spent.
+     */
+    std::size_t maxSimplifications = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * The capacity of the cache that carries simplified subexpressions from one pass to the next.
+     */
+    std::size_t cacheCapacity = 4096;
+};
+
+/**
+ * The result of SimplifyToNormalForm.
+ */
+struct NormalFormResult {
+    /**
+     * The most simplified form of the expression that was reached.
+     */
+    std::unique_ptr<Expression> expression;
+
+    /**
+     * Whether a fixed point was reached, i.e. whether another pass would not change the result.
+     */
+    bool converged = false;
+
+    /**
+     * The number of simplification passes that were run.
+     */
+    std::size_t passes = 0;
+
+    /**
+     * The number of subexpressions that were simplified, summed over all passes.
+     */
+    std::size_t simplifications = 0;
+};
+
+/**
+ * Simplifies an expression repeatedly until it no longer changes.
+ *
+ * A single SimplifyVisitor pass may leave reducible patterns behind, for example in the sums it
+ * rebuilds. This driver runs passes until one leaves the expression unchanged, or until the
+ * budget in opts runs out. Passes share a SimplifyCache, so only subexpressions that changed in
+ * the previous pass are simplified again.
+ *
+ * @param expression The expression to simplify.
+ * @param opts The simplification options and budget.
+ * @return The simplified expression together with whether it converged, or an error if a pass
+ * failed.
+ */
+auto SimplifyToNormalForm(const Expression& expression, const NormalFormOpts& opts = {}) -> std::expected<NormalFormResult, std::string>;
+
+} // Oasis
+
+#endif // OASIS_NORMALFORM_HPP
@@ -34,6 +34,9 @@ public:
 
     auto operator=(const Real& other) -> Real& = default;
 
+protected:
+    [[nodiscard]] auto ComputeHash() const -> std::uint64_t final;
+
 private:
     double value {};
 };
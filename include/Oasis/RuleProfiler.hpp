@@ -0,0 +1,92 @@
+#ifndef OASIS_RULEPROFILER_HPP
+#define OASIS_RULEPROFILER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Oasis {
+
+/**
+ * The statistics recorded for a simplification rule.
+ */
+struct RuleStats {
+    /**
+     * The name of the rule.
+     */
+    std::string name;
+
+    /**
+     * The number of times the pattern of the rule was matched against an expression.
+     */
+    std::uint64_t attempts = 0;
+
+    /**
+     * The number of times the pattern of the rule matched.
+     */
+    std::uint64_t hits = 0;
+
+    /**
+     * The time spent matching the pattern of the rule, including failed attempts.
+     */
+    std::chrono::nanoseconds matchTime {};
+
+    /**
+     * The time spent transforming expressions that matched the pattern of the rule.
+     */
+    std::chrono::nanoseconds transformTime {};
+};
+
+/**
+ * Records how often each rule of SimplifyVisitor is tried and fires, and where its time goes.
+ *
+ * Profiling must be enabled at compile time by building with OASIS_BUILD_PROFILING, which defines
+ * OASIS_PROFILE_RULES, and at runtime by attaching a profiler with SimplifyVisitor::SetProfiler.
+ * Without the former, SimplifyVisitor records nothing and pays nothing for it.
+ *
+ * A RuleProfiler is not thread safe, and should only be attached to visitors that are used by the
+ * same thread.
+ */
+class RuleProfiler {
+public:
+#ifdef OASIS_PROFILE_RULES
+    static constexpr bool Enabled = true;
+#else
+    static constexpr bool Enabled = false;
+#endif
+
+    /**
+     * Records an attempt to apply a rule.
+     * @param rule The name of the rule.
+     * @param hit Whether the pattern of the rule matched.
+     * @param matchTime The time spent matching the pattern.
+     * @param transformTime The time spent transforming the expression, if it matched.
+     */
+    auto Record(std::string_view rule, bool hit, std::chrono::nanoseconds matchTime, std::chrono::nanoseconds transformTime = {}) -> void;
+
+    /**
+     * Gets the statistics of every rule that was attempted since the last reset.
+     * @return The statistics, ordered by the total time spent in each rule, most first.
+     */
+    [[nodiscard]] auto GetStats() const -> std::vector<RuleStats>;
+
+    /**
+     * Discards all recorded statistics.
+     */
+    auto Reset() -> void;
+
+private:
+    struct NameHash : std::hash<std::string_view> {
+        using is_transparent = void;
+    };
+
+    std::unordered_map<std::string, RuleStats, NameHash, std::equal_to<>> stats;
+};
+
+} // Oasis
+
+#endif // OASIS_RULEPROFILER_HPP
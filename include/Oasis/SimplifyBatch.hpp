@@ -0,0 +1,121 @@
+#ifndef OASIS_SIMPLIFYBATCH_HPP
+#define OASIS_SIMPLIFYBATCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Expression.hpp"
+#include "SimplifyCache.hpp"
+#include "SimplifyVisitor.hpp"
+#include "ThreadPool.hpp"
+
+namespace Oasis {
+
+/**
+ * Options for SimplifyBatch.
+ */
+struct SimplifyBatchOpts {
+    /**
+     * The pool to simplify on, or nullptr for ThreadPool::GetDefault.
+     */
+    std::shared_ptr<ThreadPool> threadPool {};
+
+    /**
+     * The cache shared by every expression of the batch, or nullptr for a cache of its own. A
+     * cache may be passed to carry simplified subexpressions from one batch to the next.
+     */
+    std::shared_ptr<SimplifyCache> cache {};
+
+    /**
+     * The capacity of the cache made for the batch if none is given.
+     */
+    std::size_t cacheCapacity = 1 << 16;
+
+    /**
+     * The number of shards of the cache made for the batch if none is given.
+     */
+    std::size_t cacheShards = 64;
+
+    /**
+     * The smallest number of expressions simplified by a task.
+     */
+    std::size_t grainSize = 16;
+};
+
+/**
+ * Measurements of a call to SimplifyBatch.
+ */
+struct SimplifyBatchMetrics {
+    /**
+     * The number of expressions in the batch.
+     */
+    std::size_t expressions = 0;
+
+    /**
+     * The number of expressions that could not be simplified.
+     */
+    std::size_t failures = 0;
+
+    /**
+     * The number of workers of the pool the batch was simplified on.
+     */
+    std::size_t threads = 0;
+
+    /**
+     * The number of lookups of the cache that found a simplified subexpression. If the cache was
+     * used elsewhere during the batch, lookups made there are counted too.
+     */
+    std::size_t cacheHits = 0;
+
+    /**
+     * The number of lookups of the cache that did not find a simplified subexpression.
+     */
+    std::size_t cacheMisses = 0;
+
+    /**
+     * The time taken to simplify the batch.
+     */
+    std::chrono::nanoseconds elapsed {};
+
+    /**
+     * Gets the number of expressions simplified per second.
+     * @return The throughput, or zero if no time was measured.
+     */
+    [[nodiscard]] auto GetThroughput() const -> double;
+};
+
+/**
+ * The result of SimplifyBatch.
+ */
+struct SimplifyBatchResult {
+    /**
+     * The simplified expressions, in the order of the expressions they were simplified from.
+     */
+    std::vector<SimplifyVisitor::RetT> results {};
+
+    /**
+     * Measurements of the batch.
+     */
+    SimplifyBatchMetrics metrics {};
+};
+
+/**
+ * Simplifies many expressions concurrently.
+ *
+ * Expressions are split into chunks that are simplified on a pool of threads, each by a
+ * SimplifyVisitor of its own. The visitors share a SimplifyCache, so subexpressions that appear in
+ * several expressions of the batch are simplified once.
+ *
+ * @param expressions The expressions to simplify. A null expression fails to simplify.
+ * @param opts The options to simplify with.
+ * @param batchOpts The pool and cache to simplify with.
+ * @return The simplified expressions in input order, and measurements of the batch.
+ */
+auto SimplifyBatch(std::span<const Expression* const> expressions, const SimplifyOpts& opts = {}, const SimplifyBatchOpts& batchOpts = {}) -> SimplifyBatchResult;
+
+} // Oasis
+
+#endif // OASIS_SIMPLIFYBATCH_HPP
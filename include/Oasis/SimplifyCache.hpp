@@ -0,0 +1,126 @@
+#ifndef OASIS_SIMPLIFYCACHE_HPP
+#define OASIS_SIMPLIFYCACHE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Expression.hpp"
+
+namespace Oasis {
+
+/**
+ * A bounded cache of simplified expressions, used by SimplifyVisitor to simplify each distinct
+ * subexpression once.
+ *
+ * Entries are keyed by the structural hash of an expression together with a context, which
+ * SimplifyVisitor derives from its SimplifyOpts, and are verified with Equals on lookup. When the
+ * cache is full, the least recently used entry is evicted.
+ *
+ * The cache is thread safe. Entries are split between shards by key, each with its own lock and
+ * its own share of the capacity, so that threads looking up different expressions rarely wait on
+ * each other. Eviction is least recently used within a shard.
+ *
+ * Cached expressions are shared with the results handed out by the cache, so they must not be
+ * allocated from an ExpressionArena that is destroyed before the cache.
+ */
+class SimplifyCache {
+public:
+    /**
+     * Creates a cache.
+     * @param capacity The maximum number of entries held by the cache.
+     * @param shardCount The number of shards to split entries between. A single shard evicts the
+     * least recently used entry of the whole cache, while more shards let more threads use the
+     * cache at once.
+     */
+    explicit SimplifyCache(std::size_t capacity, std::size_t shardCount = 1);
+
+    SimplifyCache(const SimplifyCache& other) = delete;
+
+    /**
+     * Looks up the simplified form of an expression.
+     * @param expression The expression to look up.
+     * @param context The context the expression was simplified in.
+     * @return The simplified expression, or nullptr if it is not cached.
+     */
+    [[nodiscard]] auto Find(const Expression& expression, std::uint64_t context) -> std::shared_ptr<const Expression>;
+
+    /**
+     * Caches the simplified form of an expression, evicting the least recently used entry if the
+     * cache is full.
+     * @param expression The expression that was simplified.
+     * @param context The context the expression was simplified in.
+     * @param simplified The simplified expression.
+     */
+    auto Insert(const Expression& expression, std::uint64_t context, const Expression& simplified) -> void;
+
+    /**
+     * Removes every entry from the cache. The hit and miss counters are kept.
+     */
+    auto Clear() -> void;
+
+    /**
+     * Gets the maximum number of entries held by the cache.
+     * @return The capacity of the cache.
+     */
+    [[nodiscard]] auto GetCapacity() const -> std::size_t;
+
+    /**
+     * Gets the number of lookups that found a cached expression.
+     * @return The number of hits.
+     */
+    [[nodiscard]] auto GetHits() const -> std::size_t;
+
+    /**
+     * Gets the number of lookups that did not find a cached expression.
+     * @return The number of misses.
+     */
+    [[nodiscard]] auto GetMisses() const -> std::size_t;
+
+    /**
+     * Gets the number of shards entries are split between.
+     * @return The number of shards.
+     */
+    [[nodiscard]] auto GetShardCount() const -> std::size_t;
+
+    /**
+     * Gets the number of entries in the cache.
+     * @return The number of entries.
+     */
+    [[nodiscard]] auto Size() const -> std::size_t;
+
+    auto operator=(const SimplifyCache& other) -> SimplifyCache& = delete;
+
+private:
+    struct Entry {
+        std::uint64_t key;
+        std::uint64_t context;
+        std::shared_ptr<const Expression> expression;
+        std::shared_ptr<const Expression> simplified;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::size_t capacity = 0;
+
+        // Most recently used entries are at the front.
+        std::list<Entry> entries {};
+        std::unordered_map<std::uint64_t, std::list<Entry>::iterator> entriesByKey {};
+    };
+
+    static auto GetKey(const Expression& expression, std::uint64_t context) -> std::uint64_t;
+    auto GetShard(std::uint64_t key) const -> Shard&;
+
+    std::size_t capacity;
+    std::atomic<std::size_t> hits = 0;
+    std::atomic<std::size_t> misses = 0;
+    std::vector<std::unique_ptr<Shard>> shards;
+};
+
+} // Oasis
+
+#endif // OASIS_SIMPLIFYCACHE_HPP
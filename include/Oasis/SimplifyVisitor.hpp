@@ -5,10 +5,18 @@
 #ifndef SIMPLIFYVISITOR_HPP
 #define SIMPLIFYVISITOR_HPP
 
+#include <cstddef>
+#include <memory>
+#include <span>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <gsl-lite/gsl-lite.hpp>
 
+#include "Oasis/RuleProfiler.hpp"
+#include "Oasis/SimplifyCache.hpp"
+#include "Oasis/ThreadPool.hpp"
 #include "Oasis/Visit.hpp"
 
 namespace Oasis {
@@ -25,13 +33,63 @@ struct SimplifyOpts {
         DEFAULT,
     } distributivePolicy
         = DistributivePolicy::DEFAULT;
+
+    /**
+     * Groups of rules that can be enabled or disabled together. A disabled group is skipped
+     * entirely, leaving the expressions it would have simplified as they are.
+     */
+    struct RuleGroups {
+        /** Matrix arithmetic, such as adding and multiplying matrices. */
+        bool matrix = true;
+        /** Rules for the imaginary unit, such as i^2 = -1, and for roots of negative numbers. */
+        bool complex = true;
+        /** Rules for logarithms, such as log(a) + log(b) = log(ab). */
+        bool logarithm = true;
+        /** Evaluating trigonometric functions. */
+        bool trig = true;
+        /** Evaluating derivatives and integrals. */
+        bool calculus = true;
+
+        auto operator==(const RuleGroups&) const -> bool = default;
+    } ruleGroups {};
+
+    /**
+     * Whether to scan each expression before simplifying it, and disable the groups of rules it
+     * cannot need in addition to those disabled in ruleGroups.
+     */
+    bool detectRuleGroups = false;
 };
 
+/**
+ * Finds the groups of rules that simplifying an expression could need, with a single scan of the
+ * types of its subexpressions.
+ *
+ * @param expression The expression to scan.
+ * @return The groups of rules needed to simplify the expression.
+ */
+auto DetectRuleGroups(const Expression& expression) -> SimplifyOpts::RuleGroups;
+
 class SimplifyVisitor final : public TypedVisitor<std::expected<gsl_lite::not_null<std::unique_ptr<Expression>>, std::string>> {
 public:
+    /**
+     * The number of nodes an expression has at least when its operands are simplified
+     * concurrently, unless another threshold is given to SetThreadPool.
+     */
+    static constexpr std::size_t DefaultParallelThreshold = 2048;
+
     SimplifyVisitor();
     explicit SimplifyVisitor(SimplifyOpts& opts);
 
+    /**
+     * Creates a visitor that memoizes the simplified form of every subexpression it visits, so
+     * that repeated subexpressions are simplified once. The cache may be shared between
+     * visitors, even if their options differ.
+     *
+     * @param opts The options to simplify with.
+     * @param cache The cache to memoize into.
+     */
+    SimplifyVisitor(const SimplifyOpts& opts, std::shared_ptr<SimplifyCache> cache);
+
     auto TypedVisit(const Real& real) -> RetT override;
     auto TypedVisit(const Imaginary& imaginary) -> RetT override;
     auto TypedVisit(const Variable& variable) -> RetT override;
@@ -53,8 +111,72 @@ public:
 
     [[nodiscard]] SimplifyOpts GetOptions() const;
 
+    /**
+     * Gets the cache this visitor memoizes into.
+     * @return The cache, or nullptr if this visitor does not memoize.
+     */
+    [[nodiscard]] auto GetCache() const -> std::shared_ptr<SimplifyCache>;
+
+    /**
+     * Attaches a profiler that records every rule this visitor tries. Rules are only recorded if
+     * Oasis was built with OASIS_BUILD_PROFILING.
+     *
+     * @param ruleProfiler The profiler to record into, or nullptr to stop profiling.
+     */
+    auto SetProfiler(std::shared_ptr<RuleProfiler> ruleProfiler) -> void;
+
+    /**
+     * Gets the profiler this visitor records into.
+     * @return The profiler, or nullptr if this visitor is not profiled.
+     */
+    [[nodiscard]] auto GetProfiler() const -> std::shared_ptr<RuleProfiler>;
+
+    /**
+     * Lets this visitor simplify the operands of large expressions concurrently. Operands are
+     * split between tasks on the pool, each simplified by a copy of this visitor that shares its
+     * cache but is not profiled, as the profiler is not thread safe. Small expressions are always
+     * simplified sequentially, as splitting them costs more than it saves.
+     *
+     * @param pool The pool to simplify on, or nullptr to simplify sequentially.
+     * @param threshold The number of nodes the operands of an expression must have together to be
+     * simplified concurrently.
+     */
+    auto SetThreadPool(std::shared_ptr<ThreadPool> pool, std::size_t threshold = DefaultParallelThreshold) -> void;
+
+    /**
+     * Gets the pool this visitor simplifies on.
+     * @return The pool, or nullptr if this visitor simplifies sequentially.
+     */
+    [[nodiscard]] auto GetThreadPool() const -> std::shared_ptr<ThreadPool>;
+
 private:
+    auto SimplifyOperands(const Expression& mostSigOp, const Expression& leastSigOp) -> std::pair<RetT, RetT>;
+    auto SimplifyOperands(std::span<const Expression* const> operands) -> std::vector<RetT>;
+    [[nodiscard]] auto IsParallel(std::span<const Expression* const> operands) const -> bool;
+    [[nodiscard]] auto Fork() const -> SimplifyVisitor;
+
+    template <typename T>
+    auto Memoize(const T& expression) -> RetT;
+
+    auto Simplify(const Add<Expression, Expression>& add) -> RetT;
+    auto Simplify(const Subtract<Expression, Expression>& subtract) -> RetT;
+    auto Simplify(const Multiply<Expression, Expression>& multiply) -> RetT;
+    auto Simplify(const Divide<Expression, Expression>& divide) -> RetT;
+    auto Simplify(const Exponent<Expression, Expression>& exponent) -> RetT;
+    auto Simplify(const Log<Expression, Expression>& log) -> RetT;
+    auto Simplify(const Negate<Expression>& negate) -> RetT;
+    auto Simplify(const Sine<Expression>& sine) -> RetT;
+    auto Simplify(const Derivative<Expression, Expression>& derivative) -> RetT;
+    auto Simplify(const Integral<Expression, Expression>& integral) -> RetT;
+    auto Simplify(const Magnitude<Expression>& magnitude) -> RetT;
+
     SimplifyOpts options;
+    SimplifyOpts::RuleGroups ruleGroups;
+    std::size_t depth = 0;
+    std::shared_ptr<SimplifyCache> cache;
+    std::shared_ptr<RuleProfiler> profiler;
+    std::shared_ptr<ThreadPool> threadPool;
+    std::size_t parallelThreshold = DefaultParallelThreshold;
 };
 
 } // Oasis
@@ -26,6 +26,11 @@ public:
     {
     }
 
+    explicit Sine(std::unique_ptr<Expression>&& operand)
+        : UnaryExpression<Sine>(std::move(operand))
+    {
+    }
+
     [[nodiscard]] auto Integrate(const Expression& var) const -> std::unique_ptr<Expression> override;
 
     EXPRESSION_TYPE(Sine)
@@ -18,6 +18,7 @@ public:
     Subtract(const Subtract<Expression, Expression>& other) = default;
 
     Subtract(const Expression& minuend, const Expression& subtrahend);
+    Subtract(std::unique_ptr<Expression>&& minuend, std::unique_ptr<Expression>&& subtrahend);
 
     [[nodiscard]] auto Integrate(const Expression& integrationVariable) const -> std::unique_ptr<Expression> final;
 
@@ -167,6 +168,11 @@ public:
     {
     }
 
+    Subtract(std::unique_ptr<MinuendT>&& addend1, std::unique_ptr<SubtrahendT>&& addend2)
+        : BinaryExpression<Subtract, MinuendT, SubtrahendT>(std::move(addend1), std::move(addend2))
+    {
+    }
+
     auto operator=(const Subtract& other) -> Subtract& = default;
 
     EXPRESSION_TYPE(Subtract)
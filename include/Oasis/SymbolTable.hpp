@@ -0,0 +1,71 @@
+#ifndef OASIS_SYMBOLTABLE_HPP
+#define OASIS_SYMBOLTABLE_HPP
+
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Oasis {
+
+/**
+ * The id of an interned variable name.
+ */
+using SymbolId = std::uint32_t;
+
+/**
+ * A table of interned variable names.
+ *
+ * Each distinct name is stored once and identified by a dense 32-bit id, assigned in the order
+ * names are first seen. Comparing ids is equivalent to comparing names, and ids may be used to
+ * index arrays directly. The empty name always has id 0. Names are never removed, so ids and
+ * references to names remain valid for the lifetime of the program.
+ *
+ * The table is thread-safe.
+ */
+class SymbolTable {
+public:
+    SymbolTable();
+    SymbolTable(const SymbolTable& other) = delete;
+
+    /**
+     * Gets the table used by Variable.
+     * @return The global symbol table.
+     */
+    static auto Global() -> SymbolTable&;
+
+    /**
+     * Interns a name.
+     * @param name The name to intern.
+     * @return The id of the name.
+     */
+    auto Intern(std::string_view name) -> SymbolId;
+
+    /**
+     * Gets the name of an interned symbol.
+     * @param id The id of the symbol, as returned by Intern.
+     * @return The name of the symbol.
+     */
+    [[nodiscard]] auto GetName(SymbolId id) const -> const std::string&;
+
+    /**
+     * Gets the number of interned names. Every id is less than this number.
+     * @return The number of interned names.
+     */
+    [[nodiscard]] auto Size() const -> std::size_t;
+
+    auto operator=(const SymbolTable& other) -> SymbolTable& = delete;
+
+private:
+    mutable std::shared_mutex mutex;
+
+    // A deque never moves its elements, so the views used as keys below stay valid.
+    std::deque<std::string> names;
+    std::unordered_map<std::string_view, SymbolId> ids;
+};
+
+} // Oasis
+
+#endif // OASIS_SYMBOLTABLE_HPP
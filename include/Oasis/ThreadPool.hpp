@@ -0,0 +1,201 @@
+#ifndef OASIS_THREADPOOL_HPP
+#define OASIS_THREADPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "CancellationToken.hpp"
+#include "ExpressionArena.hpp"
+
+namespace Oasis {
+
+/**
+ * A work-stealing pool of threads for running independent parts of a computation concurrently.
+ *
+ * Each worker keeps its own queue of tasks. Tasks submitted from a worker are pushed onto its own
+ * queue and run most recent first, which keeps the subtasks of a divided computation on the
+ * thread whose cache already holds their data, while idle workers steal the oldest tasks, and so
+ * the largest pieces of work, from the queues of other workers.
+ *
+ * Waiting on a task with Wait runs other tasks until it has finished instead of blocking, so tasks
+ * may submit and wait on subtasks of their own without exhausting the pool. A task runs with the
+ * CancellationToken that was current on the thread that submitted it, or with none if there was
+ * none, and allocates expression nodes from the heap rather than from any ExpressionArena.
+ */
+class ThreadPool {
+public:
+    /**
+     * Creates a pool and starts its workers.
+     * @param threadCount The number of workers, or zero for one per hardware thread.
+     */
+    explicit ThreadPool(std::size_t threadCount = 0);
+
+    ThreadPool(const ThreadPool& other) = delete;
+    auto operator=(const ThreadPool& other) -> ThreadPool& = delete;
+
+    /**
+     * Finishes every submitted task, then stops the workers.
+     */
+    ~ThreadPool();
+
+    /**
+     * Submits a task to run on the pool.
+     * @param task The callable to run.
+     * @return A future holding the result of the task.
+     */
+    template <typename TaskT>
+    auto Submit(TaskT&& task) -> std::future<std::invoke_result_t<TaskT>>
+    {
+        std::packaged_task<std::invoke_result_t<TaskT>()> packagedTask { std::forward<TaskT>(task) };
+        auto future = packagedTask.get_future();
+
+        // The task may run inside Wait on any thread, so it replaces whatever token and arena that
+        // thread has. Arenas are not thread safe, so its nodes are allocated from the heap.
+        Push([packagedTask = std::move(packagedTask), token = CancellationToken::Current()]() mutable {
+            CancellationScope scope { token };
+            ArenaSuspension suspension;
+            packagedTask();
+        });
+
+        return future;
+    }
+
+    /**
+     * Waits for a task to finish, running other tasks of the pool in the meantime.
+     * @param future The future returned when the task was submitted.
+     * @return The result of the task.
+     */
+    template <typename T>
+    auto Wait(std::future<T>& future) -> T
+    {
+        RunUntilReady(future);
+        return future.get();
+    }
+
+    /**
+     * Runs two callables concurrently, the first on the calling thread and the second on the pool.
+     * If either throws, the exception is rethrown once both have finished.
+     * @param first The callable to run on the calling thread.
+     * @param second The callable to run on the pool.
+     * @return The results of both callables.
+     */
+    template <typename FirstT, typename SecondT>
+    auto ParallelInvoke(FirstT&& first, SecondT&& second) -> std::pair<std::invoke_result_t<FirstT>, std::invoke_result_t<SecondT>>
+    {
+        auto secondFuture = Submit(std::forward<SecondT>(second));
+
+        try {
+            auto firstResult = std::forward<FirstT>(first)();
+            return { std::move(firstResult), Wait(secondFuture) };
+        } catch (...) {
+            // The second callable may refer to the frame being unwound, so it must finish first.
+            if (secondFuture.valid()) {
+                RunUntilReady(secondFuture);
+            }
+            throw;
+        }
+    }
+
+    /**
+     * Divides a range of indices into chunks and runs a callable on each chunk concurrently. The
+     * first chunk runs on the calling thread. If a chunk throws, the first exception is rethrown
+     * once every chunk has finished.
+     *
+     * @param count The number of indices, starting from zero.
+     * @param grainSize The smallest number of indices in a chunk.
+     * @param body The callable to run, taking the first index of a chunk and one past its last.
+     */
+    template <typename BodyT>
+    auto ParallelFor(std::size_t count, std::size_t grainSize, BodyT&& body) -> void
+    {
+        // A few chunks per worker leave room to balance chunks that take longer than others.
+        const std::size_t chunks = std::clamp<std::size_t>(count / std::max<std::size_t>(grainSize, 1), 1, GetThreadCount() * 4);
+        const std::size_t chunkSize = (count + chunks - 1) / chunks;
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(chunks);
+
+        // Chunks refer to body, so every submitted chunk must finish before this returns or throws.
+        try {
+            for (std::size_t begin = chunkSize; begin < count; begin += chunkSize) {
+                futures.push_back(Submit([&body, begin, end = std::min(begin + chunkSize, count)] { body(begin, end); }));
+            }
+
+            body(std::size_t { 0 }, std::min(chunkSize, count));
+        } catch (...) {
+            for (std::future<void>& future : futures) {
+                RunUntilReady(future);
+            }
+            throw;
+        }
+
+        for (std::future<void>& future : futures) {
+            RunUntilReady(future);
+        }
+
+        for (std::future<void>& future : futures) {
+            future.get();
+        }
+    }
+
+    /**
+     * Gets the number of workers of this pool.
+     * @return The number of workers.
+     */
+    [[nodiscard]] auto GetThreadCount() const -> std::size_t;
+
+    /**
+     * Gets a pool shared by the whole process, with one worker per hardware thread. The pool is
+     * created the first time it is requested.
+     * @return The shared pool.
+     */
+    static auto GetDefault() -> std::shared_ptr<ThreadPool>;
+
+private:
+    using Task = std::move_only_function<void()>;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Runs other tasks until a future is ready, without retrieving its result.
+    template <typename T>
+    auto RunUntilReady(const std::future<T>& future) -> void
+    {
+        while (future.wait_for(std::chrono::seconds::zero()) != std::future_status::ready) {
+            if (!RunPendingTask()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    auto Push(Task task) -> void;
+    auto RunPendingTask() -> bool;
+    auto WorkerLoop(std::size_t index) -> void;
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<std::size_t> pending = 0;
+    std::atomic<std::size_t> nextQueue = 0;
+    bool stopping = false;
+};
+
+} // Oasis
+
+#endif // OASIS_THREADPOOL_HPP
@@ -5,7 +5,10 @@
 #ifndef UNARYEXPRESSION_HPP
 #define UNARYEXPRESSION_HPP
 
+#include <cassert>
+
 #include "Expression.hpp"
+#include "ExpressionArena.hpp"
 #include "Visit.hpp"
 
 namespace Oasis {
@@ -21,10 +24,8 @@ public:
 
     UnaryExpression(const UnaryExpression& other)
         : Expression(other)
+        , op(other.op)
     {
-        if (other.HasOperand()) {
-            SetOperand(other.GetOperand());
-        }
     }
 
     explicit UnaryExpression(const OperandT& operand)
@@ -32,6 +33,14 @@ public:
         SetOperand(operand);
     }
 
+    /**
+     * Constructs a unary expression that takes ownership of its operand instead of copying it.
+     */
+    explicit UnaryExpression(std::unique_ptr<OperandT>&& operand)
+        : op(ShareOperand(std::move(operand)))
+    {
+    }
+
     [[nodiscard]] auto Copy() const -> std::unique_ptr<Expression> final
     {
         return std::make_unique<DerivedSpecialized>(*static_cast<const DerivedSpecialized*>(this));
@@ -39,7 +48,11 @@ public:
 
     [[nodiscard]] auto Equals(const Expression& other) const -> bool final
     {
-        if (!other.Is<DerivedSpecialized>()) {
+        if (this == &other) {
+            return true;
+        }
+
+        if (!other.Is<DerivedSpecialized>() || this->GetHash() != other.GetHash()) {
             return false;
         }
 
@@ -52,11 +65,9 @@ public:
 
     [[nodiscard]] auto Generalize() const -> std::unique_ptr<Expression> final
     {
-        DerivedGeneralized generalized;
-        if (this->op) {
-            generalized.SetOperand(*this->op->Copy());
-        }
-        return std::make_unique<DerivedGeneralized>(generalized);
+        auto generalized = std::make_unique<DerivedGeneralized>();
+        generalized->op = this->op;
+        return generalized;
     }
 
     auto GetOperand() const -> const OperandT&
@@ -64,6 +75,16 @@ public:
         return *op;
     }
 
+    [[nodiscard]] auto GetOperandAt(std::size_t index) const -> const Expression* final
+    {
+        return index == 0 ? op.get() : nullptr;
+    }
+
+    [[nodiscard]] auto GetOperandCount() const -> std::size_t final
+    {
+        return 1;
+    }
+
     auto HasOperand() const -> bool
     {
         return op != nullptr;
@@ -77,10 +98,35 @@ public:
     auto SetOperand(const OperandT& operand) -> void
     {
         if constexpr (std::same_as<OperandT, Expression>) {
-            this->op = operand.Copy();
+            this->op = ShareOperand(operand.Copy());
         } else {
-            this->op = std::make_unique<OperandT>(operand);
+            this->op = ShareOperand(std::make_unique<OperandT>(operand));
         }
+
+        InvalidateHash();
+    }
+
+    /**
+     * Sets the operand of this expression, taking ownership of it instead of copying it.
+     * @param operand The operand to set.
+     */
+    template <typename T>
+        requires std::derived_from<T, OperandT>
+    auto SetOperand(std::unique_ptr<T>&& operand) -> void
+    {
+        this->op = ShareOperand(std::move(operand));
+        InvalidateHash();
+    }
+
+    /**
+     * Sets the operand of this expression without copying it. The operand may be shared with
+     * other expressions, e.g. nodes interned by an ExpressionStore.
+     * @param operand The operand to set.
+     */
+    auto SetOperand(std::shared_ptr<const OperandT> operand) -> void
+    {
+        this->op = std::move(operand);
+        InvalidateHash();
     }
 
     auto Substitute(const Expression& var, const Expression& val) -> std::unique_ptr<Expression> override
@@ -93,13 +139,26 @@ public:
 
     auto AcceptInternal(Visitor& visitor) const -> any override
     {
-        const auto generalized = Generalize();
-        const auto& derivedGeneralized = dynamic_cast<const DerivedGeneralized&>(*generalized);
-        return visitor.Visit(derivedGeneralized);
+        assert(this->GetType() == DerivedGeneralized::GetStaticType());
+
+        if constexpr (std::is_same_v<DerivedSpecialized, DerivedGeneralized>) {
+            return visitor.Visit(*static_cast<const DerivedGeneralized*>(this));
+        } else {
+            const auto generalized = Generalize();
+            return visitor.Visit(static_cast<const DerivedGeneralized&>(*generalized));
+        }
     }
 
 protected:
-    std::unique_ptr<OperandT> op;
+    template <template <IExpression> class, IExpression>
+    friend class UnaryExpression;
+
+    [[nodiscard]] auto ComputeHash() const -> std::uint64_t override
+    {
+        return CombineHash(Expression::ComputeHash(), op ? op->GetHash() : 0);
+    }
+
+    std::shared_ptr<const OperandT> op;
 };
 
 } // Oasis
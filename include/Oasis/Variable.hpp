@@ -9,6 +9,7 @@
 #include <string>
 
 #include "LeafExpression.hpp"
+#include "SymbolTable.hpp"
 
 namespace Oasis {
 
@@ -16,7 +17,8 @@ namespace Oasis {
  * An algebraic variable.
  *
  * Variables are used to represent unknown values in an expression. Variables
- * can have names such as "x" or "y" or "x_1" and so on.
+ * can have names such as "x" or "y" or "x_1" and so on. Names are interned in the
+ * global SymbolTable, so a variable only stores the id of its name.
  *
  * @section Parameters
  * @tparam Variable the variable name of the class.
@@ -44,7 +46,15 @@ public:
      *
      * @return The name of the variable.
      */
-    [[nodiscard]] auto GetName() const -> std::string;
+    [[nodiscard]] auto GetName() const -> const std::string&;
+
+    /**
+     * Gets the id of the name of the variable in the global SymbolTable. Two variables have the
+     * same name if and only if they have the same symbol.
+     *
+     * @return The symbol of the variable.
+     */
+    [[nodiscard]] auto GetSymbol() const -> SymbolId;
 
     [[nodiscard]] auto Integrate(const Expression& integrationVariable) const -> std::unique_ptr<Expression> final;
 
@@ -52,8 +62,11 @@ public:
 
     auto operator=(const Variable& other) -> Variable& = default;
 
+protected:
+    [[nodiscard]] auto ComputeHash() const -> std::uint64_t final;
+
 private:
-    std::string name {};
+    SymbolId symbol = 0;
 };
 
 } // Oasis
@@ -0,0 +1,188 @@
+#ifndef CODEGENVISITOR_HPP
+#define CODEGENVISITOR_HPP
+
+#include <expected>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Oasis/Visit.hpp"
+
+namespace Oasis {
+
+/**
+ * Options for CodeGenVisitor.
+ */
+struct CodeGenOpts {
+    /**
+     * The languages code may be generated in.
+     */
+    enum class Language {
+        C,
+        Cpp
+    };
+
+    /**
+     * The language to generate code in. C++ functions are declared extern "C", so that they can
+     * be found by name once compiled.
+     */
+    Language language = Language::Cpp;
+
+    /**
+     * The name of the generated function.
+     */
+    std::string functionName = "oasis_function";
+
+    /**
+     * The names of the variables, in the order of the parameters of the generated function. If
+     * empty, variables are ordered by where they first appear in the expressions.
+     */
+    std::vector<std::string> variables {};
+
+    /**
+     * Whether to generate a function that evaluates arrays of points in a loop, with restrict
+     * qualified pointers to the values of each variable and to the results, instead of a
+     * function that evaluates a single point.
+     */
+    bool batch = false;
+
+    /**
+     * Whether to fuse products that are added to or subtracted from something into calls to fma.
+     */
+    bool useFma = true;
+
+    /**
+     * Whether to rewrite polynomials in a single variable with numeric coefficients in Horner
+     * form.
+     */
+    bool useHorner = true;
+};
+
+/**
+ * The CodeGenVisitor class generates the source of a self-contained C or C++ function that
+ * evaluates an expression, or several expressions at once, with doubles.
+ *
+ * Subexpressions that appear more than once are computed once, into a temporary declared before
+ * they are first needed. Visiting an expression generates a function returning its value, while
+ * Generate makes a function that writes the value of each expression to an array. With the batch
+ * option, the function instead takes the number of points, a pointer to the values of each
+ * variable, and a pointer to the results, which are written for the first expression at every
+ * point, then for the second, and so on.
+ *
+ * @section exam Example Usage:
+ * @code
+Oasis::CodeGenVisitor codeGen { { .functionName = "f", .variables = { "x" } } };
+
+// double f(double x) with 3x^2 + 2x + 1 in Horner form, using std::fma
+const auto source = polynomial.Accept(codeGen);
+ * @endcode
+ */
+class CodeGenVisitor final : public TypedVisitor<std::expected<std::string, std::string>> {
+public:
+    CodeGenVisitor() = default;
+
+    /**
+     * Creates a visitor.
+     * @param opts The options to generate code with.
+     */
+    explicit CodeGenVisitor(CodeGenOpts opts);
+
+    auto TypedVisit(const Real& real) -> RetT override;
+    auto TypedVisit(const Imaginary& imaginary) -> RetT override;
+    auto TypedVisit(const Variable& variable) -> RetT override;
+    auto TypedVisit(const Undefined& undefined) -> RetT override;
+    auto TypedVisit(const Add<Expression, Expression>& add) -> RetT override;
+    auto TypedVisit(const Subtract<Expression, Expression>& subtract) -> RetT override;
+    auto TypedVisit(const Multiply<Expression, Expression>& multiply) -> RetT override;
+    auto TypedVisit(const Divide<Expression, Expression>& divide) -> RetT override;
+    auto TypedVisit(const Exponent<Expression, Expression>& exponent) -> RetT override;
+    auto TypedVisit(const Log<Expression, Expression>& log) -> RetT override;
+    auto TypedVisit(const Negate<Expression>& negate) -> RetT override;
+    auto TypedVisit(const Sine<Expression>& sine) -> RetT override;
+    auto TypedVisit(const Derivative<Expression, Expression>& derivative) -> RetT override;
+    auto TypedVisit(const Integral<Expression, Expression>& integral) -> RetT override;
+    auto TypedVisit(const Matrix& matrix) -> RetT override;
+    auto TypedVisit(const EulerNumber&) -> RetT override;
+    auto TypedVisit(const Pi&) -> RetT override;
+    auto TypedVisit(const Magnitude<Expression>& magnitude) -> RetT override;
+
+    /**
+     * Generates a function that evaluates several expressions, sharing the subexpressions they
+     * have in common.
+     * @param expressions The expressions to evaluate.
+     * @return The source of the function, or an error if an expression cannot be evaluated to a
+     * real number or has a variable that is not in the options, or if the function or one of its
+     * parameters would be named after a keyword or a name declared by the math library.
+     */
+    auto Generate(std::span<const Expression* const> expressions) -> RetT;
+
+    /**
+     * Gets the options this visitor generates code with.
+     * @return The options.
+     */
+    [[nodiscard]] auto GetOpts() const -> const CodeGenOpts&;
+
+private:
+    CodeGenOpts opts;
+};
+
+/**
+ * Options for CompileNative.
+ */
+struct NativeCompileOpts {
+    /**
+     * The language the source is in.
+     */
+    CodeGenOpts::Language language = CodeGenOpts::Language::Cpp;
+
+    /**
+     * The compiler to run, or empty for the compiler named by the CXX or CC environment variable,
+     * falling back to c++ or cc.
+     */
+    std::string compiler {};
+
+    /**
+     * The flags to compile with, besides those needed to build a shared library.
+     */
+    std::vector<std::string> flags { "-O3", "-march=native" };
+};
+
+/**
+ * A function compiled by CompileNative and loaded into the process. The library holding the
+ * function stays loaded for as long as a copy of this object exists.
+ */
+class NativeFunction {
+public:
+    /**
+     * Gets the function.
+     * @tparam FnT The type of the function, such as double(double, double) for a function of two
+     * variables generated without the batch option.
+     * @return A pointer to the function.
+     */
+    template <typename FnT>
+    [[nodiscard]] auto Get() const -> FnT*
+    {
+        return reinterpret_cast<FnT*>(symbol);
+    }
+
+private:
+    friend auto CompileNative(const std::string& source, const std::string& functionName, const NativeCompileOpts& opts) -> std::expected<NativeFunction, std::string>;
+
+    std::shared_ptr<void> library;
+    void* symbol = nullptr;
+};
+
+/**
+ * Compiles generated source into a shared library with the system compiler and loads a function
+ * from it. Only supported on platforms with dlopen.
+ * @param source The source to compile, such as the result of CodeGenVisitor.
+ * @param functionName The name of the function to load.
+ * @param opts The compiler to use and the flags to pass to it.
+ * @return The loaded function, or an error if the source could not be compiled or loaded.
+ */
+auto CompileNative(const std::string& source, const std::string& functionName, const NativeCompileOpts& opts = {}) -> std::expected<NativeFunction, std::string>;
+
+} // Oasis
+
+#endif // CODEGENVISITOR_HPP
@@ -0,0 +1,829 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <numbers>
+#include <optional>
+#include <system_error>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dlfcn.h>
+#define OASIS_HAS_DLOPEN
+#endif
+
+#include "Oasis/CodeGenVisitor.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/Derivative.hpp"
+#include "Oasis/Divide.hpp"
+#include "Oasis/EulerNumber.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/Imaginary.hpp"
+#include "Oasis/Integral.hpp"
+#include "Oasis/Log.hpp"
+#include "Oasis/Magnitude.hpp"
+#include "Oasis/Matrix.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Negate.hpp"
+#include "Oasis/Pi.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/Sine.hpp"
+#include "Oasis/Subtract.hpp"
+#include "Oasis/Undefined.hpp"
+#include "Oasis/Variable.hpp"
+
+namespace Oasis {
+
+namespace {
+
+// Integer powers up to this are written as products rather than calls to pow.
+constexpr double MAX_EXPANDED_POWER = 4.0;
+
+// Polynomials of higher degree are left as they are, rather than written with a coefficient for
+// every power.
+constexpr std::size_t MAX_HORNER_DEGREE = 64;
+
+const std::string TEMPORARY_PREFIX = "oasis_t";
+
+auto IsIdentifier(const std::string& name) -> bool
+{
+    const auto isIdentifierChar = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+    return !name.empty() && !std::isdigit(static_cast<unsigned char>(name.front())) && std::ranges::all_of(name, isIdentifierChar);
+}
+
+// Whether a name cannot be declared in generated code, as a keyword of C or C++ or a name that
+// <math.h>, <cmath> or <stddef.h> declare, or may define as a macro.
+auto IsReservedWord(const std::string& name) -> bool
+{
+    static const std::unordered_set<std::string_view> KEYWORDS {
+        // Keywords of C and C++, including alternative operator spellings
+        "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break",
+        "case", "catch", "char", "char8_t", "char16_t", "char32_t", "class", "co_await", "co_return",
+        "co_yield", "compl", "concept", "const", "const_cast", "consteval", "constexpr", "constinit",
+        "continue", "decltype", "default", "delete", "do", "double", "dynamic_cast", "else", "enum",
+        "explicit", "export", "extern", "false", "float", "for", "friend", "goto", "if", "inline",
+        "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq", "nullptr",
+        "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast",
+        "requires", "restrict", "return", "short", "signed", "sizeof", "static", "static_assert",
+        "static_cast", "struct", "switch", "template", "this", "thread_local", "throw", "true", "try",
+        "typedef", "typeid", "typename", "typeof", "union", "unsigned", "using", "virtual", "void",
+        "volatile", "wchar_t", "while", "xor", "xor_eq", "std",
+        // Types and macros of <math.h> and <stddef.h>
+        "double_t", "float_t", "errno", "math_errhandling", "HUGE_VAL", "HUGE_VALF", "HUGE_VALL",
+        "INFINITY", "NAN", "MATH_ERRNO", "MATH_ERREXCEPT", "NULL", "offsetof", "size_t", "ptrdiff_t",
+        "max_align_t", "nullptr_t"
+    };
+
+    // Functions of <math.h>, which also have float and long double versions suffixed with f and l
+    static const std::unordered_set<std::string_view> FUNCTIONS {
+        "abs", "acos", "acosh", "asin", "asinh", "atan", "atan2", "atanh", "cbrt", "ceil", "copysign",
+        "cos", "cosh", "erf", "erfc", "exp", "exp2", "expm1", "fabs", "fdim", "floor", "fma", "fmax",
+        "fmin", "fmod", "fpclassify", "frexp", "hypot", "ilogb", "isfinite", "isgreater",
+        "isgreaterequal", "isinf", "isless", "islessequal", "islessgreater", "isnan", "isnormal",
+        "isunordered", "ldexp", "lgamma", "llrint", "llround", "log", "log10", "log1p", "log2", "logb",
+        "lrint", "lround", "modf", "nan", "nearbyint", "nextafter", "nexttoward", "pow", "remainder",
+        "remquo", "rint", "round", "scalbln", "scalbn", "signbit", "sin", "sinh", "sqrt", "tan", "tanh",
+        "tgamma", "trunc"
+    };
+
+    // Identifiers starting with an underscore and a capital letter or with two underscores are
+    // reserved, and <math.h> may define macros such as M_PI and FP_NAN.
+    if (name.starts_with("__") || (name.size() > 1 && name[0] == '_' && std::isupper(static_cast<unsigned char>(name[1])))
+        || name.starts_with("M_") || name.starts_with("FP_")) {
+        return true;
+    }
+
+    if (KEYWORDS.contains(name) || FUNCTIONS.contains(name)) {
+        return true;
+    }
+
+    const bool suffixed = name.size() > 1 && (name.back() == 'f' || name.back() == 'l');
+    return suffixed && FUNCTIONS.contains(std::string_view { name }.substr(0, name.size() - 1));
+}
+
+// Whether a name cannot be used for a parameter, as it is a reserved word or a name the generated
+// function declares itself.
+auto IsReserved(const std::string& name) -> bool
+{
+    return IsReservedWord(name) || name == "n" || name == "i" || name == "out" || name.starts_with("in_") || name.starts_with(TEMPORARY_PREFIX);
+}
+
+auto IsLeaf(const Expression& expression) -> bool
+{
+    switch (expression.GetType()) {
+    case ExpressionType::None:
+    case ExpressionType::Real:
+    case ExpressionType::Variable:
+    case ExpressionType::Pi:
+    case ExpressionType::EulerNumber:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Writes a double so that it reads back as the same double.
+auto Literal(double value) -> std::string
+{
+    if (std::isnan(value)) {
+        return "NAN";
+    }
+    if (std::isinf(value)) {
+        return value < 0.0 ? "(-INFINITY)" : "INFINITY";
+    }
+
+    std::array<char, 32> buffer {};
+    const auto [end, error] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    std::string literal { buffer.data(), end };
+
+    if (literal.find_first_of(".e") == std::string::npos) {
+        literal += ".0";
+    }
+
+    return std::signbit(value) ? "(" + literal + ")" : literal;
+}
+
+// Negates emitted code. The operand is parenthesized, as it may itself start with a minus sign,
+// and a leading minus sign would then read as a decrement.
+auto Negated(const std::string& operand) -> std::string
+{
+    return "-(" + operand + ")";
+}
+
+// A term c * v^k of a polynomial in the variable v.
+struct Monomial {
+    double coefficient = 1.0;
+    std::size_t degree = 0;
+    const Variable* variable = nullptr;
+};
+
+auto AsMonomial(const Expression& expression) -> std::optional<Monomial>
+{
+    switch (expression.GetType()) {
+    case ExpressionType::Real:
+        return Monomial { .coefficient = static_cast<const Real&>(expression).GetValue() };
+    case ExpressionType::Variable:
+        return Monomial { .degree = 1, .variable = static_cast<const Variable*>(&expression) };
+    case ExpressionType::Exponent: {
+        const Expression* base = expression.GetOperandAt(0);
+        const Expression* power = expression.GetOperandAt(1);
+        if (base == nullptr || power == nullptr || base->GetType() != ExpressionType::Variable || power->GetType() != ExpressionType::Real) {
+            return std::nullopt;
+        }
+
+        const double degree = static_cast<const Real*>(power)->GetValue();
+        if (degree < 0.0 || std::trunc(degree) != degree || degree > static_cast<double>(MAX_HORNER_DEGREE)) {
+            return std::nullopt;
+        }
+        return Monomial { .degree = static_cast<std::size_t>(degree), .variable = static_cast<const Variable*>(base) };
+    }
+    case ExpressionType::Negate: {
+        const Expression* operand = expression.GetOperandAt(0);
+        auto monomial = operand != nullptr ? AsMonomial(*operand) : std::nullopt;
+        if (monomial) {
+            monomial->coefficient = -monomial->coefficient;
+        }
+        return monomial;
+    }
+    case ExpressionType::Multiply: {
+        const Expression* mostSigOp = expression.GetOperandAt(0);
+        const Expression* leastSigOp = expression.GetOperandAt(1);
+        if (mostSigOp == nullptr || leastSigOp == nullptr) {
+            return std::nullopt;
+        }
+
+        const std::optional<Monomial> first = AsMonomial(*mostSigOp);
+        const std::optional<Monomial> second = AsMonomial(*leastSigOp);
+        if (!first || !second) {
+            return std::nullopt;
+        }
+
+        Monomial product { .coefficient = first->coefficient * second->coefficient, .degree = first->degree + second->degree, .variable = first->variable };
+        if (product.variable == nullptr) {
+            product.variable = second->variable;
+        } else if (second->variable != nullptr && !product.variable->Equals(*second->variable)) {
+            return std::nullopt;
+        }
+        return product;
+    }
+    default:
+        return std::nullopt;
+    }
+}
+
+class Generator {
+public:
+    Generator(const CodeGenOpts& opts, std::vector<std::string> variables, std::string indent)
+        : opts(opts)
+        , variables(std::move(variables))
+        , indent(std::move(indent))
+    {
+    }
+
+    // Counts the occurrences of each subexpression. The operands of a subexpression are counted
+    // the first time it is seen only, since it is computed once however often it appears.
+    auto Count(const Expression& expression) -> void
+    {
+        if (++counts[&expression] > 1) {
+            return;
+        }
+
+        for (std::size_t i = 0; i < expression.GetOperandCount(); ++i) {
+            if (const Expression* operand = expression.GetOperandAt(i)) {
+                Count(*operand);
+            }
+        }
+    }
+
+    auto Emit(const Expression& expression) -> std::expected<std::string, std::string>
+    {
+        if (const auto it = temporaries.find(&expression); it != temporaries.end()) {
+            return it->second;
+        }
+
+        auto code = EmitUncached(expression);
+        if (!code || IsLeaf(expression) || counts[&expression] < 2) {
+            return code;
+        }
+
+        std::string name = TEMPORARY_PREFIX + std::to_string(temporaries.size());
+        body += indent + "const double " + name + " = " + *code + ";\n";
+        temporaries.emplace(&expression, name);
+        return name;
+    }
+
+    std::string body;
+
+private:
+    auto Function(const std::string& name) const -> std::string
+    {
+        return opts.language == CodeGenOpts::Language::Cpp ? "std::" + name : name;
+    }
+
+    auto IsShared(const Expression& expression) -> bool
+    {
+        return counts[&expression] > 1;
+    }
+
+    auto EmitOperand(const Expression& expression, std::size_t index) -> std::expected<std::string, std::string>
+    {
+        const Expression* operand = expression.GetOperandAt(index);
+        if (operand == nullptr) {
+            return std::unexpected { "Missing operand." };
+        }
+        return Emit(*operand);
+    }
+
+    auto EmitCall(const Expression& expression, const std::string& function) -> std::expected<std::string, std::string>
+    {
+        return EmitOperand(expression, 0).transform([this, &function](const std::string& operand) {
+            return Function(function) + "(" + operand + ")";
+        });
+    }
+
+    auto EmitBinary(const Expression& expression, const std::string& op) -> std::expected<std::string, std::string>
+    {
+        return EmitOperand(expression, 0).and_then([this, &expression, &op](const std::string& mostSigOp) {
+            return EmitOperand(expression, 1).transform([&mostSigOp, &op](const std::string& leastSigOp) {
+                return "(" + mostSigOp + " " + op + " " + leastSigOp + ")";
+            });
+        });
+    }
+
+    // Gets the operand of an expression if it is a product computed nowhere else, so that it may
+    // be fused into a call to fma.
+    auto GetFusableProduct(const Expression& expression, std::size_t index) -> const Expression*
+    {
+        const Expression* operand = expression.GetOperandAt(index);
+        if (!opts.useFma || operand == nullptr || operand->GetType() != ExpressionType::Multiply || IsShared(*operand)) {
+            return nullptr;
+        }
+        return operand;
+    }
+
+    // Writes fma(a, b, c), negating the product or the addend as asked.
+    auto EmitFma(const Expression& product, bool negateProduct, const Expression& addend, bool negateAddend) -> std::expected<std::string, std::string>
+    {
+        const auto a = EmitOperand(product, 0);
+        if (!a) {
+            return a;
+        }
+        const auto b = EmitOperand(product, 1);
+        if (!b) {
+            return b;
+        }
+        const auto c = Emit(addend);
+        if (!c) {
+            return c;
+        }
+        return Function("fma") + "(" + (negateProduct ? Negated(*a) : *a) + ", " + *b + ", " + (negateAddend ? Negated(*c) : *c) + ")";
+    }
+
+    auto EmitAdd(const Expression& add) -> std::expected<std::string, std::string>
+    {
+        if (opts.useHorner) {
+            if (auto horner = EmitHorner(add)) {
+                return *horner;
+            }
+        }
+
+        if (const Expression* product = GetFusableProduct(add, 0)) {
+            return EmitFma(*product, false, *add.GetOperandAt(1), false);
+        }
+        if (const Expression* product = GetFusableProduct(add, 1)) {
+            return EmitFma(*product, false, *add.GetOperandAt(0), false);
+        }
+        return EmitBinary(add, "+");
+    }
+
+    auto EmitSubtract(const Expression& subtract) -> std::expected<std::string, std::string>
+    {
+        if (const Expression* product = GetFusableProduct(subtract, 0)) {
+            return EmitFma(*product, false, *subtract.GetOperandAt(1), true);
+        }
+        if (const Expression* product = GetFusableProduct(subtract, 1)) {
+            return EmitFma(*product, true, *subtract.GetOperandAt(0), false);
+        }
+        return EmitBinary(subtract, "-");
+    }
+
+    // Writes a sum of monomials in one variable in Horner form, if it is one.
+    auto EmitHorner(const Expression& add) -> std::optional<std::string>
+    {
+        std::vector<const Expression*> terms;
+        std::vector<const Expression*> pending { &add };
+
+        while (!pending.empty()) {
+            const Expression* term = pending.back();
+            pending.pop_back();
+
+            // A shared sum is computed on its own, so it is a term rather than part of this sum.
+            if (term->GetType() == ExpressionType::Add && (term == &add || !IsShared(*term))) {
+                for (std::size_t i = 0; i < term->GetOperandCount(); ++i) {
+                    if (const Expression* operand = term->GetOperandAt(i)) {
+                        pending.push_back(operand);
+                    }
+                }
+                continue;
+            }
+            terms.push_back(term);
+        }
+
+        std::vector<double> coefficients;
+        const Variable* variable = nullptr;
+
+        for (const Expression* term : terms) {
+            const auto monomial = AsMonomial(*term);
+            if (!monomial || (variable && monomial->variable && !variable->Equals(*monomial->variable))) {
+                return std::nullopt;
+            }
+
+            variable = variable ? variable : monomial->variable;
+            coefficients.resize(std::max(coefficients.size(), monomial->degree + 1));
+            coefficients[monomial->degree] += monomial->coefficient;
+        }
+
+        if (variable == nullptr || coefficients.size() < 3) {
+            return std::nullopt;
+        }
+
+        const auto x = Emit(*variable);
+        if (!x) {
+            return std::nullopt;
+        }
+
+        std::string polynomial = Literal(coefficients.back());
+        for (std::size_t degree = coefficients.size() - 1; degree-- > 0;) {
+            if (coefficients[degree] == 0.0) {
+                polynomial = "(" + polynomial + " * " + *x + ")";
+            } else if (opts.useFma) {
+                polynomial = Function("fma") + "(" + polynomial + ", " + *x + ", " + Literal(coefficients[degree]) + ")";
+            } else {
+                polynomial = "(" + polynomial + " * " + *x + " + " + Literal(coefficients[degree]) + ")";
+            }
+        }
+
+        return polynomial;
+    }
+
+    auto EmitExponent(const Expression& exponent) -> std::expected<std::string, std::string>
+    {
+        const Expression* base = exponent.GetOperandAt(0);
+        const Expression* power = exponent.GetOperandAt(1);
+        if (base == nullptr || power == nullptr) {
+            return std::unexpected { "Missing operand." };
+        }
+
+        if (base->GetType() == ExpressionType::EulerNumber) {
+            return Emit(*power).transform([this](const std::string& emittedPower) {
+                return Function("exp") + "(" + emittedPower + ")";
+            });
+        }
+
+        const auto emittedBase = Emit(*base);
+        if (!emittedBase) {
+            return emittedBase;
+        }
+
+        if (power->GetType() == ExpressionType::Real) {
+            const double value = static_cast<const Real*>(power)->GetValue();
+            if (value == 0.5) {
+                return Function("sqrt") + "(" + *emittedBase + ")";
+            }
+
+            // Small integer powers of a name are written as products, which need no call.
+            if (std::trunc(value) == value && std::abs(value) >= 1.0 && std::abs(value) <= MAX_EXPANDED_POWER && IsIdentifier(*emittedBase)) {
+                std::string product = *emittedBase;
+                for (int i = 1; i < static_cast<int>(std::abs(value)); ++i) {
+                    product += " * " + *emittedBase;
+                }
+                return value > 0.0 ? "(" + product + ")" : "(1.0 / (" + product + "))";
+            }
+        }
+
+        return Emit(*power).transform([this, &emittedBase](const std::string& emittedPower) {
+            return Function("pow") + "(" + *emittedBase + ", " + emittedPower + ")";
+        });
+    }
+
+    auto EmitLog(const Expression& log) -> std::expected<std::string, std::string>
+    {
+        const Expression* base = log.GetOperandAt(0);
+        if (base == nullptr) {
+            return std::unexpected { "Missing operand." };
+        }
+
+        const auto argument = EmitOperand(log, 1);
+        if (!argument) {
+            return argument;
+        }
+
+        if (base->GetType() == ExpressionType::EulerNumber) {
+            return Function("log") + "(" + *argument + ")";
+        }
+        if (base->GetType() == ExpressionType::Real && static_cast<const Real*>(base)->GetValue() == 10.0) {
+            return Function("log10") + "(" + *argument + ")";
+        }
+        if (base->GetType() == ExpressionType::Real && static_cast<const Real*>(base)->GetValue() == 2.0) {
+            return Function("log2") + "(" + *argument + ")";
+        }
+
+        return Emit(*base).transform([this, &argument](const std::string& emittedBase) {
+            const std::string log = Function("log");
+            return "(" + log + "(" + *argument + ") / " + log + "(" + emittedBase + "))";
+        });
+    }
+
+    auto EmitUncached(const Expression& expression) -> std::expected<std::string, std::string>
+    {
+        switch (expression.GetType()) {
+        case ExpressionType::None:
+            return "NAN";
+        case ExpressionType::Real:
+            return Literal(static_cast<const Real&>(expression).GetValue());
+        case ExpressionType::Pi:
+            return Literal(std::numbers::pi);
+        case ExpressionType::EulerNumber:
+            return Literal(std::numbers::e);
+        case ExpressionType::Variable: {
+            const std::string& name = static_cast<const Variable&>(expression).GetName();
+            if (std::ranges::find(variables, name) == variables.end()) {
+                return std::unexpected { "Variable " + name + " is not a parameter of the function." };
+            }
+            return name;
+        }
+        case ExpressionType::Add:
+            return EmitAdd(expression);
+        case ExpressionType::Subtract:
+            return EmitSubtract(expression);
+        case ExpressionType::Multiply:
+            return EmitBinary(expression, "*");
+        case ExpressionType::Divide:
+            return EmitBinary(expression, "/");
+        case ExpressionType::Negate:
+            return EmitOperand(expression, 0).transform(Negated);
+        case ExpressionType::Sine:
+            return EmitCall(expression, "sin");
+        case ExpressionType::Magnitude:
+            return EmitCall(expression, opts.language == CodeGenOpts::Language::Cpp ? "abs" : "fabs");
+        case ExpressionType::Exponent:
+            return EmitExponent(expression);
+        case ExpressionType::Log:
+            return EmitLog(expression);
+        default:
+            return std::unexpected { "Expression cannot be evaluated to a real number." };
+        }
+    }
+
+    const CodeGenOpts& opts;
+    std::vector<std::string> variables;
+    std::string indent;
+
+    std::unordered_map<const Expression*, std::size_t, ExpressionHash, ExpressionEqual> counts;
+    std::unordered_map<const Expression*, std::string, ExpressionHash, ExpressionEqual> temporaries;
+};
+
+// Collects the names of the variables of an expression, in the order they first appear.
+auto CollectVariables(const Expression& expression, std::vector<std::string>& names) -> void
+{
+    if (expression.GetType() == ExpressionType::Variable) {
+        const std::string& name = static_cast<const Variable&>(expression).GetName();
+        if (std::ranges::find(names, name) == names.end()) {
+            names.push_back(name);
+        }
+        return;
+    }
+
+    for (std::size_t i = 0; i < expression.GetOperandCount(); ++i) {
+        if (const Expression* operand = expression.GetOperandAt(i)) {
+            CollectVariables(*operand, names);
+        }
+    }
+}
+
+}
+
+CodeGenVisitor::CodeGenVisitor(CodeGenOpts opts)
+    : opts(std::move(opts))
+{
+}
+
+auto CodeGenVisitor::TypedVisit(const Real& real) -> RetT
+{
+    const Expression* expression = &real;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Imaginary& imaginary) -> RetT
+{
+    const Expression* expression = &imaginary;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Variable& variable) -> RetT
+{
+    const Expression* expression = &variable;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Undefined& undefined) -> RetT
+{
+    const Expression* expression = &undefined;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Add<Expression, Expression>& add) -> RetT
+{
+    const Expression* expression = &add;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Subtract<Expression, Expression>& subtract) -> RetT
+{
+    const Expression* expression = &subtract;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Multiply<Expression, Expression>& multiply) -> RetT
+{
+    const Expression* expression = &multiply;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Divide<Expression, Expression>& divide) -> RetT
+{
+    const Expression* expression = &divide;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Exponent<Expression, Expression>& exponent) -> RetT
+{
+    const Expression* expression = &exponent;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Log<Expression, Expression>& log) -> RetT
+{
+    const Expression* expression = &log;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Negate<Expression>& negate) -> RetT
+{
+    const Expression* expression = &negate;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Sine<Expression>& sine) -> RetT
+{
+    const Expression* expression = &sine;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Derivative<Expression, Expression>& derivative) -> RetT
+{
+    const Expression* expression = &derivative;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Integral<Expression, Expression>& integral) -> RetT
+{
+    const Expression* expression = &integral;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Matrix& matrix) -> RetT
+{
+    const Expression* expression = &matrix;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const EulerNumber& e) -> RetT
+{
+    const Expression* expression = &e;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Pi& pi) -> RetT
+{
+    const Expression* expression = &pi;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::TypedVisit(const Magnitude<Expression>& magnitude) -> RetT
+{
+    const Expression* expression = &magnitude;
+    return Generate({ &expression, 1 });
+}
+
+auto CodeGenVisitor::Generate(std::span<const Expression* const> expressions) -> RetT
+{
+    if (expressions.empty() || std::ranges::find(expressions, nullptr) != expressions.end()) {
+        return std::unexpected { "Missing expression." };
+    }
+
+    if (!IsIdentifier(opts.functionName) || IsReservedWord(opts.functionName)) {
+        return std::unexpected { "Function name " + opts.functionName + " cannot be the name of a function." };
+    }
+
+    std::vector<std::string> variables = opts.variables;
+    if (variables.empty()) {
+        for (const Expression* expression : expressions) {
+            CollectVariables(*expression, variables);
+        }
+    }
+
+    for (const std::string& variable : variables) {
+        if (!IsIdentifier(variable) || IsReserved(variable)) {
+            return std::unexpected { "Variable " + variable + " cannot be the name of a parameter." };
+        }
+    }
+
+    const bool cpp = opts.language == CodeGenOpts::Language::Cpp;
+    const std::string sizeType = cpp ? "std::size_t" : "size_t";
+    const std::string restrict = cpp ? "__restrict" : "restrict";
+    const std::string indent = opts.batch ? "        " : "    ";
+
+    Generator generator { opts, variables, indent };
+    for (const Expression* expression : expressions) {
+        generator.Count(*expression);
+    }
+
+    std::vector<std::string> results;
+    for (const Expression* expression : expressions) {
+        auto result = generator.Emit(*expression);
+        if (!result) {
+            return std::unexpected { result.error() };
+        }
+        results.push_back(std::move(*result));
+    }
+
+    std::string source = cpp ? "#include <cmath>\n#include <cstddef>\n\n" : "#include <math.h>\n#include <stddef.h>\n\n";
+    source += cpp ? "extern \"C\" " : "";
+
+    std::vector<std::string> parameters;
+
+    if (opts.batch) {
+        parameters.push_back(sizeType + " n");
+        for (const std::string& variable : variables) {
+            parameters.push_back("const double* " + restrict + " in_" + variable);
+        }
+        parameters.push_back("double* " + restrict + " out");
+    } else {
+        for (const std::string& variable : variables) {
+            parameters.push_back("double " + variable);
+        }
+        if (results.size() > 1) {
+            parameters.push_back("double* out");
+        }
+    }
+
+    std::string parameterList;
+    for (const std::string& parameter : parameters) {
+        parameterList += (parameterList.empty() ? "" : ", ") + parameter;
+    }
+    if (parameterList.empty() && !cpp) {
+        parameterList = "void";
+    }
+
+    const bool returnsValue = !opts.batch && results.size() == 1;
+    source += (returnsValue ? "double " : "void ") + opts.functionName + "(" + parameterList + ")\n{\n";
+
+    if (opts.batch) {
+        source += "    for (" + sizeType + " i = 0; i < n; ++i) {\n";
+        for (const std::string& variable : variables) {
+            source += indent + "const double " + variable + " = in_" + variable + "[i];\n";
+        }
+    }
+
+    source += generator.body;
+
+    for (std::size_t k = 0; k < results.size(); ++k) {
+        if (returnsValue) {
+            source += indent + "return " + results[k] + ";\n";
+        } else if (opts.batch) {
+            source += indent + "out[" + (k == 0 ? "" : std::to_string(k) + " * n + ") + "i] = " + results[k] + ";\n";
+        } else {
+            source += indent + "out[" + std::to_string(k) + "] = " + results[k] + ";\n";
+        }
+    }
+
+    if (opts.batch) {
+        source += "    }\n";
+    }
+
+    return source + "}\n";
+}
+
+auto CodeGenVisitor::GetOpts() const -> const CodeGenOpts&
+{
+    return opts;
+}
+
+auto CompileNative(const std::string& source, const std::string& functionName, const NativeCompileOpts& opts) -> std::expected<NativeFunction, std::string>
+{
+#ifdef OASIS_HAS_DLOPEN
+    const bool cpp = opts.language == CodeGenOpts::Language::Cpp;
+
+    std::string compiler = opts.compiler;
+    if (compiler.empty()) {
+        const char* fromEnvironment = std::getenv(cpp ? "CXX" : "CC");
+        compiler = fromEnvironment != nullptr ? fromEnvironment : (cpp ? "c++" : "cc");
+    }
+
+    std::string directoryTemplate = (std::filesystem::temp_directory_path() / "oasis-XXXXXX").string();
+    if (mkdtemp(directoryTemplate.data()) == nullptr) {
+        return std::unexpected { "Could not create a directory to compile in." };
+    }
+
+    const std::filesystem::path directory = directoryTemplate;
+    const std::filesystem::path sourcePath = directory / (cpp ? "function.cpp" : "function.c");
+    const std::filesystem::path libraryPath = directory / "function.so";
+
+    // The library stays mapped once loaded, so the directory is removed however this returns.
+    const auto removeDirectory = [&directory] {
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+    };
+
+    std::ofstream { sourcePath } << source;
+
+    std::string command = "\"" + compiler + "\" -shared -fPIC";
+    for (const std::string& flag : opts.flags) {
+        command += " " + flag;
+    }
+    command += " -o \"" + libraryPath.string() + "\" \"" + sourcePath.string() + "\"";
+
+    if (std::system(command.c_str()) != 0) {
+        removeDirectory();
+        return std::unexpected { "Could not compile with " + compiler + "." };
+    }
+
+    void* handle = dlopen(libraryPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+    removeDirectory();
+
+    if (handle == nullptr) {
+        return std::unexpected { std::string { "Could not load the compiled library: " } + dlerror() };
+    }
+
+    NativeFunction function;
+    function.library = std::shared_ptr<void> { handle, [](void* library) { dlclose(library); } };
+    function.symbol = dlsym(handle, functionName.c_str());
+
+    if (function.symbol == nullptr) {
+        return std::unexpected { "Could not find " + functionName + " in the compiled library." };
+    }
+
+    return function;
+#else
+    return std::unexpected { "Loading compiled code is not supported on this platform." };
+#endif
+}
+
+} // Oasis
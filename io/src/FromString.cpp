@@ -62,10 +62,10 @@ auto processOp(std::stack<std::variant<Operator, Function, OpenParens>>& ops, st
         return std::unexpected { "Invalid number of operands" };
     }
 
-    const std::unique_ptr<Oasis::Expression> right = std::move(st.top());
+    std::unique_ptr<Oasis::Expression> right = std::move(st.top());
     st.pop();
 
-    const std::unique_ptr<Oasis::Expression> left = std::move(st.top());
+    std::unique_ptr<Oasis::Expression> left = std::move(st.top());
     st.pop();
 
     const auto topOp = ops.top();
@@ -76,19 +76,19 @@ auto processOp(std::stack<std::variant<Operator, Function, OpenParens>>& ops, st
 
     switch (op) {
     case Operator::Add:
-        opExp = Oasis::Add { *left, *right }.Copy();
+        opExp = std::make_unique<Oasis::Add<>>(std::move(left), std::move(right));
         break;
     case Operator::Subtract:
-        opExp = Oasis::Subtract { *left, *right }.Copy();
+        opExp = std::make_unique<Oasis::Subtract<>>(std::move(left), std::move(right));
         break;
     case Operator::Multiply:
-        opExp = Oasis::Multiply { *left, *right }.Copy();
+        opExp = std::make_unique<Oasis::Multiply<>>(std::move(left), std::move(right));
         break;
     case Operator::Divide:
-        opExp = Oasis::Divide { *left, *right }.Copy();
+        opExp = std::make_unique<Oasis::Divide<>>(std::move(left), std::move(right));
         break;
     case Operator::Exponent:
-        opExp = Oasis::Exponent { *left, *right }.Copy();
+        opExp = std::make_unique<Oasis::Exponent<>>(std::move(left), std::move(right));
         break;
     default:
         return std::unexpected { "Invalid operator" };
@@ -105,17 +105,17 @@ auto processFunction(std::stack<std::unique_ptr<Oasis::Expression>>& st, const F
     }
 
     // If we have a function active, the second operand has just been pushed onto the stack
-    const auto second_operand = std::move(st.top());
+    auto second_operand = std::move(st.top());
     st.pop();
-    const auto first_operand = std::move(st.top());
+    auto first_operand = std::move(st.top());
     st.pop();
 
     if (function_token == Function::Log)
-        return Oasis::Log { *first_operand, *second_operand }.Copy();
+        return std::make_unique<Oasis::Log<>>(std::move(first_operand), std::move(second_operand));
     if (function_token == Function::Derivative)
-        return Oasis::Derivative { *first_operand, *second_operand }.Copy();
+        return std::make_unique<Oasis::Derivative<>>(std::move(first_operand), std::move(second_operand));
     if (function_token == Function::Integral)
-        return Oasis::Integral { *first_operand, *second_operand }.Copy();
+        return std::make_unique<Oasis::Integral<>>(std::move(first_operand), std::move(second_operand));
 
     return std::unexpected { "Invalid function" };
 }
@@ -0,0 +1,157 @@
+#include <array>
+#include <cmath>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/CodeGenVisitor.hpp"
+#include "Oasis/EvaluateVisitor.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/Imaginary.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Negate.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/Sine.hpp"
+#include "Oasis/Subtract.hpp"
+#include "Oasis/Variable.hpp"
+
+TEST_CASE("Code Generation Uses Horner Form", "[CodeGen]")
+{
+    const Oasis::Variable x { "x" };
+
+    // 3x^2 + 2x + 1
+    const Oasis::Add polynomial {
+        Oasis::Add {
+            Oasis::Multiply { Oasis::Real { 3.0 }, Oasis::Exponent { x, Oasis::Real { 2.0 } } },
+            Oasis::Multiply { Oasis::Real { 2.0 }, x } },
+        Oasis::Real { 1.0 }
+    };
+
+    Oasis::CodeGenVisitor codeGen { { .functionName = "f" } };
+    const auto source = polynomial.Accept(codeGen);
+
+    REQUIRE(source.has_value());
+    REQUIRE(source->find("extern \"C\" double f(double x)") != std::string::npos);
+    REQUIRE(source->find("return std::fma(std::fma(3.0, x, 2.0), x, 1.0);") != std::string::npos);
+}
+
+TEST_CASE("Code Generation Hoists Common Subexpressions", "[CodeGen]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Variable y { "y" };
+    const Oasis::Subtract difference { x, y };
+
+    const Oasis::Multiply expression { difference, Oasis::Sine<Oasis::Expression> { difference } };
+
+    Oasis::CodeGenVisitor codeGen { { .language = Oasis::CodeGenOpts::Language::C, .functionName = "f", .variables = { "y", "x" }, .batch = true } };
+    const auto source = expression.Accept(codeGen);
+
+    REQUIRE(source.has_value());
+    REQUIRE(source->find("void f(size_t n, const double* restrict in_y, const double* restrict in_x, double* restrict out)") != std::string::npos);
+    REQUIRE(source->find("const double oasis_t0 = (x - y);") != std::string::npos);
+    REQUIRE(source->find("out[i] = (oasis_t0 * sin(oasis_t0));") != std::string::npos);
+}
+
+TEST_CASE("Code Generation Fails For Unsupported Expressions", "[CodeGen]")
+{
+    const Oasis::Variable x { "x" };
+
+    Oasis::CodeGenVisitor codeGen { { .variables = { "x" } } };
+
+    const auto missing = Oasis::Add { x, Oasis::Variable { "y" } }.Accept(codeGen);
+    REQUIRE_FALSE(missing.has_value());
+    REQUIRE(missing.error() == "Variable y is not a parameter of the function.");
+
+    REQUIRE_FALSE(Oasis::Multiply { x, Oasis::Imaginary {} }.Accept(codeGen).has_value());
+
+    // Names that would not compile as parameters
+    Oasis::CodeGenVisitor cCodeGen { { .language = Oasis::CodeGenOpts::Language::C } };
+    REQUIRE_FALSE(Oasis::Variable { "int" }.Accept(cCodeGen).has_value());
+    REQUIRE_FALSE(Oasis::Sine<Oasis::Expression> { Oasis::Variable { "sin" } }.Accept(cCodeGen).has_value());
+    REQUIRE_FALSE(Oasis::Variable { "NAN" }.Accept(cCodeGen).has_value());
+    REQUIRE(Oasis::Variable { "sine" }.Accept(cCodeGen).has_value());
+}
+
+TEST_CASE("Code Generation Parenthesizes Negations", "[CodeGen]")
+{
+    Oasis::CodeGenVisitor codeGen { { .functionName = "f" } };
+
+    const auto source = Oasis::Negate { Oasis::Real { -0.0 } }.Accept(codeGen);
+    REQUIRE(source.has_value());
+    REQUIRE(source->find("return -((-0.0));") != std::string::npos);
+}
+
+TEST_CASE("Code Generation Negates Fused Operands", "[CodeGen]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Variable y { "y" };
+    const Oasis::Variable z { "z" };
+
+    Oasis::CodeGenVisitor codeGen { { .functionName = "f", .variables = { "x", "y", "z" } } };
+
+    // xy - (-z)
+    const auto negatedAddend = Oasis::Subtract { Oasis::Multiply { x, y }, Oasis::Negate { z } }.Accept(codeGen);
+    REQUIRE(negatedAddend.has_value());
+    REQUIRE(negatedAddend->find("return std::fma(x, y, -(-(z)));") != std::string::npos);
+
+    // z - (-x)y
+    const auto negatedProduct = Oasis::Subtract { z, Oasis::Multiply { Oasis::Negate { x }, y } }.Accept(codeGen);
+    REQUIRE(negatedProduct.has_value());
+    REQUIRE(negatedProduct->find("return std::fma(-(-(x)), y, z);") != std::string::npos);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_CASE("Generated Code Compiles And Loads", "[CodeGen]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Variable y { "y" };
+
+    const Oasis::Add expression {
+        Oasis::Multiply { x, Oasis::Exponent { y, Oasis::Real { 3.0 } } },
+        Oasis::Sine<Oasis::Expression> { Oasis::Subtract { x, y } }
+    };
+
+    Oasis::CodeGenVisitor codeGen { { .functionName = "f", .variables = { "x", "y" } } };
+    const auto source = expression.Accept(codeGen);
+    REQUIRE(source.has_value());
+
+    const auto native = Oasis::CompileNative(*source, "f", { .flags = { "-O2" } });
+    if (!native) {
+        SKIP("No compiler is available: " << native.error());
+    }
+
+    const auto f = native->Get<double(double, double)>();
+    for (const auto& [xValue, yValue] : std::array { std::array { 0.5, 2.0 }, std::array { -3.0, 1.25 } }) {
+        const auto expected = Oasis::Evaluate(expression, Oasis::VariableBindings {}.Bind("x", xValue).Bind("y", yValue));
+        REQUIRE(std::abs(f(xValue, yValue) - expected.value()) < 1e-12);
+    }
+}
+
+TEST_CASE("Generated Negated Fused Operands Compile And Load", "[CodeGen]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Variable y { "y" };
+    const Oasis::Variable z { "z" };
+
+    // xy - (-z) + (z - (-x)y)
+    const Oasis::Add expression {
+        Oasis::Subtract { Oasis::Multiply { x, y }, Oasis::Negate { z } },
+        Oasis::Subtract { z, Oasis::Multiply { Oasis::Negate { x }, y } }
+    };
+
+    Oasis::CodeGenVisitor codeGen { { .functionName = "f", .variables = { "x", "y", "z" } } };
+    const auto source = expression.Accept(codeGen);
+    REQUIRE(source.has_value());
+
+    const auto native = Oasis::CompileNative(*source, "f", { .flags = { "-O2" } });
+    if (!native) {
+        SKIP("No compiler is available: " << native.error());
+    }
+
+    const auto f = native->Get<double(double, double, double)>();
+    for (const auto& [xValue, yValue, zValue] : std::array { std::array { 2.0, 3.0, 5.0 }, std::array { -1.5, 0.25, 4.0 } }) {
+        const auto expected = Oasis::Evaluate(expression, Oasis::VariableBindings {}.Bind("x", xValue).Bind("y", yValue).Bind("z", zValue));
+        REQUIRE(std::abs(f(xValue, yValue, zValue) - expected.value()) < 1e-12);
+    }
+}
+#endif
@@ -4,6 +4,7 @@
 #include <unordered_map>
 
 #include "Oasis/Add.hpp"
+#include "Oasis/CancellationToken.hpp"
 #include "Oasis/Exponent.hpp"
 #include "Oasis/Imaginary.hpp"
 #include "Oasis/Integral.hpp"
@@ -18,6 +19,10 @@
 namespace Oasis {
 auto Add<Expression>::Integrate(const Expression& integrationVariable) const -> std::unique_ptr<Expression>
 {
+    if (CheckCancellation()) {
+        return Integral<Expression> { *this, integrationVariable }.Generalize();
+    }
+
     // Single integration variable
     SimplifyVisitor simplifyVisitor;
     if (auto variable = RecursiveCast<Variable>(integrationVariable); variable != nullptr) {
@@ -0,0 +1,117 @@
+#include "Oasis/CancellationToken.hpp"
+
+namespace {
+thread_local Oasis::CancellationToken* currentToken = nullptr;
+}
+
+namespace Oasis {
+
+auto CancellationToken::SetDeadline(Clock::time_point time) -> void
+{
+    deadline = time;
+}
+
+auto CancellationToken::SetTimeout(Clock::duration timeout) -> void
+{
+    deadline = Clock::now() + timeout;
+}
+
+auto CancellationToken::SetVisitBudget(std::uint64_t budget) -> void
+{
+    visitBudget = budget;
+}
+
+auto CancellationToken::SetMemoryBudget(std::size_t bytes) -> void
+{
+    memoryBudget = bytes;
+}
+
+auto CancellationToken::Cancel() -> void
+{
+    Expire(CancellationReason::Cancelled);
+}
+
+auto CancellationToken::Visit() -> bool
+{
+    const auto visited = visits.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    if (IsCancelled()) {
+        return true;
+    }
+    if (visited > visitBudget) {
+        return Expire(CancellationReason::VisitBudgetExceeded);
+    }
+    if (bytesAllocated.load(std::memory_order_relaxed) > memoryBudget) {
+        return Expire(CancellationReason::MemoryBudgetExceeded);
+    }
+    if (deadline != Clock::time_point::max() && Clock::now() >= deadline) {
+        return Expire(CancellationReason::DeadlineExceeded);
+    }
+
+    return false;
+}
+
+auto CancellationToken::Allocate(std::size_t bytes) -> void
+{
+    bytesAllocated.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+auto CancellationToken::IsCancelled() const -> bool
+{
+    return reason.load(std::memory_order_relaxed) != 0;
+}
+
+auto CancellationToken::GetReason() const -> std::optional<CancellationReason>
+{
+    const auto expiredReason = reason.load(std::memory_order_relaxed);
+    if (expiredReason == 0) {
+        return std::nullopt;
+    }
+    return static_cast<CancellationReason>(expiredReason);
+}
+
+auto CancellationToken::GetVisits() const -> std::uint64_t
+{
+    return visits.load(std::memory_order_relaxed);
+}
+
+auto CancellationToken::GetBytesAllocated() const -> std::size_t
+{
+    return bytesAllocated.load(std::memory_order_relaxed);
+}
+
+auto CancellationToken::Current() -> CancellationToken*
+{
+    return currentToken;
+}
+
+auto CancellationToken::Expire(CancellationReason expiredReason) -> bool
+{
+    // The first reason a token expired for is kept.
+    std::uint8_t none = 0;
+    reason.compare_exchange_strong(none, static_cast<std::uint8_t>(expiredReason), std::memory_order_relaxed);
+    return true;
+}
+
+CancellationScope::CancellationScope(CancellationToken& token)
+    : CancellationScope(&token)
+{
+}
+
+CancellationScope::CancellationScope(CancellationToken* token)
+    : previous(currentToken)
+{
+    currentToken = token;
+}
+
+CancellationScope::~CancellationScope()
+{
+    currentToken = previous;
+}
+
+auto CheckCancellation() -> bool
+{
+    return currentToken != nullptr && currentToken->Visit();
+}
+
+} // Oasis
@@ -0,0 +1,480 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <unordered_map>
+
+#include "Oasis/CompiledExpression.hpp"
+#include "Oasis/Expression.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/Variable.hpp"
+
+namespace Oasis {
+
+namespace {
+
+using Instruction = CompiledExpression::Instruction;
+using OpCode = CompiledExpression::OpCode;
+
+// Larger integer powers are left to std::pow, which takes constant time.
+constexpr double MAX_REDUCED_POWER = 64.0;
+
+auto GetOperandCount(OpCode op) -> std::size_t
+{
+    switch (op) {
+    case OpCode::Constant:
+    case OpCode::Variable:
+        return 0;
+    case OpCode::Add:
+    case OpCode::Subtract:
+    case OpCode::Multiply:
+    case OpCode::Divide:
+    case OpCode::Power:
+    case OpCode::Log:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+auto IntegerPower(double base, double power) -> double
+{
+    const bool reciprocal = power < 0.0;
+    auto remaining = static_cast<std::uint64_t>(std::abs(power));
+
+    double result = 1.0;
+    while (remaining != 0) {
+        if (remaining & 1) {
+            result *= base;
+        }
+        base *= base;
+        remaining >>= 1;
+    }
+
+    return reciprocal ? 1.0 / result : result;
+}
+
+inline auto Execute(const Instruction& instruction, std::span<const double> values, double* registers) -> void
+{
+    switch (instruction.op) {
+    case OpCode::Constant:
+        registers[instruction.result] = instruction.immediate;
+        break;
+    case OpCode::Variable:
+        registers[instruction.result] = values[instruction.first];
+        break;
+    case OpCode::Add:
+        registers[instruction.result] = registers[instruction.first] + registers[instruction.second];
+        break;
+    case OpCode::Subtract:
+        registers[instruction.result] = registers[instruction.first] - registers[instruction.second];
+        break;
+    case OpCode::Multiply:
+        registers[instruction.result] = registers[instruction.first] * registers[instruction.second];
+        break;
+    case OpCode::Divide:
+        registers[instruction.result] = registers[instruction.first] / registers[instruction.second];
+        break;
+    case OpCode::Negate:
+        registers[instruction.result] = -registers[instruction.first];
+        break;
+    case OpCode::Sqrt:
+        registers[instruction.result] = std::sqrt(registers[instruction.first]);
+        break;
+    case OpCode::IntegerPower:
+        registers[instruction.result] = IntegerPower(registers[instruction.first], instruction.immediate);
+        break;
+    case OpCode::Power:
+        registers[instruction.result] = std::pow(registers[instruction.first], registers[instruction.second]);
+        break;
+    case OpCode::Exp:
+        registers[instruction.result] = std::exp(registers[instruction.first]);
+        break;
+    case OpCode::Log:
+        registers[instruction.result] = std::log(registers[instruction.second]) / std::log(registers[instruction.first]);
+        break;
+    case OpCode::NaturalLog:
+        registers[instruction.result] = std::log(registers[instruction.first]);
+        break;
+    case OpCode::Sine:
+        registers[instruction.result] = std::sin(registers[instruction.first]);
+        break;
+    case OpCode::Abs:
+        registers[instruction.result] = std::abs(registers[instruction.first]);
+        break;
+    }
+}
+
+// Emits instructions in static single assignment form, where every instruction writes a register
+// of its own, numbered by its position. Registers are assigned once the program is complete.
+class Compiler {
+public:
+    explicit Compiler(std::span<const SymbolId> variables)
+        : variables(variables)
+    {
+    }
+
+    auto Emit(const Expression& expression) -> std::expected<std::uint32_t, std::string>
+    {
+        if (const auto it = emitted.find(&expression); it != emitted.end()) {
+            return it->second;
+        }
+
+        auto value = EmitUncached(expression);
+        if (value) {
+            emitted.emplace(&expression, *value);
+        }
+        return value;
+    }
+
+    std::vector<Instruction> code;
+
+private:
+    auto EmitUncached(const Expression& expression) -> std::expected<std::uint32_t, std::string>
+    {
+        switch (expression.GetType()) {
+        case ExpressionType::None:
+            return Constant(std::numeric_limits<double>::quiet_NaN());
+        case ExpressionType::Real:
+            return Constant(static_cast<const Real&>(expression).GetValue());
+        case ExpressionType::Pi:
+            return Constant(std::numbers::pi);
+        case ExpressionType::EulerNumber:
+            return Constant(std::numbers::e);
+        case ExpressionType::Variable: {
+            const auto& variable = static_cast<const Variable&>(expression);
+            const auto it = std::ranges::find(variables, variable.GetSymbol());
+            if (it == variables.end()) {
+                return std::unexpected { "Variable " + variable.GetName() + " is not in the variable order." };
+            }
+            return Push({ .op = OpCode::Variable, .first = static_cast<std::uint32_t>(it - variables.begin()) });
+        }
+        case ExpressionType::Add:
+            return EmitBinary(expression, OpCode::Add);
+        case ExpressionType::Subtract:
+            return EmitBinary(expression, OpCode::Subtract);
+        case ExpressionType::Multiply:
+            return EmitBinary(expression, OpCode::Multiply);
+        case ExpressionType::Divide:
+            return EmitBinary(expression, OpCode::Divide);
+        case ExpressionType::Negate:
+            return EmitUnary(expression, OpCode::Negate);
+        case ExpressionType::Sine:
+            return EmitUnary(expression, OpCode::Sine);
+        case ExpressionType::Magnitude:
+            return EmitUnary(expression, OpCode::Abs);
+        case ExpressionType::Exponent:
+            return EmitExponent(expression);
+        case ExpressionType::Log:
+            return EmitLog(expression);
+        default:
+            return std::unexpected { "Expression cannot be evaluated to a real number." };
+        }
+    }
+
+    auto EmitOperand(const Expression& expression, std::size_t index) -> std::expected<std::uint32_t, std::string>
+    {
+        const Expression* operand = expression.GetOperandAt(index);
+        if (operand == nullptr) {
+            return std::unexpected { "Missing operand." };
+        }
+        return Emit(*operand);
+    }
+
+    auto EmitUnary(const Expression& expression, OpCode op) -> std::expected<std::uint32_t, std::string>
+    {
+        return EmitOperand(expression, 0).transform([this, op](std::uint32_t operand) {
+            return Push({ .op = op, .first = operand });
+        });
+    }
+
+    auto EmitBinary(const Expression& expression, OpCode op) -> std::expected<std::uint32_t, std::string>
+    {
+        const auto mostSigOp = EmitOperand(expression, 0);
+        if (!mostSigOp) {
+            return mostSigOp;
+        }
+        return EmitOperand(expression, 1).transform([this, op, &mostSigOp](std::uint32_t leastSigOp) {
+            return Push({ .op = op, .first = *mostSigOp, .second = leastSigOp });
+        });
+    }
+
+    auto EmitExponent(const Expression& exponent) -> std::expected<std::uint32_t, std::string>
+    {
+        const auto base = EmitOperand(exponent, 0);
+        if (!base) {
+            return base;
+        }
+        const auto power = EmitOperand(exponent, 1);
+        if (!power) {
+            return power;
+        }
+
+        if (IsConstant(*base) && code[*base].immediate == std::numbers::e) {
+            return Push({ .op = OpCode::Exp, .first = *power });
+        }
+
+        if (!IsConstant(*power)) {
+            return Push({ .op = OpCode::Power, .first = *base, .second = *power });
+        }
+
+        const double value = code[*power].immediate;
+        if (value == 0.0) {
+            return Constant(1.0);
+        }
+        if (value == 1.0) {
+            return *base;
+        }
+        if (value == 2.0) {
+            return Push({ .op = OpCode::Multiply, .first = *base, .second = *base });
+        }
+        if (value == 0.5) {
+            return Push({ .op = OpCode::Sqrt, .first = *base });
+        }
+        if (value == -1.0) {
+            return Push({ .op = OpCode::Divide, .first = Constant(1.0), .second = *base });
+        }
+        if (std::trunc(value) == value && std::abs(value) <= MAX_REDUCED_POWER) {
+            return Push({ .op = OpCode::IntegerPower, .first = *base, .immediate = value });
+        }
+        return Push({ .op = OpCode::Power, .first = *base, .second = *power });
+    }
+
+    auto EmitLog(const Expression& log) -> std::expected<std::uint32_t, std::string>
+    {
+        const auto base = EmitOperand(log, 0);
+        if (!base) {
+            return base;
+        }
+        const auto argument = EmitOperand(log, 1);
+        if (!argument) {
+            return argument;
+        }
+
+        if (!IsConstant(*base)) {
+            return Push({ .op = OpCode::Log, .first = *base, .second = *argument });
+        }
+
+        // A logarithm in a constant base is a natural logarithm scaled by a constant
+        const auto naturalLog = Push({ .op = OpCode::NaturalLog, .first = *argument });
+        if (code[*base].immediate == std::numbers::e) {
+            return naturalLog;
+        }
+        return Push({ .op = OpCode::Multiply, .first = naturalLog, .second = Constant(1.0 / std::log(code[*base].immediate)) });
+    }
+
+    auto IsConstant(std::uint32_t value) const -> bool
+    {
+        return code[value].op == OpCode::Constant;
+    }
+
+    auto Constant(double value) -> std::uint32_t
+    {
+        return Push({ .op = OpCode::Constant, .immediate = value });
+    }
+
+    // Pushes an instruction, folding it into a constant if every operand is constant.
+    auto Push(Instruction instruction) -> std::uint32_t
+    {
+        const std::size_t operandCount = GetOperandCount(instruction.op);
+        const bool foldable = operandCount > 0 && IsConstant(instruction.first) && (operandCount == 1 || IsConstant(instruction.second));
+
+        if (foldable) {
+            double registers[] = { code[instruction.first].immediate, operandCount == 2 ? code[instruction.second].immediate : 0.0, 0.0 };
+            Execute({ .op = instruction.op, .result = 2, .first = 0, .second = 1, .immediate = instruction.immediate }, {}, registers);
+            instruction = { .op = OpCode::Constant, .immediate = registers[2] };
+        }
+
+        instruction.result = static_cast<std::uint32_t>(code.size());
+        code.push_back(instruction);
+        return instruction.result;
+    }
+
+    std::span<const SymbolId> variables;
+    std::unordered_map<const Expression*, std::uint32_t, ExpressionHash, ExpressionEqual> emitted;
+};
+
+}
+
+auto CompiledExpression::Evaluate(std::span<const double> values, std::span<double> registers) const -> double
+{
+    double* const data = registers.data();
+
+    for (const Instruction& instruction : instructions) {
+        Execute(instruction, values, data);
+    }
+
+    return data[resultRegister];
+}
+
+auto CompiledExpression::Evaluate(std::span<const double> values) const -> double
+{
+    thread_local std::vector<double> registers;
+
+    if (registers.size() < registerCount) {
+        registers.resize(registerCount);
+    }
+
+    return Evaluate(values, registers);
+}
+
+auto CompiledExpression::GetInstructions() const -> std::span<const Instruction>
+{
+    return instructions;
+}
+
+auto CompiledExpression::GetStage(std::size_t variable) const -> std::span<const Instruction>
+{
+    const std::size_t begin = variable == 0 ? 0 : stageEnds[variable - 1];
+    return std::span { instructions }.subspan(begin, stageEnds[variable] - begin);
+}
+
+auto CompiledExpression::GetStageCount() const -> std::size_t
+{
+    return stageEnds.size();
+}
+
+auto CompiledExpression::GetRegisterCount() const -> std::size_t
+{
+    return registerCount;
+}
+
+auto CompiledExpression::GetVariables() const -> std::span<const SymbolId>
+{
+    return variables;
+}
+
+auto CompiledExpression::GetResultRegister() const -> std::uint32_t
+{
+    return resultRegister;
+}
+
+auto Compile(const Expression& expression, std::span<const SymbolId> variables) -> std::expected<CompiledExpression, std::string>
+{
+    Compiler compiler { variables };
+
+    const auto root = compiler.Emit(expression);
+    if (!root) {
+        return std::unexpected { root.error() };
+    }
+
+    const std::vector<Instruction>& code = compiler.code;
+
+    // Folding leaves behind the constants that were folded, so only instructions that the root
+    // depends on are kept.
+    std::vector<bool> live(code.size());
+    live[*root] = true;
+
+    for (std::size_t i = code.size(); i-- > 0;) {
+        const std::size_t operandCount = GetOperandCount(code[i].op);
+        if (live[i] && operandCount >= 1) {
+            live[code[i].first] = true;
+        }
+        if (live[i] && operandCount == 2) {
+            live[code[i].second] = true;
+        }
+    }
+
+    // The stage of an instruction is the index of the last variable it depends on. An operand is
+    // never in a later stage than its users, so instructions stay valid when ordered by stage.
+    std::vector<std::size_t> stageOf(code.size());
+
+    for (std::size_t i = 0; i < code.size(); ++i) {
+        const std::size_t operandCount = GetOperandCount(code[i].op);
+        if (code[i].op == OpCode::Variable) {
+            stageOf[i] = code[i].first;
+        }
+        if (operandCount >= 1) {
+            stageOf[i] = stageOf[code[i].first];
+        }
+        if (operandCount == 2) {
+            stageOf[i] = std::max(stageOf[i], stageOf[code[i].second]);
+        }
+    }
+
+    CompiledExpression compiled;
+    compiled.variables.assign(variables.begin(), variables.end());
+    compiled.stageEnds.resize(std::max<std::size_t>(variables.size(), 1));
+
+    std::vector<std::uint32_t> order;
+    for (std::size_t stage = 0; stage < compiled.stageEnds.size(); ++stage) {
+        for (std::size_t i = 0; i < code.size(); ++i) {
+            if (live[i] && stageOf[i] == stage) {
+                order.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+        compiled.stageEnds[stage] = order.size();
+    }
+
+    // The position of the last instruction to read each value, after which its register may be
+    // reused. Values read by a later stage are kept until the end, since a later stage may be
+    // rerun without rerunning the stage that computed them.
+    std::vector<std::size_t> lastUse(code.size());
+    lastUse[*root] = order.size();
+
+    for (std::size_t position = 0; position < order.size(); ++position) {
+        const std::uint32_t i = order[position];
+        const auto use = [&](std::uint32_t operand) {
+            lastUse[operand] = std::max(lastUse[operand], stageOf[operand] < stageOf[i] ? order.size() : position);
+        };
+
+        const std::size_t operandCount = GetOperandCount(code[i].op);
+        if (operandCount >= 1) {
+            use(code[i].first);
+        }
+        if (operandCount == 2) {
+            use(code[i].second);
+        }
+    }
+
+    std::vector<std::uint32_t> registerOf(code.size());
+    std::vector<std::uint32_t> freeRegisters;
+
+    for (std::size_t position = 0; position < order.size(); ++position) {
+        const std::uint32_t i = order[position];
+        Instruction instruction = code[i];
+        const std::size_t operandCount = GetOperandCount(instruction.op);
+
+        // Operands are read before the result is written, so an instruction may write to the
+        // register of an operand it is the last to read.
+        if (operandCount >= 1) {
+            instruction.first = registerOf[code[i].first];
+            if (lastUse[code[i].first] == position) {
+                freeRegisters.push_back(instruction.first);
+            }
+        }
+        if (operandCount == 2) {
+            instruction.second = registerOf[code[i].second];
+            if (lastUse[code[i].second] == position && code[i].second != code[i].first) {
+                freeRegisters.push_back(instruction.second);
+            }
+        }
+
+        if (freeRegisters.empty()) {
+            instruction.result = static_cast<std::uint32_t>(compiled.registerCount++);
+        } else {
+            instruction.result = freeRegisters.back();
+            freeRegisters.pop_back();
+        }
+
+        registerOf[i] = instruction.result;
+        compiled.instructions.push_back(instruction);
+    }
+
+    compiled.resultRegister = registerOf[*root];
+    return compiled;
+}
+
+auto Compile(const Expression& expression, std::initializer_list<std::string_view> variables) -> std::expected<CompiledExpression, std::string>
+{
+    std::vector<SymbolId> symbols;
+    symbols.reserve(variables.size());
+
+    for (const std::string_view name : variables) {
+        symbols.push_back(SymbolTable::Global().Intern(name));
+    }
+
+    return Compile(expression, symbols);
+}
+
+} // Oasis
@@ -0,0 +1,94 @@
+#include <algorithm>
+
+#include "Oasis/CompiledExpressionCache.hpp"
+
+namespace Oasis {
+
+CompiledExpressionCache::CompiledExpressionCache(std::size_t capacity)
+    : capacity(capacity)
+{
+}
+
+auto CompiledExpressionCache::Get(const Expression& expression, std::span<const SymbolId> variables) -> std::expected<std::shared_ptr<const CompiledExpression>, std::string>
+{
+    std::uint64_t key = expression.GetHash();
+    for (const SymbolId variable : variables) {
+        key = CombineHash(key, variable);
+    }
+
+    if (auto compiled = Find(key, expression, variables)) {
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return compiled;
+    }
+
+    misses.fetch_add(1, std::memory_order_relaxed);
+
+    auto compiled = Compile(expression, variables);
+    if (!compiled) {
+        return std::unexpected { compiled.error() };
+    }
+
+    // Compiled and copied before locking, so that other threads are not kept waiting.
+    Entry entry { key, expression.Copy(), std::make_shared<const CompiledExpression>(std::move(*compiled)) };
+    auto result = entry.compiled;
+
+    if (capacity == 0) {
+        return result;
+    }
+
+    std::lock_guard lock { mutex };
+
+    // On a collision, the newer entry replaces the older one.
+    if (const auto it = entriesByKey.find(key); it != entriesByKey.end()) {
+        entries.erase(it->second);
+        entriesByKey.erase(it);
+    }
+
+    if (entries.size() == capacity) {
+        entriesByKey.erase(entries.back().key);
+        entries.pop_back();
+    }
+
+    entries.push_front(std::move(entry));
+    entriesByKey.emplace(key, entries.begin());
+
+    return result;
+}
+
+auto CompiledExpressionCache::Clear() -> void
+{
+    std::lock_guard lock { mutex };
+    entries.clear();
+    entriesByKey.clear();
+}
+
+auto CompiledExpressionCache::GetHits() const -> std::size_t
+{
+    return hits.load(std::memory_order_relaxed);
+}
+
+auto CompiledExpressionCache::GetMisses() const -> std::size_t
+{
+    return misses.load(std::memory_order_relaxed);
+}
+
+auto CompiledExpressionCache::Size() const -> std::size_t
+{
+    std::lock_guard lock { mutex };
+    return entries.size();
+}
+
+auto CompiledExpressionCache::Find(std::uint64_t key, const Expression& expression, std::span<const SymbolId> variables) -> std::shared_ptr<const CompiledExpression>
+{
+    std::lock_guard lock { mutex };
+
+    const auto it = entriesByKey.find(key);
+    if (it == entriesByKey.end() || !std::ranges::equal(it->second->compiled->GetVariables(), variables) || !it->second->expression->Equals(expression)) {
+        return nullptr;
+    }
+
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->compiled;
+}
+
+} // Oasis
@@ -22,4 +22,9 @@ Derivative<Expression>::Derivative(const Expression& exp, const Expression& var)
 {
 }
 
+Derivative<Expression>::Derivative(std::unique_ptr<Expression>&& exp, std::unique_ptr<Expression>&& var)
+    : BinaryExpression(std::move(exp), std::move(var))
+{
+}
+
 }
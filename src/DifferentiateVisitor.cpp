@@ -6,6 +6,7 @@
 
 #include "Oasis/Add.hpp"
 #include "Oasis/BinaryExpression.hpp"
+#include "Oasis/CancellationToken.hpp"
 #include "Oasis/Derivative.hpp"
 #include "Oasis/DifferentiateVisitor.hpp"
 #include "Oasis/Divide.hpp"
@@ -42,6 +43,46 @@ DifferentiateVisitor::DifferentiateVisitor(const std::unique_ptr<Expression>& di
     this->opts = opts;
 }
 
+auto DifferentiateVisitor::SetThreadPool(std::shared_ptr<ThreadPool> pool, std::size_t threshold) -> void
+{
+    threadPool = std::move(pool);
+    parallelThreshold = threshold;
+}
+
+auto DifferentiateVisitor::GetThreadPool() const -> std::shared_ptr<ThreadPool>
+{
+    return threadPool;
+}
+
+auto DifferentiateVisitor::DifferentiateOperands(const Expression& mostSigOp, const Expression& leastSigOp) -> std::pair<RetT, RetT>
+{
+    // Only the first few levels of a tree are split, which already makes enough tasks to keep the
+    // pool busy, so that the size of deeper subexpressions is not counted again and again.
+    constexpr std::size_t maxParallelDepth = 8;
+
+    ++depth;
+    const bool parallel = threadPool && depth <= maxParallelDepth
+        && CountNodes(mostSigOp, parallelThreshold) + CountNodes(leastSigOp, parallelThreshold) >= parallelThreshold;
+
+    std::pair<RetT, RetT> differentiated = [&]() -> std::pair<RetT, RetT> {
+        if (parallel) {
+            DifferentiateVisitor forked { differentiationVariable, opts };
+            forked.SetThreadPool(threadPool, parallelThreshold);
+            forked.depth = depth;
+
+            return threadPool->ParallelInvoke(
+                [this, &mostSigOp] { return mostSigOp.Accept(*this); },
+                [forked = std::move(forked), &leastSigOp]() mutable { return leastSigOp.Accept(forked); });
+        }
+
+        auto differentiatedMostSigOp = mostSigOp.Accept(*this);
+        return { std::move(differentiatedMostSigOp), leastSigOp.Accept(*this) };
+    }();
+
+    --depth;
+    return differentiated;
+}
+
 auto DifferentiateVisitor::TypedVisit(const Real&) -> RetT
 {
     return gsl_lite::not_null { std::make_unique<Real>(0.0) };
@@ -55,7 +96,7 @@ auto DifferentiateVisitor::TypedVisit(const Imaginary&) -> RetT
 auto DifferentiateVisitor::TypedVisit(const Variable& var) -> RetT
 {
     if (auto variable = RecursiveCast<Variable>(*(this->differentiationVariable)); variable != nullptr) {
-        if (variable->GetName() == var.GetName()) {
+        if (variable->GetSymbol() == var.GetSymbol()) {
             return gsl_lite::not_null { std::make_unique<Real>(1.0) };
         } else if (this->opts.multivariate == DifferentiationOpts::Multivariate::MULTI_VARIABLE) {
             return gsl_lite::not_null { std::make_unique<Derivative<Expression, Expression>>(var, *this->differentiationVariable) };
@@ -73,61 +114,64 @@ auto DifferentiateVisitor::TypedVisit(const Undefined&) -> RetT
 
 auto DifferentiateVisitor::TypedVisit(const Add<Expression, Expression>& add) -> RetT
 {
+    if (CheckCancellation()) {
+        return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(add.Copy(), this->differentiationVariable->Copy()));
+    }
+
     if (auto variable = RecursiveCast<Variable>(*(this->differentiationVariable)); variable != nullptr) {
-        auto diffedleft = add.mostSigOp->Accept(*this);
-        auto diffedright = add.leastSigOp->Accept(*this);
+        auto [diffedleft, diffedright] = DifferentiateOperands(*add.mostSigOp, *add.leastSigOp);
 
         if (!diffedleft) {
             return std::unexpected { diffedleft.error() };
         }
-        if (!diffedleft) {
-            return std::unexpected { diffedleft.error() };
+        if (!diffedright) {
+            return std::unexpected { diffedright.error() };
         }
 
-        auto left = std::move(diffedleft).value();
-        auto right = std::move(diffedright).value();
-
         SimplifyVisitor simplifyVisitor {};
-        auto simplified = Add<Expression> { *left, *right }.Accept(simplifyVisitor);
+        auto simplified = Add<Expression> { std::move(diffedleft).value(), std::move(diffedright).value() }.Accept(simplifyVisitor);
         if (!simplified) {
             return std::unexpected { simplified.error() };
         }
         return std::move(simplified).value();
     }
-    return gsl_lite::not_null<std::unique_ptr<Expression>>(Oasis::Derivative<Expression> { *(add.Copy()), *(this->differentiationVariable) }.Generalize());
+    return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(add.Copy(), this->differentiationVariable->Copy()));
 }
 
 auto DifferentiateVisitor::TypedVisit(const Subtract<Expression, Expression>& subtract) -> RetT
 {
+    if (CheckCancellation()) {
+        return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(subtract.Copy(), this->differentiationVariable->Copy()));
+    }
+
     if (auto variable = RecursiveCast<Variable>(*(this->differentiationVariable)); variable != nullptr) {
-        auto diffedleft = subtract.mostSigOp->Accept(*this);
-        auto diffedright = subtract.leastSigOp->Accept(*this);
+        auto [diffedleft, diffedright] = DifferentiateOperands(*subtract.mostSigOp, *subtract.leastSigOp);
 
         if (!diffedleft) {
             return std::unexpected { diffedleft.error() };
         }
-        if (!diffedleft) {
-            return std::unexpected { diffedleft.error() };
+        if (!diffedright) {
+            return std::unexpected { diffedright.error() };
         }
 
-        auto left = std::move(diffedleft).value();
-        auto right = std::move(diffedright).value();
-
         SimplifyVisitor simplifyVisitor {};
-        auto simplified = Subtract<Expression> { *left, *right }.Accept(simplifyVisitor);
+        auto simplified = Subtract<Expression> { std::move(diffedleft).value(), std::move(diffedright).value() }.Accept(simplifyVisitor);
         if (!simplified) {
             return std::unexpected { simplified.error() };
         }
         return std::move(simplified).value();
     }
-    return gsl_lite::not_null<std::unique_ptr<Expression>>(Oasis::Derivative<Expression> { *(subtract.Copy()), *(this->differentiationVariable) }.Generalize());
+    return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(subtract.Copy(), this->differentiationVariable->Copy()));
 }
 
 auto DifferentiateVisitor::TypedVisit(const Multiply<Expression, Expression>& multiply) -> RetT
 {
+    if (CheckCancellation()) {
+        return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(multiply.Copy(), this->differentiationVariable->Copy()));
+    }
+
     if (auto variable = RecursiveCast<Variable>(*(this->differentiationVariable)); variable != nullptr) {
-        auto diffedleft = multiply.mostSigOp->Accept(*this);
-        auto diffedright = multiply.leastSigOp->Accept(*this);
+        auto [diffedleft, diffedright] = DifferentiateOperands(*multiply.mostSigOp, *multiply.leastSigOp);
         if (!diffedleft) {
             return std::unexpected { diffedleft.error() };
         }
@@ -135,13 +179,13 @@ auto DifferentiateVisitor::TypedVisit(const Multiply<Expression, Expression>& mu
             return std::unexpected { diffedright.error() };
         }
 
-        auto left = std::move(diffedleft).value();
-        auto right = std::move(diffedright).value();
+        std::unique_ptr<Expression> left = std::move(diffedleft).value();
+        std::unique_ptr<Expression> right = std::move(diffedright).value();
 
         SimplifyVisitor simplifyVisitor {};
         auto multiplied = Add<Expression> {
-            Multiply { *left, *multiply.leastSigOp->Copy() },
-            Multiply { *multiply.mostSigOp->Copy(), *right }
+            Multiply<Expression> { std::move(left), multiply.leastSigOp->Copy() },
+            Multiply<Expression> { multiply.mostSigOp->Copy(), std::move(right) }
         }.Accept(simplifyVisitor);
 
         if (!multiplied) {
@@ -149,11 +193,15 @@ auto DifferentiateVisitor::TypedVisit(const Multiply<Expression, Expression>& mu
         }
         return std::move(multiplied).value();
     }
-    return gsl_lite::not_null<std::unique_ptr<Expression>>(Oasis::Derivative<Expression> { *(multiply.Copy()), *(this->differentiationVariable) }.Generalize());
+    return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(multiply.Copy(), this->differentiationVariable->Copy()));
 }
 
 auto DifferentiateVisitor::TypedVisit(const Divide<Expression, Expression>& divide) -> RetT
 {
+    if (CheckCancellation()) {
+        return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(divide.Copy(), this->differentiationVariable->Copy()));
+    }
+
     SimplifyVisitor simplifyVisitor {};
     // Single differentiation variable
     if (auto variable = RecursiveCast<Variable>(*(this->differentiationVariable)); variable != nullptr) {
@@ -193,11 +241,15 @@ auto DifferentiateVisitor::TypedVisit(const Divide<Expression, Expression>& divi
         }
     }
 
-    return gsl_lite::not_null<std::unique_ptr<Expression>>(Oasis::Derivative<Expression> { *(divide.Copy()), *(this->differentiationVariable) }.Generalize());
+    return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(divide.Copy(), this->differentiationVariable->Copy()));
 }
 
 auto DifferentiateVisitor::TypedVisit(const Exponent<Expression, Expression>& exponent) -> RetT
 {
+    if (CheckCancellation()) {
+        return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(exponent.Copy(), this->differentiationVariable->Copy()));
+    }
+
     SimplifyVisitor simplifyVisitor {};
     // Need to check exponential vs polynomial
     if (auto variable = RecursiveCast<Variable>(*(this->differentiationVariable)); variable != nullptr) {
@@ -229,8 +281,7 @@ auto DifferentiateVisitor::TypedVisit(const Exponent<Expression, Expression>& ex
         // d/dx (a^{u(x)}) = a^{u(x)} * ln(a) * u'(x)
         if (auto exponential = RecursiveCast<Exponent<Real, Expression>>(exponent); exponential != nullptr) {
             auto a = exponential->mostSigOp->Copy();
-            auto u = exponential->leastSigOp->Copy();
-            auto uprime = u->Accept(*this);
+            auto uprime = exponential->leastSigOp->Accept(*this);
             if (!uprime) {
                 return std::unexpected { uprime.error() };
             }
@@ -247,24 +298,20 @@ auto DifferentiateVisitor::TypedVisit(const Exponent<Expression, Expression>& ex
             return std::move(simplified).value();
         }
         if (auto exponential_e = RecursiveCast<Exponent<EulerNumber, Expression>>(exponent); exponential_e != nullptr) {
-            auto u = exponential_e->leastSigOp->Copy();
-            auto uprime = u->Accept(*this);
+            auto uprime = exponential_e->leastSigOp->Accept(*this);
 
             if (!uprime) {
                 return std::unexpected { uprime.error() };
             }
-            auto uprime_ = std::move(uprime).value();
-
-            auto simplified = Multiply<Expression> { *exponential_e, *uprime_ }.Accept(simplifyVisitor);
+            auto simplified = Multiply<Expression> { exponential_e->Copy(), std::move(uprime).value() }.Accept(simplifyVisitor);
             if (!simplified) {
                 return std::unexpected { simplified.error() };
             }
             return std::move(simplified).value();
         }
-        if (auto exponential_var = RecursiveCast<Exponent<Variable, Expression>>(exponent); (exponential_var != nullptr) && (exponential_var->mostSigOp->GetName() != variable->GetName())) {
+        if (auto exponential_var = RecursiveCast<Exponent<Variable, Expression>>(exponent); (exponential_var != nullptr) && (exponential_var->mostSigOp->GetSymbol() != variable->GetSymbol())) {
             auto a = exponential_var->mostSigOp->Copy();
-            auto u = exponential_var->leastSigOp->Copy();
-            auto uprime = u->Accept(*this);
+            auto uprime = exponential_var->leastSigOp->Accept(*this);
             if (!uprime) {
                 return std::unexpected { uprime.error() };
             }
@@ -317,11 +364,15 @@ auto DifferentiateVisitor::TypedVisit(const Exponent<Expression, Expression>& ex
 
         return std::move(y).value();
     }
-    return gsl_lite::not_null<std::unique_ptr<Expression>>(Oasis::Derivative<Expression> { *(exponent.Copy()), *(this->differentiationVariable) }.Generalize());
+    return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(exponent.Copy(), this->differentiationVariable->Copy()));
 }
 
 auto DifferentiateVisitor::TypedVisit(const Log<Expression, Expression>& log) -> RetT
 {
+    if (CheckCancellation()) {
+        return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(log.Copy(), this->differentiationVariable->Copy()));
+    }
+
     if (auto variable = RecursiveCast<Variable>(*(this->differentiationVariable)); variable != nullptr) {
         SimplifyVisitor simplifyVisitor {};
         // d(log_e(6x))/dx = 1/6x * 6
@@ -361,28 +412,36 @@ auto DifferentiateVisitor::TypedVisit(const Log<Expression, Expression>& log) ->
             }
         }
     }
-    return gsl_lite::not_null<std::unique_ptr<Expression>>(Oasis::Derivative<Expression> { *(log.Copy()), *(this->differentiationVariable) }.Generalize());
+    return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(log.Copy(), this->differentiationVariable->Copy()));
 }
 
 auto DifferentiateVisitor::TypedVisit(const Negate<Expression>& negate) -> RetT
 {
+    if (CheckCancellation()) {
+        return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(negate.Copy(), this->differentiationVariable->Copy()));
+    }
+
     if (auto variable = RecursiveCast<Variable>(*(this->differentiationVariable)); variable != nullptr) {
         const std::unique_ptr<Expression> operandDerivative = negate.GetOperand().Differentiate(*(this->differentiationVariable));
         return gsl_lite::not_null { Negate<Expression> { *operandDerivative }.Generalize() };
     }
 
-    return gsl_lite::not_null<std::unique_ptr<Expression>>(Oasis::Derivative<Expression> { *(negate.Copy()), *(this->differentiationVariable) }.Generalize());
+    return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(negate.Copy(), this->differentiationVariable->Copy()));
 }
 
 auto DifferentiateVisitor::TypedVisit(const Sine<Expression>& sine) -> RetT
 {
     // TODO: IMPLEMENT
     return std::unexpected<std::string> { "Not Implemented." };
-    return gsl_lite::not_null<std::unique_ptr<Expression>>(Oasis::Derivative<Expression> { *(sine.Copy()), *(this->differentiationVariable) }.Generalize());
+    return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(sine.Copy(), this->differentiationVariable->Copy()));
 }
 
 auto DifferentiateVisitor::TypedVisit(const Derivative<Expression, Expression>& derivative) -> RetT
 {
+    if (CheckCancellation()) {
+        return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(derivative.Copy(), this->differentiationVariable->Copy()));
+    }
+
     if (auto variable = RecursiveCast<Variable>(*(this->differentiationVariable)); variable != nullptr) {
         SimplifyVisitor sv {};
         auto diff = derivative.GetMostSigOp().Accept(*this);
@@ -396,11 +455,15 @@ auto DifferentiateVisitor::TypedVisit(const Derivative<Expression, Expression>&
         }
         return gsl_lite::not_null<std::unique_ptr<Expression>> { std::move(result).value() };
     }
-    return gsl_lite::not_null<std::unique_ptr<Expression>>(Oasis::Derivative<Expression> { *(derivative.Copy()), *(this->differentiationVariable) }.Generalize());
+    return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(derivative.Copy(), this->differentiationVariable->Copy()));
 }
 
 auto DifferentiateVisitor::TypedVisit(const Integral<Expression, Expression>& integral) -> RetT
 {
+    if (CheckCancellation()) {
+        return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(integral.Copy(), this->differentiationVariable->Copy()));
+    }
+
     if (auto variable = RecursiveCast<Variable>(*(this->differentiationVariable)); variable != nullptr) {
         auto integral_simp = integral.GetMostSigOp().Integrate(integral.GetLeastSigOp());
 
@@ -410,14 +473,14 @@ auto DifferentiateVisitor::TypedVisit(const Integral<Expression, Expression>& in
         }
         return gsl_lite::not_null<std::unique_ptr<Expression>> { std::move(result).value() };
     }
-    return gsl_lite::not_null<std::unique_ptr<Expression>>(Oasis::Derivative<Expression> { *(integral.Copy()), *(this->differentiationVariable) }.Generalize());
+    return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(integral.Copy(), this->differentiationVariable->Copy()));
 }
 
 auto DifferentiateVisitor::TypedVisit(const Matrix& matrix) -> RetT
 {
     // TODO: IMPLEMENT
     return std::unexpected<std::string> { "Not Implemented." };
-    return gsl_lite::not_null<std::unique_ptr<Expression>>(Oasis::Derivative<Expression> { *(matrix.Copy()), *(this->differentiationVariable) }.Generalize());
+    return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(matrix.Copy(), this->differentiationVariable->Copy()));
 }
 
 auto DifferentiateVisitor::TypedVisit(const EulerNumber&) -> RetT
@@ -434,7 +497,7 @@ auto DifferentiateVisitor::TypedVisit(const Magnitude<Expression>& magnitude) ->
 {
     // TODO: IMPLEMENT
     return std::unexpected<std::string> { "Not Implemented." };
-    return gsl_lite::not_null<std::unique_ptr<Expression>>(Oasis::Derivative<Expression> { *(magnitude.Copy()), *(this->differentiationVariable) }.Generalize());
+    return gsl_lite::not_null<std::unique_ptr<Expression>>(std::make_unique<Derivative<Expression>>(magnitude.Copy(), this->differentiationVariable->Copy()));
 }
 
 } // Oasis
\ No newline at end of file
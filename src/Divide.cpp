@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "Oasis/Divide.hpp"
+#include "Oasis/CancellationToken.hpp"
 #include "Oasis/Exponent.hpp"
 #include "Oasis/Imaginary.hpp"
 #include "Oasis/Integral.hpp"
@@ -22,8 +23,17 @@ Divide<Expression>::Divide(const Expression& dividend, const Expression& divisor
 {
 }
 
+Divide<Expression>::Divide(std::unique_ptr<Expression>&& dividend, std::unique_ptr<Expression>&& divisor)
+    : BinaryExpression(std::move(dividend), std::move(divisor))
+{
+}
+
 auto Divide<Expression>::Integrate(const Expression& integrationVariable) const -> std::unique_ptr<Expression>
 {
+    if (CheckCancellation()) {
+        return Integral<Expression> { *this, integrationVariable }.Generalize();
+    }
+
     SimplifyVisitor simplifyVisitor {};
     // Single integration variable
     if (auto variable = RecursiveCast<Variable>(integrationVariable); variable != nullptr) {
@@ -0,0 +1,719 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "Oasis/EGraph.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/Derivative.hpp"
+#include "Oasis/Divide.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/Integral.hpp"
+#include "Oasis/Log.hpp"
+#include "Oasis/Magnitude.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Negate.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/Sine.hpp"
+#include "Oasis/Subtract.hpp"
+#include "Oasis/Undefined.hpp"
+
+namespace {
+
+using Oasis::EClassId;
+using Oasis::EGraph;
+using Oasis::ENode;
+using Oasis::ExpressionType;
+
+// Expressions of any other type, such as Matrix, are treated as opaque leaves.
+auto IsOperator(ExpressionType type) -> bool
+{
+    switch (type) {
+    case ExpressionType::Add:
+    case ExpressionType::Subtract:
+    case ExpressionType::Multiply:
+    case ExpressionType::Divide:
+    case ExpressionType::Exponent:
+    case ExpressionType::Log:
+    case ExpressionType::Integral:
+    case ExpressionType::Derivative:
+    case ExpressionType::Negate:
+    case ExpressionType::Magnitude:
+    case ExpressionType::Sine:
+        return true;
+    default:
+        return false;
+    }
+}
+
+auto Build(const ENode& node, std::vector<std::unique_ptr<Oasis::Expression>>&& operands) -> std::unique_ptr<Oasis::Expression>
+{
+    switch (node.type) {
+    case ExpressionType::Add:
+        return std::make_unique<Oasis::Add<>>(std::move(operands[0]), std::move(operands[1]));
+    case ExpressionType::Subtract:
+        return std::make_unique<Oasis::Subtract<>>(std::move(operands[0]), std::move(operands[1]));
+    case ExpressionType::Multiply:
+        return std::make_unique<Oasis::Multiply<>>(std::move(operands[0]), std::move(operands[1]));
+    case ExpressionType::Divide:
+        return std::make_unique<Oasis::Divide<>>(std::move(operands[0]), std::move(operands[1]));
+    case ExpressionType::Exponent:
+        return std::make_unique<Oasis::Exponent<>>(std::move(operands[0]), std::move(operands[1]));
+    case ExpressionType::Log:
+        return std::make_unique<Oasis::Log<>>(std::move(operands[0]), std::move(operands[1]));
+    case ExpressionType::Integral:
+        return std::make_unique<Oasis::Integral<>>(std::move(operands[0]), std::move(operands[1]));
+    case ExpressionType::Derivative:
+        return std::make_unique<Oasis::Derivative<>>(std::move(operands[0]), std::move(operands[1]));
+    case ExpressionType::Negate:
+        return std::make_unique<Oasis::Negate<Oasis::Expression>>(std::move(operands[0]));
+    case ExpressionType::Magnitude:
+        return std::make_unique<Oasis::Magnitude<Oasis::Expression>>(std::move(operands[0]));
+    case ExpressionType::Sine:
+        return std::make_unique<Oasis::Sine<Oasis::Expression>>(std::move(operands[0]));
+    default:
+        return node.leaf ? node.leaf->Copy() : std::make_unique<Oasis::Undefined>();
+    }
+}
+
+auto Commute(EGraph& graph, EClassId eClass, const ENode& node) -> void
+{
+    if (node.type == ExpressionType::Add || node.type == ExpressionType::Multiply) {
+        graph.Merge(eClass, graph.Add(node.type, { node.children[1], node.children[0] }));
+    }
+}
+
+// (a + b) + c = a + (b + c). Together with commutativity, this reaches every grouping.
+auto Associate(EGraph& graph, EClassId eClass, const ENode& node) -> void
+{
+    if (node.type != ExpressionType::Add && node.type != ExpressionType::Multiply) {
+        return;
+    }
+
+    for (const ENode& inner : graph.FindNodes(node.children[0], node.type)) {
+        if (graph.IsFull()) {
+            return;
+        }
+
+        const EClassId right = graph.Add(node.type, { inner.children[1], node.children[1] });
+        graph.Merge(eClass, graph.Add(node.type, { inner.children[0], right }));
+    }
+}
+
+auto FoldConstants(EGraph& graph, EClassId eClass, const ENode& node) -> void
+{
+    if (!IsOperator(node.type) || graph.GetReal(eClass)) {
+        return;
+    }
+
+    std::vector<double> values;
+    for (const EClassId child : node.children) {
+        const auto value = graph.GetReal(child);
+        if (!value) {
+            return;
+        }
+        values.push_back(*value);
+    }
+
+    double result = std::numeric_limits<double>::quiet_NaN();
+
+    switch (node.type) {
+    case ExpressionType::Add:
+        result = values[0] + values[1];
+        break;
+    case ExpressionType::Subtract:
+        result = values[0] - values[1];
+        break;
+    case ExpressionType::Multiply:
+        result = values[0] * values[1];
+        break;
+    case ExpressionType::Divide:
+        result = values[0] / values[1];
+        break;
+    case ExpressionType::Exponent:
+        result = std::pow(values[0], values[1]);
+        break;
+    case ExpressionType::Log:
+        if (values[0] > 0.0 && values[0] != 1.0 && values[1] > 0.0) {
+            result = std::log2(values[1]) / std::log2(values[0]);
+        }
+        break;
+    case ExpressionType::Negate:
+        result = -values[0];
+        break;
+    default:
+        break;
+    }
+
+    // Undefined results, such as division by zero, are left for SimplifyVisitor to report.
+    if (std::isfinite(result)) {
+        graph.Merge(eClass, graph.AddReal(result));
+    }
+}
+
+// a + 0 = a, a * 1 = a, a * 0 = 0, a - 0 = a, a / 1 = a, a^0 = 1, a^1 = a, 1^a = 1
+auto ApplyIdentities(EGraph& graph, EClassId eClass, const ENode& node) -> void
+{
+    if (node.children.size() != 2) {
+        return;
+    }
+
+    const EClassId left = node.children[0];
+    const EClassId right = node.children[1];
+    const auto rightValue = graph.GetReal(right);
+
+    switch (node.type) {
+    case ExpressionType::Add:
+    case ExpressionType::Subtract:
+        if (rightValue == 0.0) {
+            graph.Merge(eClass, left);
+        }
+        break;
+    case ExpressionType::Multiply:
+        if (rightValue == 1.0) {
+            graph.Merge(eClass, left);
+        } else if (rightValue == 0.0) {
+            graph.Merge(eClass, right);
+        }
+        break;
+    case ExpressionType::Divide:
+        if (rightValue == 1.0) {
+            graph.Merge(eClass, left);
+        }
+        break;
+    case ExpressionType::Exponent:
+        if (rightValue == 0.0 || graph.GetReal(left) == 1.0) {
+            graph.Merge(eClass, graph.AddReal(1.0));
+        } else if (rightValue == 1.0) {
+            graph.Merge(eClass, left);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+// a - a = 0, a / a = 1, log[a](a) = 1
+auto CancelSelf(EGraph& graph, EClassId eClass, const ENode& node) -> void
+{
+    if (node.children.size() != 2 || graph.Find(node.children[0]) != graph.Find(node.children[1])) {
+        return;
+    }
+
+    switch (node.type) {
+    case ExpressionType::Subtract:
+        graph.Merge(eClass, graph.AddReal(0.0));
+        break;
+    case ExpressionType::Divide:
+    case ExpressionType::Log:
+        graph.Merge(eClass, graph.AddReal(1.0));
+        break;
+    default:
+        break;
+    }
+}
+
+// a - b = a + -1 * b, -a = -1 * a, a / b = a * b^-1
+auto RewriteInverses(EGraph& graph, EClassId eClass, const ENode& node) -> void
+{
+    switch (node.type) {
+    case ExpressionType::Subtract: {
+        const EClassId negated = graph.Add(ExpressionType::Multiply, { graph.AddReal(-1.0), node.children[1] });
+        graph.Merge(eClass, graph.Add(ExpressionType::Add, { node.children[0], negated }));
+        break;
+    }
+    case ExpressionType::Negate:
+        graph.Merge(eClass, graph.Add(ExpressionType::Multiply, { graph.AddReal(-1.0), node.children[0] }));
+        break;
+    case ExpressionType::Divide: {
+        const EClassId reciprocal = graph.Add(ExpressionType::Exponent, { node.children[1], graph.AddReal(-1.0) });
+        graph.Merge(eClass, graph.Add(ExpressionType::Multiply, { node.children[0], reciprocal }));
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// x + x = 2x, ax + x = (a + 1)x, ax + bx = (a + b)x
+auto CombineLikeTerms(EGraph& graph, EClassId eClass, const ENode& node) -> void
+{
+    if (node.type != ExpressionType::Add) {
+        return;
+    }
+
+    const EClassId left = node.children[0];
+    const EClassId right = node.children[1];
+
+    if (graph.Find(left) == graph.Find(right)) {
+        graph.Merge(eClass, graph.Add(ExpressionType::Multiply, { graph.AddReal(2.0), left }));
+    }
+
+    const auto rightTerms = graph.FindNodes(right, ExpressionType::Multiply);
+
+    for (const ENode& leftTerm : graph.FindNodes(left, ExpressionType::Multiply)) {
+        const EClassId term = graph.Find(leftTerm.children[1]);
+
+        if (term == graph.Find(right)) {
+            const EClassId coefficient = graph.Add(ExpressionType::Add, { leftTerm.children[0], graph.AddReal(1.0) });
+            graph.Merge(eClass, graph.Add(ExpressionType::Multiply, { coefficient, term }));
+        }
+
+        for (const ENode& rightTerm : rightTerms) {
+            if (graph.IsFull()) {
+                return;
+            }
+
+            if (term == graph.Find(rightTerm.children[1])) {
+                const EClassId coefficient = graph.Add(ExpressionType::Add, { leftTerm.children[0], rightTerm.children[0] });
+                graph.Merge(eClass, graph.Add(ExpressionType::Multiply, { coefficient, term }));
+            }
+        }
+    }
+}
+
+// x * x = x^2, x^n * x = x^(n + 1), x^n * x^m = x^(n + m), (x^n)^m = x^(nm), i * i = -1
+auto MergeExponents(EGraph& graph, EClassId eClass, const ENode& node) -> void
+{
+    if (node.type == ExpressionType::Exponent) {
+        for (const ENode& base : graph.FindNodes(node.children[0], ExpressionType::Exponent)) {
+            if (graph.IsFull()) {
+                return;
+            }
+
+            const EClassId power = graph.Add(ExpressionType::Multiply, { base.children[1], node.children[1] });
+            graph.Merge(eClass, graph.Add(ExpressionType::Exponent, { base.children[0], power }));
+        }
+        return;
+    }
+
+    if (node.type != ExpressionType::Multiply) {
+        return;
+    }
+
+    const EClassId left = node.children[0];
+    const EClassId right = node.children[1];
+
+    if (graph.Find(left) == graph.Find(right)) {
+        if (!graph.FindNodes(left, ExpressionType::Imaginary).empty()) {
+            graph.Merge(eClass, graph.AddReal(-1.0));
+        } else {
+            graph.Merge(eClass, graph.Add(ExpressionType::Exponent, { left, graph.AddReal(2.0) }));
+        }
+    }
+
+    const auto rightPowers = graph.FindNodes(right, ExpressionType::Exponent);
+
+    for (const ENode& leftPower : graph.FindNodes(left, ExpressionType::Exponent)) {
+        const EClassId base = graph.Find(leftPower.children[0]);
+
+        if (base == graph.Find(right)) {
+            const EClassId power = graph.Add(ExpressionType::Add, { leftPower.children[1], graph.AddReal(1.0) });
+            graph.Merge(eClass, graph.Add(ExpressionType::Exponent, { base, power }));
+        }
+
+        for (const ENode& rightPower : rightPowers) {
+            if (graph.IsFull()) {
+                return;
+            }
+
+            if (base == graph.Find(rightPower.children[0])) {
+                const EClassId power = graph.Add(ExpressionType::Add, { leftPower.children[1], rightPower.children[1] });
+                graph.Merge(eClass, graph.Add(ExpressionType::Exponent, { base, power }));
+            }
+        }
+    }
+}
+
+// log[b](x) + log[b](y) = log[b](xy), log[b](x) - log[b](y) = log[b](x / y),
+// log[b](x^n) = n * log[b](x), b^log[b](x) = x
+auto MergeLogs(EGraph& graph, EClassId eClass, const ENode& node) -> void
+{
+    switch (node.type) {
+    case ExpressionType::Add:
+    case ExpressionType::Subtract: {
+        const auto argumentType = node.type == ExpressionType::Add ? ExpressionType::Multiply : ExpressionType::Divide;
+        const auto rightLogs = graph.FindNodes(node.children[1], ExpressionType::Log);
+
+        for (const ENode& leftLog : graph.FindNodes(node.children[0], ExpressionType::Log)) {
+            for (const ENode& rightLog : rightLogs) {
+                if (graph.IsFull()) {
+                    return;
+                }
+
+                if (graph.Find(leftLog.children[0]) == graph.Find(rightLog.children[0])) {
+                    const EClassId argument = graph.Add(argumentType, { leftLog.children[1], rightLog.children[1] });
+                    graph.Merge(eClass, graph.Add(ExpressionType::Log, { leftLog.children[0], argument }));
+                }
+            }
+        }
+        break;
+    }
+    case ExpressionType::Log:
+        for (const ENode& argument : graph.FindNodes(node.children[1], ExpressionType::Exponent)) {
+            const EClassId log = graph.Add(ExpressionType::Log, { node.children[0], argument.children[0] });
+            graph.Merge(eClass, graph.Add(ExpressionType::Multiply, { argument.children[1], log }));
+        }
+        break;
+    case ExpressionType::Exponent:
+        for (const ENode& power : graph.FindNodes(node.children[1], ExpressionType::Log)) {
+            if (graph.Find(power.children[0]) == graph.Find(node.children[0])) {
+                graph.Merge(eClass, power.children[1]);
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+auto GetEvaluationWeight(ExpressionType type) -> double
+{
+    switch (type) {
+    case ExpressionType::Multiply:
+    case ExpressionType::Magnitude:
+        return 2.0;
+    case ExpressionType::Divide:
+        return 4.0;
+    case ExpressionType::Exponent:
+        return 8.0;
+    case ExpressionType::Log:
+    case ExpressionType::Sine:
+        return 16.0;
+    case ExpressionType::Integral:
+    case ExpressionType::Derivative:
+        return 32.0;
+    default:
+        return 1.0;
+    }
+}
+
+}
+
+namespace Oasis {
+
+auto ENode::GetHash() const -> std::uint64_t
+{
+    std::uint64_t hash = MixHash(static_cast<std::uint64_t>(type));
+
+    if (leaf) {
+        hash = CombineHash(hash, leaf->GetHash());
+    }
+
+    for (const EClassId child : children) {
+        hash = CombineHash(hash, child);
+    }
+
+    return hash;
+}
+
+auto ENode::operator==(const ENode& other) const -> bool
+{
+    if (type != other.type || children != other.children || (leaf == nullptr) != (other.leaf == nullptr)) {
+        return false;
+    }
+
+    return leaf == nullptr || leaf == other.leaf || leaf->Equals(*other.leaf);
+}
+
+auto NodeCountCost(const ENode& node, std::span<const double> childCosts) -> double
+{
+    return std::accumulate(childCosts.begin(), childCosts.end(), node.type == ExpressionType::Real ? 0.5 : 1.0);
+}
+
+auto EvaluationCost(const ENode& node, std::span<const double> childCosts) -> double
+{
+    return std::accumulate(childCosts.begin(), childCosts.end(), GetEvaluationWeight(node.type));
+}
+
+auto DefaultRewrites() -> std::vector<EGraphRewrite>
+{
+    return {
+        { "commute", Commute },
+        { "associate", Associate },
+        { "fold-constants", FoldConstants },
+        { "identities", ApplyIdentities },
+        { "cancel-self", CancelSelf },
+        { "rewrite-inverses", RewriteInverses },
+        { "combine-like-terms", CombineLikeTerms },
+        { "merge-exponents", MergeExponents },
+        { "merge-logs", MergeLogs },
+    };
+}
+
+auto EGraph::Add(const Expression& expression) -> EClassId
+{
+    ENode node { .type = expression.GetType() };
+    const std::size_t operandCount = expression.GetOperandCount();
+
+    if (IsOperator(node.type) && operandCount > 0) {
+        for (std::size_t i = 0; i < operandCount; ++i) {
+            const Expression* operand = expression.GetOperandAt(i);
+            if (operand == nullptr) {
+                node.children.clear();
+                break;
+            }
+            node.children.push_back(Add(*operand));
+        }
+    }
+
+    // Expressions with missing operands are kept whole, so they are not rebuilt differently.
+    if (node.children.size() != operandCount || !IsOperator(node.type)) {
+        node.children.clear();
+        node.leaf = expression.Copy();
+    }
+
+    return Add(std::move(node));
+}
+
+auto EGraph::Add(ENode node) -> EClassId
+{
+    Canonicalize(node);
+
+    if (const auto it = memo.find(node); it != memo.end()) {
+        return Find(it->second);
+    }
+
+    const auto eClass = static_cast<EClassId>(parents.size());
+    parents.push_back(eClass);
+    classes.emplace_back().push_back(node);
+    memo.emplace(std::move(node), eClass);
+
+    ++nodeCount;
+    ++version;
+    return eClass;
+}
+
+auto EGraph::Add(ExpressionType type, std::vector<EClassId> children) -> EClassId
+{
+    return Add(ENode { .type = type, .children = std::move(children) });
+}
+
+auto EGraph::AddReal(double value) -> EClassId
+{
+    return Add(ENode { .type = ExpressionType::Real, .leaf = std::make_shared<const Real>(value) });
+}
+
+auto EGraph::Extract(EClassId eClass, const CostFunction& costFunction) const -> std::unique_ptr<Expression>
+{
+    std::vector<double> costs(classes.size(), std::numeric_limits<double>::infinity());
+    std::vector<const ENode*> cheapest(classes.size(), nullptr);
+    std::vector<double> childCosts;
+
+    // Costs only decrease, so this reaches a fixed point once every class has its cheapest node.
+    for (bool changed = true; changed;) {
+        changed = false;
+
+        for (EClassId id = 0; id < classes.size(); ++id) {
+            for (const ENode& node : classes[id]) {
+                childCosts.clear();
+
+                for (const EClassId child : node.children) {
+                    childCosts.push_back(costs[Find(child)]);
+                }
+
+                if (std::ranges::any_of(childCosts, [](double cost) { return std::isinf(cost); })) {
+                    continue;
+                }
+
+                if (const double cost = costFunction(node, childCosts); cost < costs[id]) {
+                    costs[id] = cost;
+                    cheapest[id] = &node;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    const std::function<std::unique_ptr<Expression>(EClassId)> build = [&](EClassId id) -> std::unique_ptr<Expression> {
+        const ENode* node = cheapest[Find(id)];
+        if (node == nullptr) {
+            return std::make_unique<Undefined>();
+        }
+
+        std::vector<std::unique_ptr<Expression>> operands;
+        for (const EClassId child : node->children) {
+            operands.push_back(build(child));
+        }
+
+        return Build(*node, std::move(operands));
+    };
+
+    return build(eClass);
+}
+
+auto EGraph::Find(EClassId eClass) const -> EClassId
+{
+    while (parents[eClass] != eClass) {
+        eClass = parents[eClass];
+    }
+
+    return eClass;
+}
+
+auto EGraph::FindNodes(EClassId eClass, ExpressionType type) const -> std::vector<ENode>
+{
+    std::vector<ENode> nodes;
+
+    for (const ENode& node : classes[Find(eClass)]) {
+        if (node.type == type) {
+            nodes.push_back(node);
+        }
+    }
+
+    return nodes;
+}
+
+auto EGraph::GetClassCount() const -> std::size_t
+{
+    return std::ranges::count_if(classes, [](const auto& nodes) { return !nodes.empty(); });
+}
+
+auto EGraph::GetNodeCount() const -> std::size_t
+{
+    return nodeCount;
+}
+
+auto EGraph::GetReal(EClassId eClass) const -> std::optional<double>
+{
+    for (const ENode& node : classes[Find(eClass)]) {
+        if (node.type == ExpressionType::Real) {
+            return static_cast<const Real&>(*node.leaf).GetValue();
+        }
+    }
+
+    return std::nullopt;
+}
+
+auto EGraph::IsFull() const -> bool
+{
+    return nodeCount >= nodeLimit;
+}
+
+auto EGraph::Merge(EClassId a, EClassId b) -> bool
+{
+    a = Find(a);
+    b = Find(b);
+
+    if (a == b) {
+        return false;
+    }
+
+    if (classes[a].size() < classes[b].size()) {
+        std::swap(a, b);
+    }
+
+    parents[b] = a;
+    classes[a].insert(classes[a].end(), std::make_move_iterator(classes[b].begin()), std::make_move_iterator(classes[b].end()));
+    classes[b] = {};
+
+    ++version;
+    return true;
+}
+
+auto EGraph::Rebuild() -> void
+{
+    std::vector<std::pair<EClassId, EClassId>> pending;
+
+    do {
+        pending.clear();
+
+        std::unordered_map<ENode, EClassId, ENodeHash> canonical(memo.size());
+        for (const auto& [node, eClass] : memo) {
+            ENode key = node;
+            Canonicalize(key);
+
+            // Nodes that became equal once their operands were merged prove their classes equal.
+            if (const auto [it, inserted] = canonical.try_emplace(std::move(key), Find(eClass)); !inserted && Find(it->second) != Find(eClass)) {
+                pending.emplace_back(it->second, eClass);
+            }
+        }
+        memo = std::move(canonical);
+
+        for (const auto& [a, b] : pending) {
+            Merge(a, b);
+        }
+    } while (!pending.empty());
+
+    // A class that folded to a number is only ever extracted as that number, so its other nodes
+    // are dropped from the class. They are kept in memo, so adding them again is a no-op.
+    std::vector<bool> constant(classes.size());
+    for (const auto& [node, eClass] : memo) {
+        if (node.type == ExpressionType::Real) {
+            constant[Find(eClass)] = true;
+        }
+    }
+
+    for (auto& nodes : classes) {
+        nodes.clear();
+    }
+
+    nodeCount = 0;
+    for (const auto& [node, eClass] : memo) {
+        if (const EClassId id = Find(eClass); !constant[id] || node.type == ExpressionType::Real) {
+            classes[id].push_back(node);
+            ++nodeCount;
+        }
+    }
+}
+
+auto EGraph::Saturate(std::span<const EGraphRewrite> rewrites, std::size_t maxIterations, std::size_t maxNodes) -> bool
+{
+    nodeLimit = maxNodes;
+    Rebuild();
+
+    for (std::size_t iteration = 0; iteration < maxIterations; ++iteration) {
+        const std::size_t previousVersion = version;
+
+        // Rewrites add to the graph, so they are applied to the nodes present at the start.
+        std::vector<std::pair<EClassId, ENode>> nodes;
+        for (EClassId id = 0; id < classes.size(); ++id) {
+            for (const ENode& node : classes[id]) {
+                nodes.emplace_back(id, node);
+            }
+        }
+
+        for (const auto& [eClass, node] : nodes) {
+            for (const EGraphRewrite& rewrite : rewrites) {
+                if (IsFull()) {
+                    Rebuild();
+                    return false;
+                }
+
+                rewrite.apply(*this, Find(eClass), node);
+            }
+        }
+
+        Rebuild();
+
+        if (version == previousVersion) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+auto EGraph::Canonicalize(ENode& node) const -> void
+{
+    for (EClassId& child : node.children) {
+        child = Find(child);
+    }
+}
+
+auto EGraph::ENodeHash::operator()(const ENode& node) const -> std::size_t
+{
+    return node.GetHash();
+}
+
+auto SimplifyWithEGraph(const Expression& expression, const EGraphOpts& opts) -> EGraphResult
+{
+    EGraph graph;
+    const EClassId root = graph.Add(expression);
+    const bool saturated = graph.Saturate(opts.rewrites, opts.maxIterations, opts.maxNodes);
+
+    return { graph.Extract(root, opts.costFunction), saturated, graph.GetClassCount(), graph.GetNodeCount() };
+}
+
+} // Oasis
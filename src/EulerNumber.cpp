@@ -31,7 +31,7 @@ auto EulerNumber::Integrate(const Expression& integrationVariable) const -> std:
     if (const auto variable = RecursiveCast<Variable>(integrationVariable); variable != nullptr) {
         // Constant rule
         Add adder {
-            Multiply<EulerNumber, Variable> { EulerNumber {}, Variable { (*variable).GetName() } },
+            Multiply<EulerNumber, Variable> { EulerNumber {}, *variable },
             Variable { "C" }
         };
 
@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Oasis/EvaluateBatch.hpp"
+
+// Builds a version of a function for each instruction set, picked when the program is loaded.
+// This relies on ifuncs, so it is limited to GCC and Clang targeting x86-64 Linux.
+#if (defined(OASIS_COMPILER_GCC) || defined(OASIS_COMPILER_CLANG)) && defined(__x86_64__) && defined(__linux__)
+#define OASIS_TARGET_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define OASIS_TARGET_CLONES
+#endif
+
+namespace Oasis {
+
+namespace {
+
+using Instruction = CompiledExpression::Instruction;
+using OpCode = CompiledExpression::OpCode;
+
+// The number of points of grid evaluated by a task, which keeps the results written by a task
+// within a typical L2 cache.
+constexpr std::size_t GRID_TILE_SIZE = 1 << 14;
+
+// Runs a program over one block. Each register holds BatchBlockSize values, one per lane. All of
+// the arithmetic is kept in this function, so that every loop is built for each instruction set.
+OASIS_TARGET_CLONES
+auto RunBlock(std::span<const Instruction> instructions, const double* const* values, double* registers, std::size_t lanes) -> void
+{
+    for (const Instruction& instruction : instructions) {
+        double* result = registers + instruction.result * BatchBlockSize;
+        const double* first = registers + instruction.first * BatchBlockSize;
+        const double* second = registers + instruction.second * BatchBlockSize;
+
+        switch (instruction.op) {
+        case OpCode::Constant:
+            std::fill_n(result, lanes, instruction.immediate);
+            break;
+        case OpCode::Variable:
+            std::copy_n(values[instruction.first], lanes, result);
+            break;
+        case OpCode::Add:
+            for (std::size_t i = 0; i < lanes; ++i) {
+                result[i] = first[i] + second[i];
+            }
+            break;
+        case OpCode::Subtract:
+            for (std::size_t i = 0; i < lanes; ++i) {
+                result[i] = first[i] - second[i];
+            }
+            break;
+        case OpCode::Multiply:
+            for (std::size_t i = 0; i < lanes; ++i) {
+                result[i] = first[i] * second[i];
+            }
+            break;
+        case OpCode::Divide:
+            for (std::size_t i = 0; i < lanes; ++i) {
+                result[i] = first[i] / second[i];
+            }
+            break;
+        case OpCode::Negate:
+            for (std::size_t i = 0; i < lanes; ++i) {
+                result[i] = -first[i];
+            }
+            break;
+        case OpCode::Sqrt:
+            for (std::size_t i = 0; i < lanes; ++i) {
+                result[i] = std::sqrt(first[i]);
+            }
+            break;
+        case OpCode::Abs:
+            for (std::size_t i = 0; i < lanes; ++i) {
+                result[i] = std::abs(first[i]);
+            }
+            break;
+        case OpCode::IntegerPower: {
+            // The power is the same in every lane, so each step of repeated squaring is a plain
+            // loop over the block.
+            double squared[BatchBlockSize];
+            std::copy_n(first, lanes, squared);
+            std::fill_n(result, lanes, 1.0);
+
+            for (auto remaining = static_cast<std::uint64_t>(std::abs(instruction.immediate)); remaining != 0; remaining >>= 1) {
+                if (remaining & 1) {
+                    for (std::size_t i = 0; i < lanes; ++i) {
+                        result[i] *= squared[i];
+                    }
+                }
+                for (std::size_t i = 0; i < lanes; ++i) {
+                    squared[i] *= squared[i];
+                }
+            }
+
+            if (instruction.immediate < 0.0) {
+                for (std::size_t i = 0; i < lanes; ++i) {
+                    result[i] = 1.0 / result[i];
+                }
+            }
+            break;
+        }
+        case OpCode::Power:
+            for (std::size_t i = 0; i < lanes; ++i) {
+                result[i] = std::pow(first[i], second[i]);
+            }
+            break;
+        case OpCode::Exp:
+            for (std::size_t i = 0; i < lanes; ++i) {
+                result[i] = std::exp(first[i]);
+            }
+            break;
+        case OpCode::Log:
+            for (std::size_t i = 0; i < lanes; ++i) {
+                result[i] = std::log(second[i]) / std::log(first[i]);
+            }
+            break;
+        case OpCode::NaturalLog:
+            for (std::size_t i = 0; i < lanes; ++i) {
+                result[i] = std::log(first[i]);
+            }
+            break;
+        case OpCode::Sine:
+            for (std::size_t i = 0; i < lanes; ++i) {
+                result[i] = std::sin(first[i]);
+            }
+            break;
+        }
+    }
+}
+
+}
+
+auto EvaluateBatch(const CompiledExpression& compiled, std::span<const std::span<const double>> values, std::span<double> results, const std::shared_ptr<ThreadPool>& threadPool) -> std::expected<void, std::string>
+{
+    if (values.size() != compiled.GetVariables().size()) {
+        return std::unexpected { "Expected values for " + std::to_string(compiled.GetVariables().size()) + " variables." };
+    }
+
+    for (const std::span<const double>& variableValues : values) {
+        if (variableValues.size() < results.size()) {
+            return std::unexpected { "Missing values of a variable." };
+        }
+    }
+
+    const std::size_t blocks = (results.size() + BatchBlockSize - 1) / BatchBlockSize;
+
+    const auto evaluateBlocks = [&compiled, &values, &results](std::size_t beginBlock, std::size_t endBlock) {
+        std::vector<double> registers(compiled.GetRegisterCount() * BatchBlockSize);
+        std::vector<const double*> blockValues(values.size());
+
+        for (std::size_t block = beginBlock; block < endBlock; ++block) {
+            const std::size_t begin = block * BatchBlockSize;
+            const std::size_t lanes = std::min(BatchBlockSize, results.size() - begin);
+
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                blockValues[i] = values[i].data() + begin;
+            }
+
+            RunBlock(compiled.GetInstructions(), blockValues.data(), registers.data(), lanes);
+            std::copy_n(registers.data() + compiled.GetResultRegister() * BatchBlockSize, lanes, results.data() + begin);
+        }
+    };
+
+    if (threadPool) {
+        threadPool->ParallelFor(blocks, 1, evaluateBlocks);
+    } else {
+        evaluateBlocks(0, blocks);
+    }
+
+    return {};
+}
+
+auto EvaluateGrid(const CompiledExpression& compiled, std::span<const GridAxis> axes, std::span<double> results, const std::shared_ptr<ThreadPool>& threadPool) -> std::expected<void, std::string>
+{
+    const std::size_t dimensions = compiled.GetVariables().size();
+    if (dimensions == 0 || axes.size() != dimensions) {
+        return std::unexpected { "Expected an axis for each of " + std::to_string(dimensions) + " variables." };
+    }
+
+    std::size_t points = 1;
+    for (const GridAxis& axis : axes) {
+        points *= axis.count;
+    }
+
+    if (results.size() != points) {
+        return std::unexpected { "Expected space for " + std::to_string(points) + " points." };
+    }
+
+    if (points == 0) {
+        return {};
+    }
+
+    std::vector<std::vector<double>> coordinates(dimensions);
+    for (std::size_t d = 0; d < dimensions; ++d) {
+        const GridAxis& axis = axes[d];
+        const double step = axis.count > 1 ? (axis.last - axis.first) / static_cast<double>(axis.count - 1) : 0.0;
+
+        coordinates[d].resize(axis.count);
+        for (std::size_t i = 0; i < axis.count; ++i) {
+            coordinates[d][i] = axis.first + step * static_cast<double>(i);
+        }
+    }
+
+    const std::size_t inner = dimensions - 1;
+    const std::size_t rowLength = axes[inner].count;
+    const std::size_t rows = points / rowLength;
+
+    const std::span<const Instruction> instructions = compiled.GetInstructions();
+    const std::span<const Instruction> innerStage = compiled.GetStage(inner);
+    const auto stageBegin = [&compiled, &instructions](std::size_t stage) {
+        return static_cast<std::size_t>(compiled.GetStage(stage).data() - instructions.data());
+    };
+
+    // Values computed by earlier stages are computed in the first lane of their registers, then
+    // copied to every lane so that the last stage can read them like any other block.
+    std::vector<bool> computedEarlier(compiled.GetRegisterCount());
+    for (const Instruction& instruction : instructions.first(stageBegin(inner))) {
+        computedEarlier[instruction.result] = true;
+    }
+
+    std::vector<bool> readByInnerStage(compiled.GetRegisterCount());
+    readByInnerStage[compiled.GetResultRegister()] = true;
+    for (const Instruction& instruction : innerStage) {
+        if (instruction.op != OpCode::Constant && instruction.op != OpCode::Variable) {
+            readByInnerStage[instruction.first] = true;
+            readByInnerStage[instruction.second] = true;
+        }
+    }
+
+    std::vector<std::uint32_t> broadcast;
+    for (std::uint32_t r = 0; r < compiled.GetRegisterCount(); ++r) {
+        if (computedEarlier[r] && readByInnerStage[r]) {
+            broadcast.push_back(r);
+        }
+    }
+
+    const auto evaluateRows = [&](std::size_t beginRow, std::size_t endRow) {
+        std::vector<double> registers(compiled.GetRegisterCount() * BatchBlockSize);
+        std::vector<double> point(dimensions);
+        std::vector<const double*> values(dimensions);
+        std::vector<std::size_t> index(dimensions);
+
+        for (std::size_t d = 0; d < dimensions; ++d) {
+            values[d] = &point[d];
+        }
+
+        for (std::size_t d = inner, remaining = beginRow; d-- > 0;) {
+            index[d] = remaining % axes[d].count;
+            remaining /= axes[d].count;
+        }
+
+        // Every stage runs for the first row of a tile.
+        std::size_t changed = 0;
+
+        for (std::size_t row = beginRow; row < endRow; ++row) {
+            for (std::size_t d = changed; d < inner; ++d) {
+                point[d] = coordinates[d][index[d]];
+            }
+
+            RunBlock(instructions.subspan(stageBegin(changed), stageBegin(inner) - stageBegin(changed)), values.data(), registers.data(), 1);
+
+            const std::size_t lanes = std::min(BatchBlockSize, rowLength);
+            for (const std::uint32_t r : broadcast) {
+                std::fill_n(registers.data() + r * BatchBlockSize + 1, lanes - 1, registers[r * BatchBlockSize]);
+            }
+
+            double* rowResults = results.data() + row * rowLength;
+            for (std::size_t begin = 0; begin < rowLength; begin += BatchBlockSize) {
+                values[inner] = coordinates[inner].data() + begin;
+
+                const std::size_t blockLanes = std::min(BatchBlockSize, rowLength - begin);
+                RunBlock(innerStage, values.data(), registers.data(), blockLanes);
+                std::copy_n(registers.data() + compiled.GetResultRegister() * BatchBlockSize, blockLanes, rowResults + begin);
+            }
+
+            // Moves to the next row, like an odometer, noting the first variable that changed.
+            changed = inner;
+            while (changed > 0) {
+                --changed;
+                if (++index[changed] < axes[changed].count) {
+                    break;
+                }
+                index[changed] = 0;
+            }
+        }
+    };
+
+    if (threadPool) {
+        threadPool->ParallelFor(rows, std::max<std::size_t>(GRID_TILE_SIZE / rowLength, 1), evaluateRows);
+    } else {
+        evaluateRows(0, rows);
+    }
+
+    return {};
+}
+
+} // Oasis
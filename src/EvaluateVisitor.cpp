@@ -0,0 +1,370 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+
+#include "Oasis/Add.hpp"
+#include "Oasis/Derivative.hpp"
+#include "Oasis/Divide.hpp"
+#include "Oasis/EulerNumber.hpp"
+#include "Oasis/EvaluateVisitor.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/Imaginary.hpp"
+#include "Oasis/Integral.hpp"
+#include "Oasis/Log.hpp"
+#include "Oasis/Magnitude.hpp"
+#include "Oasis/Matrix.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Negate.hpp"
+#include "Oasis/Pi.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/Sine.hpp"
+#include "Oasis/Subtract.hpp"
+#include "Oasis/Undefined.hpp"
+#include "Oasis/Variable.hpp"
+
+namespace Oasis {
+
+namespace {
+
+template <typename T>
+constexpr bool IsComplex = false;
+
+template <>
+constexpr bool IsComplex<std::complex<double>> = true;
+
+// Integer powers up to this magnitude are computed by repeated squaring, which keeps powers of
+// the imaginary unit exact where std::pow would go through polar form.
+constexpr double MAX_SQUARED_POWER = 1024.0;
+
+auto IntegerPower(std::complex<double> base, std::int64_t power) -> std::complex<double>
+{
+    const bool reciprocal = power < 0;
+    auto remaining = static_cast<std::uint64_t>(reciprocal ? -power : power);
+
+    std::complex<double> result { 1.0 };
+    while (remaining != 0) {
+        if (remaining & 1) {
+            result *= base;
+        }
+        base *= base;
+        remaining >>= 1;
+    }
+
+    return reciprocal ? 1.0 / result : result;
+}
+
+}
+
+auto VariableBindings::Bind(SymbolId symbol, std::complex<double> value) -> VariableBindings&
+{
+    if (symbol >= values.size()) {
+        values.resize(symbol + 1);
+    }
+
+    std::optional<std::complex<double>>& bound = values[symbol];
+    if (bound && bound->imag() != 0.0) {
+        --complexValues;
+    }
+    if (value.imag() != 0.0) {
+        ++complexValues;
+    }
+
+    bound = value;
+    return *this;
+}
+
+auto VariableBindings::Bind(std::string_view name, std::complex<double> value) -> VariableBindings&
+{
+    return Bind(SymbolTable::Global().Intern(name), value);
+}
+
+auto VariableBindings::Find(SymbolId symbol) const -> const std::complex<double>*
+{
+    if (symbol >= values.size() || !values[symbol]) {
+        return nullptr;
+    }
+
+    return &*values[symbol];
+}
+
+auto VariableBindings::IsReal() const -> bool
+{
+    return complexValues == 0;
+}
+
+EvaluateVisitor::EvaluateVisitor(VariableBindings bindings)
+    : bindings(std::move(bindings))
+{
+}
+
+auto EvaluateVisitor::TypedVisit(const Real& real) -> RetT
+{
+    return Evaluate(real);
+}
+
+auto EvaluateVisitor::TypedVisit(const Imaginary& imaginary) -> RetT
+{
+    return Evaluate(imaginary);
+}
+
+auto EvaluateVisitor::TypedVisit(const Variable& variable) -> RetT
+{
+    return Evaluate(variable);
+}
+
+auto EvaluateVisitor::TypedVisit(const Undefined& undefined) -> RetT
+{
+    return Evaluate(undefined);
+}
+
+auto EvaluateVisitor::TypedVisit(const Add<Expression, Expression>& add) -> RetT
+{
+    return Evaluate(add);
+}
+
+auto EvaluateVisitor::TypedVisit(const Subtract<Expression, Expression>& subtract) -> RetT
+{
+    return Evaluate(subtract);
+}
+
+auto EvaluateVisitor::TypedVisit(const Multiply<Expression, Expression>& multiply) -> RetT
+{
+    return Evaluate(multiply);
+}
+
+auto EvaluateVisitor::TypedVisit(const Divide<Expression, Expression>& divide) -> RetT
+{
+    return Evaluate(divide);
+}
+
+auto EvaluateVisitor::TypedVisit(const Exponent<Expression, Expression>& exponent) -> RetT
+{
+    return Evaluate(exponent);
+}
+
+auto EvaluateVisitor::TypedVisit(const Log<Expression, Expression>& log) -> RetT
+{
+    return Evaluate(log);
+}
+
+auto EvaluateVisitor::TypedVisit(const Negate<Expression>& negate) -> RetT
+{
+    return Evaluate(negate);
+}
+
+auto EvaluateVisitor::TypedVisit(const Sine<Expression>& sine) -> RetT
+{
+    return Evaluate(sine);
+}
+
+auto EvaluateVisitor::TypedVisit(const Derivative<Expression, Expression>& derivative) -> RetT
+{
+    return Evaluate(derivative);
+}
+
+auto EvaluateVisitor::TypedVisit(const Integral<Expression, Expression>& integral) -> RetT
+{
+    return Evaluate(integral);
+}
+
+auto EvaluateVisitor::TypedVisit(const Matrix& matrix) -> RetT
+{
+    return Evaluate(matrix);
+}
+
+auto EvaluateVisitor::TypedVisit(const EulerNumber& e) -> RetT
+{
+    return Evaluate(e);
+}
+
+auto EvaluateVisitor::TypedVisit(const Pi& pi) -> RetT
+{
+    return Evaluate(pi);
+}
+
+auto EvaluateVisitor::TypedVisit(const Magnitude<Expression>& magnitude) -> RetT
+{
+    return Evaluate(magnitude);
+}
+
+auto EvaluateVisitor::GetBindings() -> VariableBindings&
+{
+    return bindings;
+}
+
+auto EvaluateVisitor::GetBindings() const -> const VariableBindings&
+{
+    return bindings;
+}
+
+auto EvaluateVisitor::Evaluate(const Expression& expression) -> RetT
+{
+    error.clear();
+    needsComplex = !bindings.IsReal();
+
+    if (!needsComplex) {
+        if (const auto value = EvaluateAs<double>(expression)) {
+            return std::complex<double> { *value };
+        }
+
+        if (!needsComplex) {
+            return std::unexpected { error };
+        }
+    }
+
+    if (const auto value = EvaluateAs<std::complex<double>>(expression)) {
+        return *value;
+    }
+
+    return std::unexpected { error };
+}
+
+// Operands are visited by switching on their type rather than through Accept, which would
+// allocate a result for every node.
+template <typename T>
+auto EvaluateVisitor::EvaluateAs(const Expression& expression) -> std::optional<T>
+{
+    const auto operand = [this, &expression](std::size_t index) -> std::optional<T> {
+        const Expression* op = expression.GetOperandAt(index);
+        if (op == nullptr) {
+            error = "Missing operand.";
+            return std::nullopt;
+        }
+        return EvaluateAs<T>(*op);
+    };
+
+    switch (expression.GetType()) {
+    case ExpressionType::None:
+        return T { std::numeric_limits<double>::quiet_NaN() };
+    case ExpressionType::Real:
+        return T { static_cast<const Real&>(expression).GetValue() };
+    case ExpressionType::Imaginary:
+        if constexpr (IsComplex<T>) {
+            return T { 0.0, 1.0 };
+        } else {
+            needsComplex = true;
+            return std::nullopt;
+        }
+    case ExpressionType::Variable: {
+        const auto& variable = static_cast<const Variable&>(expression);
+        const std::complex<double>* value = bindings.Find(variable.GetSymbol());
+        if (value == nullptr) {
+            error = "Variable " + variable.GetName() + " is not bound.";
+            return std::nullopt;
+        }
+        if constexpr (IsComplex<T>) {
+            return *value;
+        } else {
+            return value->real();
+        }
+    }
+    case ExpressionType::Pi:
+        return T { std::numbers::pi };
+    case ExpressionType::EulerNumber:
+        return T { std::numbers::e };
+    case ExpressionType::Add:
+    case ExpressionType::Subtract:
+    case ExpressionType::Multiply:
+    case ExpressionType::Divide: {
+        const auto mostSigOp = operand(0);
+        if (!mostSigOp) {
+            return std::nullopt;
+        }
+        const auto leastSigOp = operand(1);
+        if (!leastSigOp) {
+            return std::nullopt;
+        }
+
+        switch (expression.GetType()) {
+        case ExpressionType::Add:
+            return *mostSigOp + *leastSigOp;
+        case ExpressionType::Subtract:
+            return *mostSigOp - *leastSigOp;
+        case ExpressionType::Multiply:
+            return *mostSigOp * *leastSigOp;
+        default:
+            return *mostSigOp / *leastSigOp;
+        }
+    }
+    case ExpressionType::Exponent: {
+        const auto base = operand(0);
+        if (!base) {
+            return std::nullopt;
+        }
+        const auto power = operand(1);
+        if (!power) {
+            return std::nullopt;
+        }
+
+        if constexpr (IsComplex<T>) {
+            if (power->imag() == 0.0 && std::trunc(power->real()) == power->real() && std::abs(power->real()) <= MAX_SQUARED_POWER) {
+                return IntegerPower(*base, static_cast<std::int64_t>(power->real()));
+            }
+            return std::pow(*base, *power);
+        } else {
+            if (*base < 0.0 && std::trunc(*power) != *power) {
+                needsComplex = true;
+                return std::nullopt;
+            }
+            return std::pow(*base, *power);
+        }
+    }
+    case ExpressionType::Log: {
+        const auto base = operand(0);
+        if (!base) {
+            return std::nullopt;
+        }
+        const auto argument = operand(1);
+        if (!argument) {
+            return std::nullopt;
+        }
+
+        if constexpr (!IsComplex<T>) {
+            if (*base < 0.0 || *argument < 0.0) {
+                needsComplex = true;
+                return std::nullopt;
+            }
+        }
+        return std::log(*argument) / std::log(*base);
+    }
+    case ExpressionType::Negate: {
+        const auto op = operand(0);
+        if (!op) {
+            return std::nullopt;
+        }
+        return -*op;
+    }
+    case ExpressionType::Sine: {
+        const auto op = operand(0);
+        if (!op) {
+            return std::nullopt;
+        }
+        return std::sin(*op);
+    }
+    case ExpressionType::Magnitude: {
+        const auto op = operand(0);
+        if (!op) {
+            return std::nullopt;
+        }
+        return T { std::abs(*op) };
+    }
+    default:
+        error = "Expression cannot be evaluated numerically.";
+        return std::nullopt;
+    }
+}
+
+auto Evaluate(const Expression& expression, const VariableBindings& bindings) -> std::expected<double, std::string>
+{
+    EvaluateVisitor visitor { bindings };
+
+    return expression.Accept(visitor).and_then([](std::complex<double> value) -> std::expected<double, std::string> {
+        if (value.imag() != 0.0) {
+            return std::unexpected { "Expression evaluates to a complex number." };
+        }
+        return value.real();
+    });
+}
+
+} // Oasis
@@ -5,6 +5,7 @@
 #include <cmath>
 
 #include "Oasis/Add.hpp"
+#include "Oasis/CancellationToken.hpp"
 #include "Oasis/Derivative.hpp"
 #include "Oasis/Divide.hpp"
 #include "Oasis/EulerNumber.hpp"
@@ -23,8 +24,17 @@ Exponent<Expression>::Exponent(const Expression& base, const Expression& power)
 {
 }
 
+Exponent<Expression>::Exponent(std::unique_ptr<Expression>&& base, std::unique_ptr<Expression>&& power)
+    : BinaryExpression(std::move(base), std::move(power))
+{
+}
+
 auto Exponent<Expression>::Integrate(const Expression& integrationVariable) const -> std::unique_ptr<Expression>
 {
+    if (CheckCancellation()) {
+        return Integral<Expression> { *this, integrationVariable }.Generalize();
+    }
+
     SimplifyVisitor simplifyVisitor {};
     // variable integration
     if (auto variable = RecursiveCast<Variable>(integrationVariable); variable != nullptr) {
@@ -40,10 +50,10 @@ auto Exponent<Expression>::Integrate(const Expression& integrationVariable) cons
             const Variable& expBase = realExponent->GetMostSigOp();
             const Real& expPow = realExponent->GetLeastSigOp();
 
-            if ((*variable).GetName() == expBase.GetName()) {
+            if (variable->GetSymbol() == expBase.GetSymbol()) {
                 Add adder {
                     Divide {
-                        Exponent<Variable, Real> { Variable { (*variable).GetName() }, Real { expPow.GetValue() + 1 } },
+                        Exponent<Variable, Real> { *variable, Real { expPow.GetValue() + 1 } },
                         Real { expPow.GetValue() + 1 } },
                     Variable { "C" }
                 };
@@ -43,6 +43,12 @@ long long gcf(long long a, long long b)
 }
 
 namespace Oasis {
+
+Expression::Expression(const Expression& other)
+    : hash(other.hash.load(std::memory_order_relaxed))
+{
+}
+
 // currently only supports polynomials of one variable.
 /**
  * The FindZeros function finds all rational zeros of a polynomial. Currently assumes an expression of the form a+bx+cx^2+dx^3+... where a, b, c, d are a integers.
@@ -233,6 +239,30 @@ auto Expression::Differentiate(const Expression& differentiationVariable) const
     return std::move(diffed).value();
 }
 
+auto Expression::GetHash() const -> std::uint64_t
+{
+    auto cached = hash.load(std::memory_order_relaxed);
+
+    if (cached == 0) {
+        // Zero marks the hash as not computed, so it is never a valid hash.
+        cached = ComputeHash();
+        cached = cached == 0 ? 1 : cached;
+        hash.store(cached, std::memory_order_relaxed);
+    }
+
+    return cached;
+}
+
+auto Expression::GetOperandAt(std::size_t) const -> const Expression*
+{
+    return nullptr;
+}
+
+auto Expression::GetOperandCount() const -> std::size_t
+{
+    return 0;
+}
+
 auto Expression::GetType() const -> ExpressionType
 {
     return ExpressionType::None;
@@ -258,11 +288,47 @@ auto Expression::IntegrateWithBounds(const Expression& variable, const Expressio
     return integral.Copy();
 }
 
+auto Expression::ComputeHash() const -> std::uint64_t
+{
+    return MixHash(static_cast<std::uint64_t>(GetType()) + 1);
+}
+
+auto Expression::InvalidateHash() -> void
+{
+    hash.store(0, std::memory_order_relaxed);
+}
+
+auto Expression::operator=(const Expression& other) -> Expression&
+{
+    hash.store(other.hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+}
+
 auto Expression::Simplify() const -> std::unique_ptr<Expression>
 {
     SimplifyVisitor sV {};
     return std::move(Accept(sV)).value();
 }
+
+auto CountNodes(const Expression& expression, std::size_t limit) -> std::size_t
+{
+    std::size_t count = 0;
+    std::vector<const Expression*> pending { &expression };
+
+    while (!pending.empty() && count < limit) {
+        const Expression* current = pending.back();
+        pending.pop_back();
+        ++count;
+
+        for (std::size_t i = 0; i < current->GetOperandCount(); ++i) {
+            if (const Expression* operand = current->GetOperandAt(i)) {
+                pending.push_back(operand);
+            }
+        }
+    }
+
+    return count;
+}
 } // namespace Oasis
 std::unique_ptr<Oasis::Expression> operator+(const std::unique_ptr<Oasis::Expression>& lhs,
     const std::unique_ptr<Oasis::Expression>& rhs)
@@ -0,0 +1,218 @@
+#include <new>
+#include <unordered_map>
+
+#include "Oasis/Add.hpp"
+#include "Oasis/CancellationToken.hpp"
+#include "Oasis/Derivative.hpp"
+#include "Oasis/Divide.hpp"
+#include "Oasis/EulerNumber.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/ExpressionArena.hpp"
+#include "Oasis/Imaginary.hpp"
+#include "Oasis/Integral.hpp"
+#include "Oasis/Log.hpp"
+#include "Oasis/Magnitude.hpp"
+#include "Oasis/Matrix.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Negate.hpp"
+#include "Oasis/Pi.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/Sine.hpp"
+#include "Oasis/Subtract.hpp"
+#include "Oasis/Undefined.hpp"
+#include "Oasis/Variable.hpp"
+#include "Oasis/Visit.hpp"
+
+namespace {
+
+thread_local Oasis::ExpressionArena* currentArena = nullptr;
+
+/**
+ * Every allocation is prefixed with a header recording where it came from, so that memory can be
+ * freed correctly regardless of which arena (if any) is current at the time.
+ */
+struct alignas(std::max_align_t) AllocationHeader {
+    bool fromArena;
+};
+
+constexpr std::size_t HEADER_SIZE = sizeof(AllocationHeader);
+
+/**
+ * Deep-copies an expression onto the heap, preserving shared operands.
+ */
+class Relocator final : public Oasis::TypedVisitor<std::shared_ptr<const Oasis::Expression>> {
+public:
+    auto Relocate(const Oasis::Expression& expression) -> RetT
+    {
+        if (const auto it = relocated.find(&expression); it != relocated.end()) {
+            return it->second;
+        }
+
+        auto copy = expression.Accept(*this);
+        if (!copy) {
+            return nullptr;
+        }
+
+        relocated.emplace(&expression, copy.value());
+        return std::move(copy).value();
+    }
+
+    auto TypedVisit(const Oasis::Real& real) -> RetT override { return RelocateLeaf(real); }
+    auto TypedVisit(const Oasis::Imaginary& imaginary) -> RetT override { return RelocateLeaf(imaginary); }
+    auto TypedVisit(const Oasis::Matrix& matrix) -> RetT override { return RelocateLeaf(matrix); }
+    auto TypedVisit(const Oasis::Variable& variable) -> RetT override { return RelocateLeaf(variable); }
+    auto TypedVisit(const Oasis::Undefined& undefined) -> RetT override { return RelocateLeaf(undefined); }
+    auto TypedVisit(const Oasis::EulerNumber& e) -> RetT override { return RelocateLeaf(e); }
+    auto TypedVisit(const Oasis::Pi& pi) -> RetT override { return RelocateLeaf(pi); }
+    auto TypedVisit(const Oasis::Add<Oasis::Expression, Oasis::Expression>& add) -> RetT override { return RelocateBinary(add); }
+    auto TypedVisit(const Oasis::Subtract<Oasis::Expression, Oasis::Expression>& subtract) -> RetT override { return RelocateBinary(subtract); }
+    auto TypedVisit(const Oasis::Multiply<Oasis::Expression, Oasis::Expression>& multiply) -> RetT override { return RelocateBinary(multiply); }
+    auto TypedVisit(const Oasis::Divide<Oasis::Expression, Oasis::Expression>& divide) -> RetT override { return RelocateBinary(divide); }
+    auto TypedVisit(const Oasis::Exponent<Oasis::Expression, Oasis::Expression>& exponent) -> RetT override { return RelocateBinary(exponent); }
+    auto TypedVisit(const Oasis::Log<Oasis::Expression, Oasis::Expression>& log) -> RetT override { return RelocateBinary(log); }
+    auto TypedVisit(const Oasis::Negate<Oasis::Expression>& negate) -> RetT override { return RelocateUnary(negate); }
+    auto TypedVisit(const Oasis::Sine<Oasis::Expression>& sine) -> RetT override { return RelocateUnary(sine); }
+    auto TypedVisit(const Oasis::Magnitude<Oasis::Expression>& magnitude) -> RetT override { return RelocateUnary(magnitude); }
+    auto TypedVisit(const Oasis::Derivative<Oasis::Expression, Oasis::Expression>& derivative) -> RetT override { return RelocateBinary(derivative); }
+    auto TypedVisit(const Oasis::Integral<Oasis::Expression, Oasis::Expression>& integral) -> RetT override { return RelocateBinary(integral); }
+
+private:
+    template <typename T>
+    static auto RelocateLeaf(const T& leaf) -> RetT
+    {
+        return Oasis::ShareOperand(std::make_unique<T>(leaf));
+    }
+
+    template <typename T>
+    auto RelocateBinary(const T& binary) -> RetT
+    {
+        auto node = std::make_unique<T>();
+
+        if (binary.HasMostSigOp()) {
+            node->SetMostSigOp(Relocate(binary.GetMostSigOp()));
+        }
+
+        if (binary.HasLeastSigOp()) {
+            node->SetLeastSigOp(Relocate(binary.GetLeastSigOp()));
+        }
+
+        return Oasis::ShareOperand(std::move(node));
+    }
+
+    template <typename T>
+    auto RelocateUnary(const T& unary) -> RetT
+    {
+        auto node = std::make_unique<T>();
+
+        if (unary.HasOperand()) {
+            node->SetOperand(Relocate(unary.GetOperand()));
+        }
+
+        return Oasis::ShareOperand(std::move(node));
+    }
+
+    std::unordered_map<const Oasis::Expression*, RetT> relocated;
+};
+
+}
+
+namespace Oasis {
+
+ExpressionArena::ExpressionArena()
+    : ExpressionArena(std::pmr::get_default_resource())
+{
+}
+
+ExpressionArena::ExpressionArena(std::pmr::memory_resource* upstream, std::size_t initialSize)
+    : resource(initialSize, upstream)
+    , previous(currentArena)
+{
+    currentArena = this;
+}
+
+ArenaSuspension::ArenaSuspension()
+    : suspended(currentArena)
+{
+    currentArena = nullptr;
+}
+
+ArenaSuspension::~ArenaSuspension()
+{
+    currentArena = suspended;
+}
+
+auto ExpressionArena::Current() -> ExpressionArena*
+{
+    return currentArena;
+}
+
+auto ExpressionArena::BytesAllocated() const -> std::size_t
+{
+    return bytesAllocated;
+}
+
+auto ExpressionArena::GetResource() -> std::pmr::memory_resource*
+{
+    return &resource;
+}
+
+auto ExpressionArena::Relocate(const Expression& expression) const -> std::unique_ptr<Expression>
+{
+    // Suspend every arena on this thread so the copy lands on the heap.
+    const ArenaSuspension suspension;
+
+    Relocator relocator;
+    const auto relocated = relocator.Relocate(expression);
+
+    // The root is shared by the relocator, so hand out a copy of it. Copies share their operands.
+    return relocated ? relocated->Copy() : nullptr;
+}
+
+ExpressionArena::~ExpressionArena()
+{
+    currentArena = previous;
+}
+
+auto AllocateExpressionMemory(std::size_t size) -> void*
+{
+    void* memory;
+    const bool fromArena = currentArena != nullptr;
+
+    if (fromArena) {
+        memory = currentArena->resource.allocate(size + HEADER_SIZE, alignof(std::max_align_t));
+        currentArena->bytesAllocated += size + HEADER_SIZE;
+    } else {
+        memory = ::operator new(size + HEADER_SIZE);
+    }
+
+    if (CancellationToken* token = CancellationToken::Current()) {
+        token->Allocate(size + HEADER_SIZE);
+    }
+
+    new (memory) AllocationHeader { fromArena };
+    return static_cast<std::byte*>(memory) + HEADER_SIZE;
+}
+
+auto DeallocateExpressionMemory(void* ptr) noexcept -> void
+{
+    if (ptr == nullptr) {
+        return;
+    }
+
+    void* memory = static_cast<std::byte*>(ptr) - HEADER_SIZE;
+    if (!static_cast<AllocationHeader*>(memory)->fromArena) {
+        ::operator delete(memory);
+    }
+}
+
+auto Expression::operator new(std::size_t size) -> void*
+{
+    return AllocateExpressionMemory(size);
+}
+
+auto Expression::operator delete(void* ptr) noexcept -> void
+{
+    DeallocateExpressionMemory(ptr);
+}
+
+} // Oasis
@@ -0,0 +1,186 @@
+#include <bit>
+#include <functional>
+
+#include "Oasis/Add.hpp"
+#include "Oasis/Derivative.hpp"
+#include "Oasis/Divide.hpp"
+#include "Oasis/EulerNumber.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/ExpressionStore.hpp"
+#include "Oasis/Imaginary.hpp"
+#include "Oasis/Integral.hpp"
+#include "Oasis/Log.hpp"
+#include "Oasis/Magnitude.hpp"
+#include "Oasis/Matrix.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Negate.hpp"
+#include "Oasis/Pi.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/Sine.hpp"
+#include "Oasis/Subtract.hpp"
+#include "Oasis/Undefined.hpp"
+#include "Oasis/Variable.hpp"
+#include "Oasis/Visit.hpp"
+
+namespace Oasis {
+
+/**
+ * Rebuilds a node on top of its interned operands and looks it up in the store.
+ */
+class ExpressionStore::Interner final : public TypedVisitor<std::shared_ptr<const Expression>> {
+public:
+    explicit Interner(ExpressionStore& store)
+        : store(store)
+    {
+    }
+
+    auto TypedVisit(const Real& real) -> RetT override
+    {
+        // Adding 0.0 folds -0.0 into 0.0, which compares equal anyway.
+        return InternLeaf(real, { .type = ExpressionType::Real, .values = { real.GetValue() + 0.0 } });
+    }
+
+    auto TypedVisit(const Imaginary& imaginary) -> RetT override { return InternLeaf(imaginary, { .type = ExpressionType::Imaginary }); }
+
+    auto TypedVisit(const Matrix& matrix) -> RetT override
+    {
+        NodeKey key { .type = ExpressionType::Matrix };
+        const MatrixXXD elements = matrix.GetMatrix();
+
+        key.values.reserve(elements.size() + 2);
+        key.values.push_back(static_cast<double>(elements.rows()));
+        key.values.push_back(static_cast<double>(elements.cols()));
+        key.values.insert(key.values.end(), elements.data(), elements.data() + elements.size());
+
+        return InternLeaf(matrix, std::move(key));
+    }
+
+    auto TypedVisit(const Variable& variable) -> RetT override { return InternLeaf(variable, { .type = ExpressionType::Variable, .symbol = variable.GetSymbol() }); }
+    auto TypedVisit(const Undefined& undefined) -> RetT override { return InternLeaf(undefined, { .type = undefined.GetType() }); }
+    auto TypedVisit(const EulerNumber& e) -> RetT override { return InternLeaf(e, { .type = ExpressionType::EulerNumber }); }
+    auto TypedVisit(const Pi& pi) -> RetT override { return InternLeaf(pi, { .type = ExpressionType::Pi }); }
+    auto TypedVisit(const Add<Expression, Expression>& add) -> RetT override { return InternBinary(add); }
+    auto TypedVisit(const Subtract<Expression, Expression>& subtract) -> RetT override { return InternBinary(subtract); }
+    auto TypedVisit(const Multiply<Expression, Expression>& multiply) -> RetT override { return InternBinary(multiply); }
+    auto TypedVisit(const Divide<Expression, Expression>& divide) -> RetT override { return InternBinary(divide); }
+    auto TypedVisit(const Exponent<Expression, Expression>& exponent) -> RetT override { return InternBinary(exponent); }
+    auto TypedVisit(const Log<Expression, Expression>& log) -> RetT override { return InternBinary(log); }
+    auto TypedVisit(const Negate<Expression>& negate) -> RetT override { return InternUnary(negate); }
+    auto TypedVisit(const Sine<Expression>& sine) -> RetT override { return InternUnary(sine); }
+    auto TypedVisit(const Magnitude<Expression>& magnitude) -> RetT override { return InternUnary(magnitude); }
+    auto TypedVisit(const Derivative<Expression, Expression>& derivative) -> RetT override { return InternBinary(derivative); }
+    auto TypedVisit(const Integral<Expression, Expression>& integral) -> RetT override { return InternBinary(integral); }
+
+private:
+    template <typename T>
+    auto InternLeaf(const T& leaf, NodeKey key) -> RetT
+    {
+        if (auto existing = store.Find(key)) {
+            return existing;
+        }
+
+        return store.Insert(std::move(key), std::make_shared<const T>(leaf));
+    }
+
+    template <typename T>
+    auto InternBinary(const T& binary) -> RetT
+    {
+        std::shared_ptr<const Expression> mostSigOp = binary.HasMostSigOp() ? store.Intern(binary.GetMostSigOp()) : nullptr;
+        std::shared_ptr<const Expression> leastSigOp = binary.HasLeastSigOp() ? store.Intern(binary.GetLeastSigOp()) : nullptr;
+
+        NodeKey key { .type = binary.GetType(), .mostSigOp = mostSigOp.get(), .leastSigOp = leastSigOp.get() };
+        if (auto existing = store.Find(key)) {
+            return existing;
+        }
+
+        auto node = std::make_shared<T>();
+        node->SetMostSigOp(std::move(mostSigOp));
+        node->SetLeastSigOp(std::move(leastSigOp));
+
+        return store.Insert(std::move(key), std::move(node));
+    }
+
+    template <typename T>
+    auto InternUnary(const T& unary) -> RetT
+    {
+        std::shared_ptr<const Expression> operand = unary.HasOperand() ? store.Intern(unary.GetOperand()) : nullptr;
+
+        NodeKey key { .type = unary.GetType(), .mostSigOp = operand.get() };
+        if (auto existing = store.Find(key)) {
+            return existing;
+        }
+
+        auto node = std::make_shared<T>();
+        node->SetOperand(std::move(operand));
+
+        return store.Insert(std::move(key), std::move(node));
+    }
+
+    ExpressionStore& store;
+};
+
+auto ExpressionStore::Intern(const Expression& expression) -> std::shared_ptr<const Expression>
+{
+    // Subtrees of previously interned expressions are already canonical.
+    if (const auto it = nodes.find(&expression); it != nodes.end()) {
+        return it->second;
+    }
+
+    Interner interner { *this };
+    auto interned = expression.Accept(interner);
+    if (!interned) {
+        return expression.Copy();
+    }
+
+    return std::move(interned).value();
+}
+
+auto ExpressionStore::Contains(const Expression& expression) const -> bool
+{
+    return nodes.contains(&expression);
+}
+
+auto ExpressionStore::Size() const -> std::size_t
+{
+    return nodes.size();
+}
+
+auto ExpressionStore::Clear() -> void
+{
+    nodesByKey.clear();
+    nodes.clear();
+}
+
+auto ExpressionStore::Find(const NodeKey& key) const -> std::shared_ptr<const Expression>
+{
+    const auto it = nodesByKey.find(key);
+    if (it == nodesByKey.end()) {
+        return nullptr;
+    }
+
+    return nodes.at(it->second);
+}
+
+auto ExpressionStore::Insert(NodeKey key, std::shared_ptr<const Expression> node) -> std::shared_ptr<const Expression>
+{
+    nodesByKey.emplace(std::move(key), node.get());
+    nodes.emplace(node.get(), node);
+    return node;
+}
+
+auto ExpressionStore::NodeKeyHash::operator()(const NodeKey& key) const -> std::size_t
+{
+    std::uint64_t seed = static_cast<std::uint64_t>(key.type);
+
+    for (const double value : key.values) {
+        seed = CombineHash(seed, std::bit_cast<std::uint64_t>(value));
+    }
+
+    seed = CombineHash(seed, key.symbol);
+    seed = CombineHash(seed, reinterpret_cast<std::uintptr_t>(key.mostSigOp));
+    seed = CombineHash(seed, reinterpret_cast<std::uintptr_t>(key.leastSigOp));
+
+    return seed;
+}
+
+} // Oasis
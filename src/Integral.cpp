@@ -14,6 +14,11 @@ Integral<Expression>::Integral(const Expression& integrand, const Expression& di
 {
 }
 
+Integral<Expression>::Integral(std::unique_ptr<Expression>&& integrand, std::unique_ptr<Expression>&& differential)
+    : BinaryExpression(std::move(integrand), std::move(differential))
+{
+}
+
 auto Integral<Expression, Expression>::IntegrateWithBounds(const Expression& lower, const Expression& upper) const -> std::unique_ptr<Expression>
 {
     // If the bounds are equal, then the integral will always return 0.
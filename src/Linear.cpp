@@ -57,7 +57,7 @@ auto ConstructMatrices(const std::vector<std::unique_ptr<Expression>>& exprs)
     }
 
     size_t varCount = 0;
-    std::map<std::string, Eigen::Index> vars; // variable name, column in matrix
+    std::map<SymbolId, Eigen::Index> columns; // variable symbol, column in matrix
     for (size_t row = 0; row < exprs.size(); row++) {
         std::vector<std::unique_ptr<Expression>> terms;
         auto expr = RecursiveCast<Add<Expression>>(*exprs[row]);
@@ -66,14 +66,14 @@ auto ConstructMatrices(const std::vector<std::unique_ptr<Expression>>& exprs)
             if (auto r = RecursiveCast<Real>(*term); r != nullptr) { // real number
                 b[Eigen::Index(row)] = -1 * r->GetValue();
             } else if (auto v = RecursiveCast<Variable>(*term); v != nullptr) { // variable by itself (coefficient of 1)
-                std::pair<size_t, bool> keyloc = GetMapValue<std::string, Eigen::Index>(vars, v->GetName(), varCount);
+                std::pair<size_t, bool> keyloc = GetMapValue<SymbolId, Eigen::Index>(columns, v->GetSymbol(), varCount);
                 if (keyloc.second)
                     varCount++;
                 A(Eigen::Index(row), Eigen::Index(keyloc.first)) = 1;
             } else if (auto exprV = RecursiveCast<Multiply<Real, Variable>>(*term); exprV != nullptr) {
                 // any expression times a variable
-                std::pair<size_t, bool> keyloc = GetMapValue<std::string, Eigen::Index>(vars,
-                    exprV->GetLeastSigOp().GetName(),
+                std::pair<size_t, bool> keyloc = GetMapValue<SymbolId, Eigen::Index>(columns,
+                    exprV->GetLeastSigOp().GetSymbol(),
                     varCount);
                 if (keyloc.second)
                     varCount++;
@@ -82,6 +82,11 @@ auto ConstructMatrices(const std::vector<std::unique_ptr<Expression>>& exprs)
         }
     }
 
+    std::map<std::string, Eigen::Index> vars; // variable name, column in matrix
+    for (const auto& [symbol, column] : columns) {
+        vars.emplace(SymbolTable::Global().GetName(symbol), column);
+    }
+
     return std::make_pair(std::make_pair(A, b), vars);
 }
 
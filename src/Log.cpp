@@ -6,6 +6,7 @@
 #include <cmath>
 
 #include "Oasis/Add.hpp"
+#include "Oasis/CancellationToken.hpp"
 #include "Oasis/Derivative.hpp"
 #include "Oasis/Divide.hpp"
 #include "Oasis/EulerNumber.hpp"
@@ -27,8 +28,17 @@ Log<Expression>::Log(const Expression& base, const Expression& argument)
 {
 }
 
+Log<Expression>::Log(std::unique_ptr<Expression>&& base, std::unique_ptr<Expression>&& argument)
+    : BinaryExpression(std::move(base), std::move(argument))
+{
+}
+
 auto Log<Expression>::Integrate(const Oasis::Expression& integrationVariable) const -> std::unique_ptr<Expression>
 {
+    if (CheckCancellation()) {
+        return Integral<Expression> { *this, integrationVariable }.Generalize();
+    }
+
     // TODO: Implement with integrate visitor?
     SimplifyVisitor simplifyVisitor {};
     if (this->mostSigOp->Equals(EulerNumber {})) {
@@ -1,6 +1,8 @@
 //
 // Created by Andrew Nazareth on 5/24/24.
 //
+#include <bit>
+
 #include "Oasis/Matrix.hpp"
 #include "Oasis/Integral.hpp"
 #include "Oasis/Real.hpp"
@@ -38,6 +40,18 @@ auto Matrix::Equals(const Expression& other) const -> bool
         && matrix == dynamic_cast<const Matrix&>(other).matrix;
 }
 
+auto Matrix::ComputeHash() const -> std::uint64_t
+{
+    std::uint64_t seed = CombineHash(Expression::ComputeHash(), matrix.rows());
+    seed = CombineHash(seed, matrix.cols());
+
+    for (Eigen::Index i = 0; i < matrix.size(); ++i) {
+        seed = CombineHash(seed, std::bit_cast<std::uint64_t>(matrix.data()[i] + 0.0));
+    }
+
+    return seed;
+}
+
 auto Matrix::GetMatrix() const -> MatrixXXD
 {
     return matrix;
@@ -4,6 +4,7 @@
 
 #include "Oasis/Multiply.hpp"
 #include "Oasis/Add.hpp"
+#include "Oasis/CancellationToken.hpp"
 #include "Oasis/Divide.hpp"
 #include "Oasis/EulerNumber.hpp"
 #include "Oasis/Exponent.hpp"
@@ -19,6 +20,10 @@
 namespace Oasis {
 auto Multiply<Expression>::Integrate(const Expression& integrationVariable) const -> std::unique_ptr<Expression>
 {
+    if (CheckCancellation()) {
+        return Integral<Expression> { *this, integrationVariable }.Generalize();
+    }
+
     SimplifyVisitor simplifyVisitor {};
     // Single integration variable
     if (auto variable = RecursiveCast<Variable>(integrationVariable); variable != nullptr) {
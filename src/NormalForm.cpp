@@ -0,0 +1,34 @@
+#include "Oasis/NormalForm.hpp"
+#include "Oasis/SimplifyCache.hpp"
+
+namespace Oasis {
+
+auto SimplifyToNormalForm(const Expression& expression, const NormalFormOpts& opts) -> std::expected<NormalFormResult, std::string>
+{
+    const auto cache = std::make_shared<SimplifyCache>(opts.cacheCapacity);
+    SimplifyVisitor simplifyVisitor { opts.simplifyOpts, cache };
+
+    NormalFormResult result { expression.Copy() };
+
+    while (result.passes < opts.maxPasses && cache->GetMisses() < opts.maxSimplifications) {
+        auto simplifiedResult = result.expression->Accept(simplifyVisitor);
+        if (!simplifiedResult) {
+            return std::unexpected { simplifiedResult.error() };
+        }
+
+        std::unique_ptr<Expression> simplified = std::move(simplifiedResult).value();
+        ++result.passes;
+
+        result.converged = simplified->Equals(*result.expression);
+        result.expression = std::move(simplified);
+
+        if (result.converged) {
+            break;
+        }
+    }
+
+    result.simplifications = cache->GetMisses();
+    return result;
+}
+
+} // Oasis
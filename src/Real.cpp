@@ -2,6 +2,7 @@
 // Created by Matthew McCall on 7/2/23.
 //
 
+#include <bit>
 #include <string>
 
 #include "Oasis/Add.hpp"
@@ -23,6 +24,12 @@ auto Real::Equals(const Expression& other) const -> bool
     return other.Is<Real>() && value == dynamic_cast<const Real&>(other).value;
 }
 
+auto Real::ComputeHash() const -> std::uint64_t
+{
+    // Adding 0.0 folds -0.0 into 0.0, since the two compare equal.
+    return CombineHash(Expression::ComputeHash(), std::bit_cast<std::uint64_t>(value + 0.0));
+}
+
 auto Real::GetValue() const -> double
 {
     return value;
@@ -36,7 +43,7 @@ auto Real::Integrate(const Expression& integrationVariable) const -> std::unique
         if (value != 0) {
 
             Add adder {
-                Multiply<Real, Variable> { Real { value }, Variable { (*variable).GetName() } },
+                Multiply<Real, Variable> { Real { value }, *variable },
                 Variable { "C" }
             };
 
@@ -0,0 +1,47 @@
+#include <algorithm>
+
+#include "Oasis/RuleProfiler.hpp"
+
+namespace Oasis {
+
+auto RuleProfiler::Record(std::string_view rule, bool hit, std::chrono::nanoseconds matchTime, std::chrono::nanoseconds transformTime) -> void
+{
+    auto it = stats.find(rule);
+    if (it == stats.end()) {
+        it = stats.emplace(std::string { rule }, RuleStats { .name = std::string { rule } }).first;
+    }
+
+    RuleStats& ruleStats = it->second;
+    ++ruleStats.attempts;
+    ruleStats.matchTime += matchTime;
+
+    if (hit) {
+        ++ruleStats.hits;
+        ruleStats.transformTime += transformTime;
+    }
+}
+
+auto RuleProfiler::GetStats() const -> std::vector<RuleStats>
+{
+    std::vector<RuleStats> result;
+    result.reserve(stats.size());
+
+    for (const auto& [name, ruleStats] : stats) {
+        result.push_back(ruleStats);
+    }
+
+    std::ranges::sort(result, [](const RuleStats& a, const RuleStats& b) {
+        const auto aTime = a.matchTime + a.transformTime;
+        const auto bTime = b.matchTime + b.transformTime;
+        return aTime != bTime ? aTime > bTime : a.name < b.name;
+    });
+
+    return result;
+}
+
+auto RuleProfiler::Reset() -> void
+{
+    stats.clear();
+}
+
+} // Oasis
@@ -0,0 +1,60 @@
+#include <optional>
+
+#include "Oasis/ExpressionArena.hpp"
+#include "Oasis/SimplifyBatch.hpp"
+
+namespace Oasis {
+
+auto SimplifyBatchMetrics::GetThroughput() const -> double
+{
+    const auto seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0.0 ? static_cast<double>(expressions) / seconds : 0.0;
+}
+
+auto SimplifyBatch(std::span<const Expression* const> expressions, const SimplifyOpts& opts, const SimplifyBatchOpts& batchOpts) -> SimplifyBatchResult
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto pool = batchOpts.threadPool ? batchOpts.threadPool : ThreadPool::GetDefault();
+    const auto cache = batchOpts.cache ? batchOpts.cache : std::make_shared<SimplifyCache>(batchOpts.cacheCapacity, batchOpts.cacheShards);
+    const auto hits = cache->GetHits();
+    const auto misses = cache->GetMisses();
+
+    // Each expression is simplified into its own slot, so results keep the order of their inputs
+    // however the chunks are scheduled.
+    std::vector<std::optional<SimplifyVisitor::RetT>> simplified(expressions.size());
+
+    pool->ParallelFor(expressions.size(), batchOpts.grainSize, [&](std::size_t begin, std::size_t end) {
+        // The first chunk runs on the calling thread, whose arena may not outlive the cache.
+        const ArenaSuspension suspension;
+        SimplifyVisitor simplifyVisitor { opts, cache };
+
+        for (std::size_t i = begin; i < end; ++i) {
+            if (expressions[i] == nullptr) {
+                simplified[i].emplace(std::unexpected { "Missing expression." });
+                continue;
+            }
+            simplified[i].emplace(expressions[i]->Accept(simplifyVisitor));
+        }
+    });
+
+    SimplifyBatchResult result;
+    result.results.reserve(expressions.size());
+
+    for (std::optional<SimplifyVisitor::RetT>& expression : simplified) {
+        if (!*expression) {
+            ++result.metrics.failures;
+        }
+        result.results.push_back(std::move(*expression));
+    }
+
+    result.metrics.expressions = expressions.size();
+    result.metrics.threads = pool->GetThreadCount();
+    result.metrics.cacheHits = cache->GetHits() - hits;
+    result.metrics.cacheMisses = cache->GetMisses() - misses;
+    result.metrics.elapsed = std::chrono::steady_clock::now() - start;
+
+    return result;
+}
+
+} // Oasis
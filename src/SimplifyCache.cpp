@@ -0,0 +1,116 @@
+#include <algorithm>
+
+#include "Oasis/SimplifyCache.hpp"
+
+namespace Oasis {
+
+SimplifyCache::SimplifyCache(std::size_t capacity, std::size_t shardCount)
+    : capacity(capacity)
+{
+    shardCount = std::max<std::size_t>(shardCount, 1);
+    shards.reserve(shardCount);
+
+    // The capacity is divided as evenly as possible, so that the shards hold capacity in total.
+    for (std::size_t i = 0; i < shardCount; ++i) {
+        auto& shard = *shards.emplace_back(std::make_unique<Shard>());
+        shard.capacity = capacity / shardCount + (i < capacity % shardCount ? 1 : 0);
+    }
+}
+
+auto SimplifyCache::Find(const Expression& expression, std::uint64_t context) -> std::shared_ptr<const Expression>
+{
+    const auto key = GetKey(expression, context);
+    Shard& shard = GetShard(key);
+    std::lock_guard lock { shard.mutex };
+
+    const auto it = shard.entriesByKey.find(key);
+
+    if (it == shard.entriesByKey.end() || it->second->context != context || !it->second->expression->Equals(expression)) {
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    hits.fetch_add(1, std::memory_order_relaxed);
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    return it->second->simplified;
+}
+
+auto SimplifyCache::Insert(const Expression& expression, std::uint64_t context, const Expression& simplified) -> void
+{
+    const auto key = GetKey(expression, context);
+    Shard& shard = GetShard(key);
+
+    if (shard.capacity == 0) {
+        return;
+    }
+
+    // Copied before locking, so that other threads are not kept waiting on the copies.
+    Entry entry { key, context, expression.Copy(), simplified.Copy() };
+    std::lock_guard lock { shard.mutex };
+
+    // On a collision, the newer entry replaces the older one.
+    if (const auto it = shard.entriesByKey.find(key); it != shard.entriesByKey.end()) {
+        shard.entries.erase(it->second);
+        shard.entriesByKey.erase(it);
+    }
+
+    if (shard.entries.size() == shard.capacity) {
+        shard.entriesByKey.erase(shard.entries.back().key);
+        shard.entries.pop_back();
+    }
+
+    shard.entries.push_front(std::move(entry));
+    shard.entriesByKey.emplace(key, shard.entries.begin());
+}
+
+auto SimplifyCache::Clear() -> void
+{
+    for (const auto& shard : shards) {
+        std::lock_guard lock { shard->mutex };
+        shard->entries.clear();
+        shard->entriesByKey.clear();
+    }
+}
+
+auto SimplifyCache::GetCapacity() const -> std::size_t
+{
+    return capacity;
+}
+
+auto SimplifyCache::GetHits() const -> std::size_t
+{
+    return hits.load(std::memory_order_relaxed);
+}
+
+auto SimplifyCache::GetMisses() const -> std::size_t
+{
+    return misses.load(std::memory_order_relaxed);
+}
+
+auto SimplifyCache::GetShardCount() const -> std::size_t
+{
+    return shards.size();
+}
+
+auto SimplifyCache::Size() const -> std::size_t
+{
+    std::size_t size = 0;
+    for (const auto& shard : shards) {
+        std::lock_guard lock { shard->mutex };
+        size += shard->entries.size();
+    }
+    return size;
+}
+
+auto SimplifyCache::GetKey(const Expression& expression, std::uint64_t context) -> std::uint64_t
+{
+    return CombineHash(expression.GetHash(), context);
+}
+
+auto SimplifyCache::GetShard(std::uint64_t key) const -> Shard&
+{
+    // The low bits of the key index the buckets of each shard, so the high bits pick the shard.
+    return *shards[(key >> 32) % shards.size()];
+}
+
+} // Oasis
@@ -2,11 +2,20 @@
 // Created by Andrew Nazareth on 9/23/25.
 //
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
 #include <format>
+#include <map>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
 
 #include "Oasis/SimplifyVisitor.hpp"
 
 #include "Oasis/Add.hpp"
+#include "Oasis/CancellationToken.hpp"
 #include "Oasis/Derivative.hpp"
 #include "Oasis/Divide.hpp"
 #include "Oasis/EulerNumber.hpp"
@@ -14,11 +23,14 @@
 #include "Oasis/Integral.hpp"
 #include "Oasis/Log.hpp"
 #include "Oasis/Magnitude.hpp"
+#include "Oasis/Match.hpp"
 #include "Oasis/MatchCast.hpp"
 #include "Oasis/Multiply.hpp"
 #include "Oasis/Negate.hpp"
 #include "Oasis/Pi.hpp"
 #include "Oasis/Real.hpp"
+#include "Oasis/RecursiveCast.hpp"
+#include "Oasis/RuleProfiler.hpp"
 #include "Oasis/Sine.hpp"
 #include "Oasis/Subtract.hpp"
 #include "Oasis/Undefined.hpp"
@@ -26,6 +38,94 @@
 
 namespace {
 constexpr auto EPSILON = std::numeric_limits<float>::epsilon();
+
+// The deepest level of a tree at which the operands of an expression may be simplified concurrently.
+constexpr std::size_t MAX_PARALLEL_DEPTH = 8;
+
+// Neumaier's compensated sum, so that summing many coefficients does not accumulate rounding error.
+class CompensatedSum {
+public:
+    auto operator+=(double value) -> CompensatedSum&
+    {
+        const double total = sum + value;
+        compensation += std::abs(sum) >= std::abs(value) ? (sum - total) + value : (value - total) + sum;
+        sum = total;
+        return *this;
+    }
+
+    [[nodiscard]] auto Get() const -> double
+    {
+        return sum + compensation;
+    }
+
+private:
+    double sum = 0.0;
+    double compensation = 0.0;
+};
+
+// Records a rule with a RuleProfiler for the lifetime of the scope it is declared in. The time
+// spent in Match is attributed to matching the rule, and the rest of the scope to transforming the
+// expression if it matched. Without OASIS_PROFILE_RULES, it reduces to a RecursiveCast.
+class RuleScope {
+public:
+    RuleScope(Oasis::RuleProfiler* profiler, std::string_view rule)
+        : profiler(profiler)
+        , rule(rule)
+    {
+    }
+
+    RuleScope(const RuleScope&) = delete;
+    auto operator=(const RuleScope&) -> RuleScope& = delete;
+
+    template <typename T>
+    auto Match(const Oasis::Expression& expression) -> std::unique_ptr<T>
+    {
+        if constexpr (!Oasis::RuleProfiler::Enabled) {
+            return Oasis::RecursiveCast<T>(expression);
+        } else {
+            if (profiler == nullptr) {
+                return Oasis::RecursiveCast<T>(expression);
+            }
+
+            const auto matchStart = Clock::now();
+            auto result = Oasis::RecursiveCast<T>(expression);
+            matchEnd = Clock::now();
+
+            attempted = true;
+            hit = result != nullptr;
+            matchTime = matchEnd - matchStart;
+            return result;
+        }
+    }
+
+    // Records a rule that has no pattern and always applies, such as collecting like terms.
+    auto Apply() -> void
+    {
+        if constexpr (Oasis::RuleProfiler::Enabled) {
+            attempted = hit = profiler != nullptr;
+            matchEnd = Clock::now();
+        }
+    }
+
+    ~RuleScope()
+    {
+        if constexpr (Oasis::RuleProfiler::Enabled) {
+            if (attempted) {
+                profiler->Record(rule, hit, matchTime, hit ? Clock::now() - matchEnd : std::chrono::nanoseconds {});
+            }
+        }
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Oasis::RuleProfiler* profiler;
+    std::string_view rule;
+    bool attempted = false;
+    bool hit = false;
+    std::chrono::nanoseconds matchTime {};
+    Clock::time_point matchEnd {};
+};
 }
 
 namespace Oasis {
@@ -33,10 +133,19 @@ namespace Oasis {
 SimplifyVisitor::SimplifyVisitor()
 {
     options = SimplifyOpts {};
+    ruleGroups = options.ruleGroups;
 }
 
 SimplifyVisitor::SimplifyVisitor(SimplifyOpts& opts)
     : options(opts)
+    , ruleGroups(opts.ruleGroups)
+{
+}
+
+SimplifyVisitor::SimplifyVisitor(const SimplifyOpts& opts, std::shared_ptr<SimplifyCache> cache)
+    : options(opts)
+    , ruleGroups(opts.ruleGroups)
+    , cache(std::move(cache))
 {
 }
 
@@ -45,6 +154,252 @@ SimplifyOpts SimplifyVisitor::GetOptions() const
     return options;
 }
 
+auto SimplifyVisitor::GetCache() const -> std::shared_ptr<SimplifyCache>
+{
+    return cache;
+}
+
+auto SimplifyVisitor::SetProfiler(std::shared_ptr<RuleProfiler> ruleProfiler) -> void
+{
+    profiler = std::move(ruleProfiler);
+}
+
+auto SimplifyVisitor::GetProfiler() const -> std::shared_ptr<RuleProfiler>
+{
+    return profiler;
+}
+
+auto SimplifyVisitor::SetThreadPool(std::shared_ptr<ThreadPool> pool, std::size_t threshold) -> void
+{
+    threadPool = std::move(pool);
+    parallelThreshold = threshold;
+}
+
+auto SimplifyVisitor::GetThreadPool() const -> std::shared_ptr<ThreadPool>
+{
+    return threadPool;
+}
+
+auto SimplifyVisitor::IsParallel(std::span<const Expression* const> operands) const -> bool
+{
+    // Below the first few levels there are already enough tasks to keep the pool busy, so larger
+    // subexpressions deep in a tree are not counted again.
+    if (!threadPool || operands.size() < 2 || depth > MAX_PARALLEL_DEPTH) {
+        return false;
+    }
+
+    std::size_t nodes = 0;
+    for (const Expression* operand : operands) {
+        nodes += CountNodes(*operand, parallelThreshold - nodes);
+        if (nodes >= parallelThreshold) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+auto SimplifyVisitor::Fork() const -> SimplifyVisitor
+{
+    SimplifyVisitor forked { options, cache };
+    forked.ruleGroups = ruleGroups;
+    forked.depth = depth;
+    forked.threadPool = threadPool;
+    forked.parallelThreshold = parallelThreshold;
+    return forked;
+}
+
+auto SimplifyVisitor::SimplifyOperands(const Expression& mostSigOp, const Expression& leastSigOp) -> std::pair<RetT, RetT>
+{
+    if (const std::array<const Expression*, 2> operands { &mostSigOp, &leastSigOp }; IsParallel(operands)) {
+        return threadPool->ParallelInvoke(
+            [this, &mostSigOp] { return mostSigOp.Accept(*this); },
+            [forked = Fork(), &leastSigOp]() mutable { return leastSigOp.Accept(forked); });
+    }
+
+    auto simplifiedMostSigOp = mostSigOp.Accept(*this);
+    return { std::move(simplifiedMostSigOp), leastSigOp.Accept(*this) };
+}
+
+auto SimplifyVisitor::SimplifyOperands(std::span<const Expression* const> operands) -> std::vector<RetT>
+{
+    std::vector<RetT> simplified;
+    simplified.reserve(operands.size());
+
+    if (!IsParallel(operands)) {
+        for (const Expression* operand : operands) {
+            simplified.push_back(operand->Accept(*this));
+        }
+        return simplified;
+    }
+
+    std::vector<std::optional<RetT>> results(operands.size());
+    threadPool->ParallelFor(operands.size(), 1, [this, operands, &results](std::size_t begin, std::size_t end) {
+        SimplifyVisitor forked = Fork();
+        for (std::size_t i = begin; i < end; ++i) {
+            results[i].emplace(operands[i]->Accept(forked));
+        }
+    });
+
+    for (std::optional<RetT>& result : results) {
+        simplified.push_back(std::move(*result));
+    }
+    return simplified;
+}
+
+auto DetectRuleGroups(const Expression& expression) -> SimplifyOpts::RuleGroups
+{
+    SimplifyOpts::RuleGroups groups { .matrix = false, .complex = false, .logarithm = false, .trig = false, .calculus = false };
+
+    std::vector<const Expression*> pending { &expression };
+    while (!pending.empty()) {
+        const Expression* current = pending.back();
+        pending.pop_back();
+
+        switch (current->GetType()) {
+        case ExpressionType::Matrix:
+            groups.matrix = true;
+            break;
+        case ExpressionType::Imaginary:
+        case ExpressionType::Sqrt:
+            groups.complex = true;
+            break;
+        case ExpressionType::Exponent:
+            // Any power but an integer may take the root of a negative number
+            if (const Expression* power = current->GetOperandAt(1); power != nullptr) {
+                const auto* realPower = power->Is<Real>() ? static_cast<const Real*>(power) : nullptr;
+                groups.complex |= realPower == nullptr || std::floor(realPower->GetValue()) != realPower->GetValue();
+            }
+            break;
+        case ExpressionType::Log:
+            groups.logarithm = true;
+            break;
+        case ExpressionType::Sine:
+            groups.trig = true;
+            break;
+        case ExpressionType::Derivative:
+        case ExpressionType::Integral:
+        case ExpressionType::Limit:
+            // Derivatives and integrals may introduce expressions of any type, such as logarithms
+            return {};
+        default:
+            break;
+        }
+
+        for (std::size_t i = 0; i < current->GetOperandCount(); ++i) {
+            if (const Expression* operand = current->GetOperandAt(i)) {
+                pending.push_back(operand);
+            }
+        }
+    }
+
+    return groups;
+}
+
+template <typename T>
+auto SimplifyVisitor::Memoize(const T& expression) -> RetT
+{
+    // Once the current CancellationToken expires, the rest of the expression is left as it is.
+    if (CheckCancellation()) {
+        return gsl_lite::not_null { expression.Copy() };
+    }
+
+    // The groups of rules are detected once for the outermost expression, which contains every
+    // other expression this visit simplifies.
+    if (depth == 0 && options.detectRuleGroups) {
+        const auto detected = DetectRuleGroups(expression);
+        ruleGroups = {
+            .matrix = options.ruleGroups.matrix && detected.matrix,
+            .complex = options.ruleGroups.complex && detected.complex,
+            .logarithm = options.ruleGroups.logarithm && detected.logarithm,
+            .trig = options.ruleGroups.trig && detected.trig,
+            .calculus = options.ruleGroups.calculus && detected.calculus,
+        };
+    }
+
+    // Every option is encoded exactly, so entries made with different options never collide. Rule
+    // groups are encoded as they are after detection, since that is what the result depends on.
+    const auto groups = static_cast<std::uint64_t>(ruleGroups.matrix)
+        | static_cast<std::uint64_t>(ruleGroups.complex) << 1
+        | static_cast<std::uint64_t>(ruleGroups.logarithm) << 2
+        | static_cast<std::uint64_t>(ruleGroups.trig) << 3
+        | static_cast<std::uint64_t>(ruleGroups.calculus) << 4;
+    const auto context = (groups << 16) | (static_cast<std::uint64_t>(options.angleUnits) << 8) | static_cast<std::uint64_t>(options.distributivePolicy);
+
+    if (cache) {
+        if (const auto cached = cache->Find(expression, context); cached != nullptr) {
+            return gsl_lite::not_null { cached->Copy() };
+        }
+    }
+
+    ++depth;
+    auto simplified = Simplify(expression);
+    --depth;
+
+    // A result reached after the current token expired may be partial, so it is not cached.
+    const CancellationToken* token = CancellationToken::Current();
+    if (cache && simplified && (token == nullptr || !token->IsCancelled())) {
+        cache->Insert(expression, context, **simplified);
+    }
+
+    return simplified;
+}
+
+auto SimplifyVisitor::TypedVisit(const Add<>& add) -> RetT
+{
+    return Memoize(add);
+}
+
+auto SimplifyVisitor::TypedVisit(const Subtract<>& subtract) -> RetT
+{
+    return Memoize(subtract);
+}
+
+auto SimplifyVisitor::TypedVisit(const Multiply<>& multiply) -> RetT
+{
+    return Memoize(multiply);
+}
+
+auto SimplifyVisitor::TypedVisit(const Divide<>& divide) -> RetT
+{
+    return Memoize(divide);
+}
+
+auto SimplifyVisitor::TypedVisit(const Exponent<>& exponent) -> RetT
+{
+    return Memoize(exponent);
+}
+
+auto SimplifyVisitor::TypedVisit(const Log<>& logIn) -> RetT
+{
+    return Memoize(logIn);
+}
+
+auto SimplifyVisitor::TypedVisit(const Negate<Expression>& negate) -> RetT
+{
+    return Memoize(negate);
+}
+
+auto SimplifyVisitor::TypedVisit(const Sine<Expression>& sine) -> RetT
+{
+    return Memoize(sine);
+}
+
+auto SimplifyVisitor::TypedVisit(const Derivative<>& derivative) -> RetT
+{
+    return Memoize(derivative);
+}
+
+auto SimplifyVisitor::TypedVisit(const Integral<>& integral) -> RetT
+{
+    return Memoize(integral);
+}
+
+auto SimplifyVisitor::TypedVisit(const Magnitude<Expression>& magnitude) -> RetT
+{
+    return Memoize(magnitude);
+}
+
 auto SimplifyVisitor::TypedVisit(const Real& real) -> RetT
 {
     return gsl_lite::not_null { std::make_unique<Real>(real) };
@@ -65,284 +420,227 @@ auto SimplifyVisitor::TypedVisit(const Undefined&) -> RetT
     return gsl_lite::not_null { std::make_unique<Undefined>() };
 }
 
-auto SimplifyVisitor::TypedVisit(const Add<>& add) -> RetT
+auto SimplifyVisitor::Simplify(const Add<>& add) -> RetT
 {
-    auto mostSigOp = add.GetMostSigOp().Copy();
-    auto leastSigOp = add.GetLeastSigOp().Copy();
-    if (!mostSigOp) {
+    if (!add.HasMostSigOp()) {
         return std::unexpected { "Missing most significant operand." };
     }
-    if (!leastSigOp) {
+    if (!add.HasLeastSigOp()) {
         return std::unexpected { "Missing least significant operand." };
     }
 
-    auto simplifiedAugendResult = mostSigOp->Accept(*this);
-    auto simplifiedAddendResult = leastSigOp->Accept(*this);
-
-    if (!simplifiedAugendResult) {
-        return std::unexpected { simplifiedAugendResult.error() };
-    }
-    if (!simplifiedAddendResult) {
-        return std::unexpected { simplifiedAddendResult.error() };
-    }
-
-    auto simplifiedAugend = std::move(simplifiedAugendResult).value();
-    auto simplifiedAddend = std::move(simplifiedAddendResult).value();
+    // The whole sum is flattened before it is simplified, so that like terms are collected once
+    // for the sum rather than once for every Add nested in it.
+    std::vector<const Expression*> addends;
+    add.Flatten(addends);
 
-    Add simplifiedAdd { *simplifiedAugend, *simplifiedAddend };
+    std::vector<std::unique_ptr<Expression>> simplifiedAddends;
+    std::vector<const Expression*> adds;
+    simplifiedAddends.reserve(addends.size());
 
-    if (auto realCase = RecursiveCast<Add<Real>>(simplifiedAdd); realCase != nullptr) {
-        const Real& firstReal = realCase->GetMostSigOp();
-        const Real& secondReal = realCase->GetLeastSigOp();
+    for (auto& simplifiedResult : SimplifyOperands(addends)) {
+        if (!simplifiedResult) {
+            return std::unexpected { simplifiedResult.error() };
+        }
 
-        return gsl_lite::not_null { std::make_unique<Real>(firstReal.GetValue() + secondReal.GetValue()) };
-    }
+        const Expression& simplified = *simplifiedAddends.emplace_back(std::move(simplifiedResult).value());
 
-    if (auto zeroCase = RecursiveCast<Add<Real, Expression>>(simplifiedAdd); zeroCase != nullptr) {
-        if (zeroCase->GetMostSigOp().GetValue() == 0) {
-            return gsl_lite::not_null { zeroCase->GetLeastSigOp().Generalize() };
+        if (!simplified.Is<Add>()) {
+            adds.push_back(&simplified);
+        } else if (const auto* sum = dynamic_cast<const Add<>*>(&simplified)) {
+            sum->Flatten(adds);
+        } else {
+            // Generalizing shares the operands, so they are still owned by simplifiedAddends.
+            static_cast<const Add<>&>(*simplified.Generalize()).Flatten(adds);
         }
     }
 
-    if (auto likeTermsCase = RecursiveCast<Add<Multiply<Real, Expression>>>(simplifiedAdd); likeTermsCase != nullptr) {
-        const Oasis::IExpression auto& leftTerm = likeTermsCase->GetMostSigOp().GetLeastSigOp();
-        const Oasis::IExpression auto& rightTerm = likeTermsCase->GetLeastSigOp().GetLeastSigOp();
+    RuleScope rule { profiler.get(), "Add: collect like terms" };
+    rule.Apply();
 
-        if (leftTerm.Equals(rightTerm)) {
-            const Real& coefficient1 = likeTermsCase->GetMostSigOp().GetMostSigOp();
-            const Real& coefficient2 = likeTermsCase->GetLeastSigOp().GetMostSigOp();
+    // log(a) + log(b) = log(ab), and matrix + matrix for matrices of the same dimensions. Merged
+    // terms take the place of the first term they were merged from.
+    struct MergedTerms {
+        std::size_t index = 0;
+        std::vector<const Expression*> terms {};
+    };
 
-            return gsl_lite::not_null { std::make_unique<Multiply<Expression>>(Real(coefficient1.GetValue() + coefficient2.GetValue()), leftTerm) };
+    std::vector<std::unique_ptr<Expression>> mergedAddends;
+    std::unordered_map<const Expression*, MergedTerms, ExpressionHash, ExpressionEqual> logsByBase;
+    std::map<std::pair<size_t, size_t>, MergedTerms> matricesBySize;
+    std::vector<const Expression*> terms;
+    terms.reserve(adds.size());
+
+    for (const Expression* addend : adds) {
+        if (auto logCase = ruleGroups.logarithm ? Match<Log<>>(*addend) : std::nullopt) {
+            const auto [it, inserted] = logsByBase.try_emplace(&logCase->GetMostSigOp(), MergedTerms { terms.size() });
+            it->second.terms.push_back(&logCase->GetLeastSigOp());
+            if (!inserted) {
+                continue;
+            }
+        } else if (ruleGroups.matrix && addend->Is<Matrix>()) {
+            const auto& matrix = static_cast<const Matrix&>(*addend);
+            const auto [it, inserted] = matricesBySize.try_emplace({ matrix.GetRows(), matrix.GetCols() }, MergedTerms { terms.size() });
+            it->second.terms.push_back(addend);
+            if (!inserted) {
+                continue;
+            }
         }
+        terms.push_back(addend);
     }
 
-    // matrix + matrix
-    if (auto matrixCase = RecursiveCast<Add<Matrix, Matrix>>(simplifiedAdd); matrixCase != nullptr) {
-        const Oasis::IExpression auto& leftTerm = matrixCase->GetMostSigOp();
-        const Oasis::IExpression auto& rightTerm = matrixCase->GetLeastSigOp();
-
-        if ((leftTerm.GetRows() == rightTerm.GetRows()) && (leftTerm.GetCols() == rightTerm.GetCols())) {
-            return gsl_lite::not_null { std::make_unique<Matrix>(leftTerm.GetMatrix() + rightTerm.GetMatrix()) };
-        } else {
-            return gsl_lite::not_null { std::make_unique<Add<Expression>>(leftTerm, rightTerm) };
+    for (const auto& [base, logs] : logsByBase) {
+        if (logs.terms.size() > 1) {
+            std::vector<std::shared_ptr<const Expression>> arguments;
+            for (const Expression* argument : logs.terms) {
+                arguments.push_back(ShareOperand(argument->Copy()));
+            }
+            terms[logs.index] = mergedAddends.emplace_back(std::make_unique<Log<Expression>>(base->Copy(), BuildFromVector<Multiply>(std::move(arguments)))).get();
         }
     }
 
-    // log(a) + log(b) = log(ab)
-    if (auto logCase = RecursiveCast<Add<Log<Expression, Expression>, Log<Expression, Expression>>>(simplifiedAdd); logCase != nullptr) {
-        if (logCase->GetMostSigOp().GetMostSigOp().Equals(logCase->GetLeastSigOp().GetMostSigOp())) {
-            const IExpression auto& base = logCase->GetMostSigOp().GetMostSigOp();
-            const IExpression auto& argument = Multiply<Expression>({ logCase->GetMostSigOp().GetLeastSigOp(), logCase->GetLeastSigOp().GetLeastSigOp() });
-            return gsl_lite::not_null { std::make_unique<Log<Expression>>(base, argument) };
+    for (const auto& [size, matrices] : matricesBySize) {
+        if (matrices.terms.size() > 1) {
+            MatrixXXD matrixSum = static_cast<const Matrix&>(*matrices.terms.front()).GetMatrix();
+            for (std::size_t i = 1; i < matrices.terms.size(); ++i) {
+                matrixSum += static_cast<const Matrix&>(*matrices.terms[i]).GetMatrix();
+            }
+            terms[matrices.index] = mergedAddends.emplace_back(std::make_unique<Matrix>(std::move(matrixSum))).get();
         }
     }
 
-    // x + x = 2x
-    if (simplifiedAugend->Equals(*simplifiedAddend)) {
-        return Multiply<Real, Expression> { Real { 2.0 }, *simplifiedAugend }.Accept(*this);
-    }
+    // Each addend is split into a coefficient and a term, and addends are grouped by the hash of
+    // their term, so like terms of any shape are collected in a single pass. Groups are kept in
+    // the order their terms first appear, and constants are grouped under a null term.
+    struct LikeTerms {
+        const Expression* term = nullptr;
+        CompensatedSum coefficient {};
+        std::size_t realCoefficients = 0;
+        std::vector<const Expression*> symbolicCoefficients {};
+    };
 
-    // 2x + x = 3x
-    if (const auto likeTermsCase2 = RecursiveCast<Add<Multiply<Real, Expression>, Expression>>(simplifiedAdd); likeTermsCase2 != nullptr) {
-        if (likeTermsCase2->GetMostSigOp().GetLeastSigOp().Equals(likeTermsCase2->GetLeastSigOp())) {
-            const Real& coeffiecent = likeTermsCase2->GetMostSigOp().GetMostSigOp();
-            return gsl_lite::not_null { std::make_unique<Multiply<Real, Expression>>(Real { coeffiecent.GetValue() + 1 }, likeTermsCase2->GetMostSigOp().GetLeastSigOp()) };
+    std::vector<LikeTerms> groups;
+    std::unordered_map<const Expression*, std::size_t, ExpressionHash, ExpressionEqual> groupsByTerm;
+    std::optional<size_t> constantIndex;
+
+    const auto getGroup = [&](const Expression& term) -> LikeTerms& {
+        const auto [it, inserted] = groupsByTerm.try_emplace(&term, groups.size());
+        if (inserted) {
+            groups.push_back({ &term });
         }
-    }
+        return groups[it->second];
+    };
 
-    // simplifies expressions and combines like terms
-    // ex: 1 + 2x + 3 + 5x = 4 + 7x (or 7x + 4)
-    std::vector<std::unique_ptr<Expression>> adds;
-    std::vector<std::unique_ptr<Expression>> vals;
-    simplifiedAdd.Flatten(adds);
-    for (const auto& addend : adds) {
-        // real
-        size_t i = 0;
-        if (auto real = RecursiveCast<Real>(*addend); real != nullptr) {
-            for (; i < vals.size(); i++) {
-                if (auto valI = RecursiveCast<Real>(*vals[i]); valI != nullptr) {
-                    vals[i] = Real { valI->GetValue() + real->GetValue() }.Generalize();
-                    break;
-                }
-            }
-            if (i >= vals.size()) {
-                // check to make sure it is one thing only
-                vals.push_back(addend->Generalize());
+    for (const Expression* addend : terms) {
+        if (addend->Is<Real>()) {
+            if (!constantIndex) {
+                constantIndex = groups.size();
+                groups.emplace_back();
             }
+            groups[*constantIndex].coefficient += static_cast<const Real&>(*addend).GetValue();
             continue;
         }
-        // single i
-        if (auto img = RecursiveCast<Imaginary>(*addend); img != nullptr) {
-            for (; i < vals.size(); i++) {
-                if (auto valI = RecursiveCast<Multiply<Expression, Imaginary>>(*vals[i]); valI != nullptr) {
-                    auto addResult = Add<Expression> { valI->GetMostSigOp(), Real { 1.0 } }.Accept(*this);
-                    if (!addResult) {
-                        return addResult;
-                    }
-                    vals[i] = Multiply<Expression> { *(addResult.value()), Imaginary {} }.Generalize();
-                    break;
-                }
-            }
-            if (i >= vals.size()) {
-                // check to make sure it is one thing only
-                vals.push_back(Multiply<Expression> { Real { 1.0 }, Imaginary {} }.Generalize());
-            }
+
+        // n*x, where n is a real number and x is any expression
+        if (auto realCoefficient = Match<Multiply<Real, Expression>>(*addend)) {
+            LikeTerms& group = getGroup(realCoefficient->GetLeastSigOp());
+            group.coefficient += realCoefficient->GetMostSigOp().GetValue();
+            ++group.realCoefficients;
             continue;
         }
-        // n*i
-        if (auto img = RecursiveCast<Multiply<Expression, Imaginary>>(*addend); img != nullptr) {
-            for (; i < vals.size(); i++) {
-                if (auto valI = RecursiveCast<Multiply<Expression, Imaginary>>(*vals[i]); valI != nullptr) {
-                    auto addResult = Add<Expression> { valI->GetMostSigOp(), img->GetMostSigOp() }.Accept(*this);
-                    if (!addResult) {
-                        return addResult;
-                    }
-                    vals[i] = Multiply<Expression> { *(addResult.value()), Imaginary {} }.Generalize();
-                    break;
-                }
-            }
-            if (i >= vals.size()) {
-                // check to make sure it is one thing only
-                vals.push_back(img->Generalize());
-            }
-            continue;
+
+        // n*i, n*variable and n*exponent, where n is any expression
+        const Expression* symbolicCoefficient = nullptr;
+        const Expression* term = addend;
+
+        if (auto img = Match<Multiply<Expression, Imaginary>>(*addend)) {
+            symbolicCoefficient = &img->GetMostSigOp();
+            term = &img->GetLeastSigOp();
+        } else if (auto var = Match<Multiply<Expression, Variable>>(*addend)) {
+            symbolicCoefficient = &var->GetMostSigOp();
+            term = &var->GetLeastSigOp();
+        } else if (auto exp = Match<Multiply<Expression, Exponent<Expression>>>(*addend)) {
+            symbolicCoefficient = &exp->GetMostSigOp();
+            term = &exp->GetLeastSigOp().GetExpression();
         }
-        // single variable
-        if (auto var = RecursiveCast<Variable>(*addend); var != nullptr) {
-            for (; i < vals.size(); i++) {
-                if (auto valI = RecursiveCast<Multiply<Expression, Variable>>(*vals[i]); valI != nullptr) {
-                    if (valI->GetLeastSigOp().GetName() == var->GetName()) {
-                        auto addResult = Add<Expression> { valI->GetMostSigOp(), Real { 1.0 } }.Accept(*this);
-                        if (!addResult) {
-                            return addResult;
-                        }
-                        vals[i] = Multiply<Expression> { *(addResult.value()), *var }.Generalize();
-                        break;
-                    } else
-                        continue;
-                }
-            }
-            if (i >= vals.size()) {
-                // check to make sure it is one thing only
-                vals.push_back(Multiply<Expression> { Real { 1.0 }, *var }.Generalize());
-            }
-            continue;
+
+        LikeTerms& group = getGroup(*term);
+        if (symbolicCoefficient != nullptr) {
+            group.symbolicCoefficients.push_back(symbolicCoefficient);
+        } else {
+            group.coefficient += 1.0;
+            ++group.realCoefficients;
         }
-        // n*variable
-        if (auto var = RecursiveCast<Multiply<Expression, Variable>>(*addend); var != nullptr) {
-            for (; i < vals.size(); i++) {
-                if (auto valI = RecursiveCast<Multiply<Expression, Variable>>(*vals[i]); valI != nullptr) {
-                    // if (auto zeroCase = RecursiveCast<Multiply<Real, Expression>>(*valI); zeroCase != nullptr) {}
-                    if (valI->GetLeastSigOp().GetName() == var->GetLeastSigOp().GetName()) {
-                        auto addResult = Add<Expression> { valI->GetMostSigOp(), var->GetMostSigOp() }.Accept(*this);
-                        if (!addResult) {
-                            return addResult;
-                        }
-                        vals[i] = Multiply<Expression> { *(addResult.value()), valI->GetLeastSigOp() }.Generalize();
-                        break;
-                    } else
-                        continue;
-                }
-            }
-            if (i >= vals.size()) {
-                // check to make sure it is one thing only
-                vals.push_back(var->Generalize());
+    }
+
+    // rebuild equation after simplification, filtering out zero-equivalent expressions
+    std::vector<std::unique_ptr<Expression>> avals;
+    avals.reserve(groups.size());
+
+    for (const LikeTerms& group : groups) {
+        const double coefficient = group.coefficient.Get();
+
+        if (group.term == nullptr) {
+            if (std::abs(coefficient) > EPSILON) {
+                avals.push_back(std::make_unique<Real>(coefficient));
             }
             continue;
         }
-        // single exponent
-        if (auto exp = RecursiveCast<Exponent<Expression>>(*addend); exp != nullptr) {
-            for (; i < vals.size(); i++) {
-                if (auto valI = RecursiveCast<Multiply<Expression, Exponent<Expression>>>(*vals[i]); valI != nullptr) {
-                    if (valI->GetLeastSigOp().Equals(*exp)) {
-                        auto addResult = Add<Expression> { valI->GetMostSigOp(), Real { 1.0 } }.Accept(*this);
-                        if (!addResult) {
-                            return addResult;
-                        }
-                        vals[i] = Multiply<Expression> { *(addResult.value()), *exp }.Generalize();
-                        break;
-                    } else
-                        continue;
-                }
+
+        if (group.symbolicCoefficients.empty()) {
+            if (std::abs(coefficient) <= EPSILON) {
+                continue;
             }
-            if (i >= vals.size()) {
-                // check to make sure it is one thing only
-                vals.push_back(Multiply<Expression> { Real { 1.0 }, *exp }.Generalize());
+
+            if (coefficient == 1.0) {
+                avals.push_back(group.term->Generalize());
+            } else {
+                avals.push_back(std::make_unique<Multiply<Expression>>(Real { coefficient }, *group.term));
             }
             continue;
         }
-        // n*exponent
-        if (auto exp = RecursiveCast<Multiply<Expression, Exponent<Expression>>>(*addend); exp != nullptr) {
-            for (; i < vals.size(); i++) {
-                if (auto valI = RecursiveCast<Multiply<Expression, Exponent<Expression>>>(*vals[i]); valI != nullptr) {
-                    if (valI->GetLeastSigOp().Equals(exp->GetLeastSigOp())) {
-                        auto addResult = Add<Expression> { valI->GetMostSigOp(), exp->GetMostSigOp() }.Accept(*this);
-                        if (!addResult) {
-                            return addResult;
-                        }
-                        vals[i] = Multiply<Expression> { *(addResult.value()), valI->GetLeastSigOp() }.Generalize();
-                        break;
-                    } else
-                        continue;
-                }
-            }
-            if (i >= vals.size()) {
-                // check to make sure it is one thing only
-                vals.push_back(exp->Generalize());
-            }
-            continue;
+
+        std::vector<std::unique_ptr<Expression>> coefficients;
+        if (group.realCoefficients > 0) {
+            coefficients.push_back(std::make_unique<Real>(coefficient));
         }
-        // no simplification possible
-        else {
-            vals.push_back(addend->Copy()->Generalize());
+        for (const Expression* symbolic : group.symbolicCoefficients) {
+            coefficients.push_back(symbolic->Copy());
         }
-    }
-    // rebuild equation after simplification.
 
-    for (auto& val : vals) {
-        if (auto mul = RecursiveCast<Multiply<Real, Expression>>(*val); mul != nullptr) {
-            if (mul->GetMostSigOp().GetValue() == 1.0) {
-                val = mul->GetLeastSigOp().Generalize();
-            }
+        if (coefficients.size() == 1) {
+            avals.push_back(std::make_unique<Multiply<Expression>>(std::move(coefficients.front()), group.term->Copy()));
+            continue;
         }
-    }
 
-    // filter out zero-equivalent expressions
-    std::vector<std::unique_ptr<Expression>> avals;
-    for (auto& val : vals) {
-        if (auto real = RecursiveCast<Real>(*val); real != nullptr) {
-            if (std::abs(real->GetValue()) <= EPSILON) {
-                continue;
-            }
+        auto addResult = BuildFromVector<Add>(std::move(coefficients))->Accept(*this);
+        if (!addResult) {
+            return addResult;
         }
-        if (auto mul = RecursiveCast<Multiply<Real, Expression>>(*val); mul != nullptr) {
-            if (std::abs(mul->GetMostSigOp().GetValue()) <= EPSILON) {
-                continue;
-            }
-        }
-        avals.push_back(val->Generalize());
+        avals.push_back(std::make_unique<Multiply<Expression>>(std::move(addResult).value(), group.term->Copy()));
     }
 
-    if (auto vec = BuildFromVector<Add>(avals); vec != nullptr) {
-        return gsl_lite::not_null { std::move(vec) };
+    if (avals.empty()) {
+        return gsl_lite::not_null { std::make_unique<Real>(0.0) };
     }
 
-    return gsl_lite::not_null { simplifiedAdd.Copy() };
+    if (avals.size() == 1) {
+        return gsl_lite::not_null { std::move(avals.front()) };
+    }
+
+    return gsl_lite::not_null<std::unique_ptr<Expression>> { BuildFromVector<Add>(std::move(avals)) };
 }
 
-auto SimplifyVisitor::TypedVisit(const Subtract<>& subtract) -> RetT
+auto SimplifyVisitor::Simplify(const Subtract<>& subtract) -> RetT
 {
-    auto mostSigOp = subtract.GetMostSigOp().Copy();
-    auto leastSigOp = subtract.GetLeastSigOp().Copy();
-    if (!mostSigOp) {
+    if (!subtract.HasMostSigOp()) {
         return std::unexpected { "Missing most significant operand." };
     }
-    if (!leastSigOp) {
+    if (!subtract.HasLeastSigOp()) {
         return std::unexpected { "Missing least significant operand." };
     }
 
-    auto simplifiedMostSigOpResult = mostSigOp->Accept(*this);
-    auto simplifiedLeastSigOpResult = leastSigOp->Accept(*this);
+    auto [simplifiedMostSigOpResult, simplifiedLeastSigOpResult] = SimplifyOperands(subtract.GetMostSigOp(), subtract.GetLeastSigOp());
 
     if (!simplifiedMostSigOpResult) {
         return std::unexpected { simplifiedMostSigOpResult.error() };
@@ -351,13 +649,12 @@ auto SimplifyVisitor::TypedVisit(const Subtract<>& subtract) -> RetT
         return std::unexpected { simplifiedLeastSigOpResult.error() };
     }
 
-    auto simplifiedMinuend = std::move(simplifiedMostSigOpResult).value();
-    auto simplifiedSubtrahend = std::move(simplifiedLeastSigOpResult).value();
-
-    const Subtract simplifiedSubtract { *simplifiedMinuend, *simplifiedSubtrahend };
+    const Subtract<> simplifiedSubtract { std::move(simplifiedMostSigOpResult).value(), std::move(simplifiedLeastSigOpResult).value() };
+    const auto& simplifiedMinuend = simplifiedSubtract.GetMostSigOp();
+    const auto& simplifiedSubtrahend = simplifiedSubtract.GetLeastSigOp();
 
     // 2 - 1 = 1
-    if (auto realCase = RecursiveCast<Subtract<Real>>(simplifiedSubtract); realCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Subtract: a - b" }; auto realCase = rule.Match<Subtract<Real>>(simplifiedSubtract)) {
         const Real& minuend = realCase->GetMostSigOp();
         const Real& subtrahend = realCase->GetLeastSigOp();
 
@@ -365,11 +662,11 @@ auto SimplifyVisitor::TypedVisit(const Subtract<>& subtract) -> RetT
     }
 
     // x - x = 0
-    if (simplifiedMinuend->Equals(*simplifiedSubtrahend)) {
+    if (simplifiedMinuend.Equals(simplifiedSubtrahend)) {
         return gsl_lite::not_null { std::make_unique<Real>(Real { 0.0 }) };
     }
 
-    if (auto matrixCase = RecursiveCast<Subtract<Matrix, Matrix>>(simplifiedSubtract); matrixCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Subtract: A - B" }; auto matrixCase = ruleGroups.matrix ? rule.Match<Subtract<Matrix, Matrix>>(simplifiedSubtract) : nullptr) {
         const Oasis::IExpression auto& leftTerm = matrixCase->GetMostSigOp();
         const Oasis::IExpression auto& rightTerm = matrixCase->GetLeastSigOp();
 
@@ -381,7 +678,7 @@ auto SimplifyVisitor::TypedVisit(const Subtract<>& subtract) -> RetT
     }
 
     // ax - x = (a-1)x
-    if (const auto minusOneCase = RecursiveCast<Subtract<Multiply<>, Expression>>(simplifiedSubtract); minusOneCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Subtract: ax - x" }; const auto minusOneCase = rule.Match<Subtract<Multiply<>, Expression>>(simplifiedSubtract)) {
         if (minusOneCase->GetMostSigOp().GetLeastSigOp().Equals(minusOneCase->GetLeastSigOp())) {
             const Subtract newCoefficient { minusOneCase->GetMostSigOp().GetMostSigOp(), Real { 1.0 } };
             return Multiply { newCoefficient, minusOneCase->GetLeastSigOp() }.Accept(*this);
@@ -389,7 +686,7 @@ auto SimplifyVisitor::TypedVisit(const Subtract<>& subtract) -> RetT
     }
 
     // x-ax = (1-a)x
-    if (const auto oneMinusCase = RecursiveCast<Subtract<Expression, Multiply<>>>(simplifiedSubtract); oneMinusCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Subtract: x - ax" }; const auto oneMinusCase = rule.Match<Subtract<Expression, Multiply<>>>(simplifiedSubtract)) {
         if (oneMinusCase->GetMostSigOp().Equals(oneMinusCase->GetLeastSigOp().GetLeastSigOp())) {
             const Subtract newCoefficient { Real { 1.0 }, oneMinusCase->GetLeastSigOp().GetMostSigOp() };
             return Multiply { newCoefficient, oneMinusCase->GetMostSigOp() }.Accept(*this);
@@ -397,7 +694,7 @@ auto SimplifyVisitor::TypedVisit(const Subtract<>& subtract) -> RetT
     }
 
     // ax-bx= (a-b)x
-    if (const auto coefficientCase = RecursiveCast<Subtract<Multiply<>>>(simplifiedSubtract); coefficientCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Subtract: ax - bx" }; const auto coefficientCase = rule.Match<Subtract<Multiply<>>>(simplifiedSubtract)) {
         if (coefficientCase->GetMostSigOp().GetLeastSigOp().Equals(coefficientCase->GetLeastSigOp().GetLeastSigOp())) {
             const Subtract newCoefficient { coefficientCase->GetMostSigOp().GetMostSigOp(), coefficientCase->GetLeastSigOp().GetMostSigOp() };
             return Multiply { newCoefficient, coefficientCase->GetLeastSigOp().GetLeastSigOp() }.Accept(*this);
@@ -405,7 +702,7 @@ auto SimplifyVisitor::TypedVisit(const Subtract<>& subtract) -> RetT
     }
 
     // log(a) - log(b) = log(a / b)
-    if (const auto logCase = RecursiveCast<Subtract<Log<>>>(simplifiedSubtract); logCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Subtract: log(a) - log(b)" }; const auto logCase = ruleGroups.logarithm ? rule.Match<Subtract<Log<>>>(simplifiedSubtract) : nullptr) {
         if (logCase->GetMostSigOp().GetMostSigOp().Equals(logCase->GetLeastSigOp().GetMostSigOp())) {
             const IExpression auto& base = logCase->GetMostSigOp().GetMostSigOp();
             const IExpression auto& argument = Divide({ logCase->GetMostSigOp().GetLeastSigOp(), logCase->GetLeastSigOp().GetLeastSigOp() });
@@ -414,7 +711,7 @@ auto SimplifyVisitor::TypedVisit(const Subtract<>& subtract) -> RetT
     }
 
     // makes subtraction into addition because it is easier to deal with
-    auto negated = Multiply<Expression> { Real { -1 }, *simplifiedSubtrahend };
+    auto negated = Multiply<Expression> { Real { -1 }, simplifiedSubtrahend };
     if (auto added = RecursiveCast<Add<Expression>>(negated.GetLeastSigOp()); added != nullptr) {
         auto msOp = Multiply<Expression> { Real { -1.0 }, added->GetMostSigOp() }.Accept(*this);
         if (!msOp) {
@@ -429,7 +726,7 @@ auto SimplifyVisitor::TypedVisit(const Subtract<>& subtract) -> RetT
         if (!RHS) {
             return RHS;
         }
-        return Add { *simplifiedMinuend, *(RHS.value()) }.Accept(*this);
+        return Add { simplifiedMinuend, *(RHS.value()) }.Accept(*this);
     }
     if (auto subtracted = RecursiveCast<Subtract<Expression>>(negated.GetLeastSigOp()); subtracted != nullptr) {
         auto msOp = Multiply<Expression> { Real { -1.0 }, subtracted->GetMostSigOp() }.Accept(*this);
@@ -445,422 +742,275 @@ auto SimplifyVisitor::TypedVisit(const Subtract<>& subtract) -> RetT
         if (!RHS) {
             return RHS;
         }
-        return Add { *simplifiedMinuend, *(RHS.value()) }.Accept(*this);
+        return Add { simplifiedMinuend, *(RHS.value()) }.Accept(*this);
     }
-    return Add { *simplifiedMinuend, negated }.Accept(*this);
+    return Add { simplifiedMinuend, negated }.Accept(*this);
 }
 
-auto SimplifyVisitor::TypedVisit(const Multiply<>& multiply) -> RetT
+auto SimplifyVisitor::Simplify(const Multiply<>& multiply) -> RetT
 {
-    auto mostSigOp = multiply.GetMostSigOp().Copy();
-    auto leastSigOp = multiply.GetLeastSigOp().Copy();
-    if (!mostSigOp) {
+    if (!multiply.HasMostSigOp()) {
         return std::unexpected { "Missing most significant operand." };
     }
-    if (!leastSigOp) {
+    if (!multiply.HasLeastSigOp()) {
         return std::unexpected { "Missing least significant operand." };
     }
 
-    auto simplifiedMostSigOpResult = mostSigOp->Accept(*this);
-    auto simplifiedLeastSigOpResult = leastSigOp->Accept(*this);
-
-    if (!simplifiedMostSigOpResult) {
-        return std::unexpected { simplifiedMostSigOpResult.error() };
-    }
-    if (!simplifiedLeastSigOpResult) {
-        return std::unexpected { simplifiedLeastSigOpResult.error() };
-    }
+    // The whole product is flattened before it is simplified, so that factors are collected once
+    // for the product rather than once for every Multiply nested in it.
+    std::vector<const Expression*> factors;
+    multiply.Flatten(factors);
 
-    auto simplifiedMultiplicand = std::move(simplifiedMostSigOpResult).value();
-    auto simplifiedMultiplier = std::move(simplifiedLeastSigOpResult).value();
+    std::vector<std::unique_ptr<Expression>> simplifiedFactors;
+    std::vector<const Expression*> multiplies;
+    simplifiedFactors.reserve(factors.size());
 
-    Multiply simplifiedMultiply { *simplifiedMultiplicand, *simplifiedMultiplier };
-    if (auto onezerocase = RecursiveCast<Multiply<Real, Expression>>(simplifiedMultiply); onezerocase != nullptr) {
-        const Real& multiplicand = onezerocase->GetMostSigOp();
-        const Expression& multiplier = onezerocase->GetLeastSigOp();
-        if (std::abs(multiplicand.GetValue()) <= EPSILON) {
-            return gsl_lite::not_null { std::make_unique<Real>(Real { 0.0 }) };
+    for (auto& simplifiedResult : SimplifyOperands(factors)) {
+        if (!simplifiedResult) {
+            return std::unexpected { simplifiedResult.error() };
         }
-        if (multiplicand.GetValue() == 1) {
-            return multiplier.Accept(*this);
-        }
-    }
-    if (auto realCase = RecursiveCast<Multiply<Real>>(simplifiedMultiply); realCase != nullptr) {
-        const Real& multiplicand = realCase->GetMostSigOp();
-        const Real& multiplier = realCase->GetLeastSigOp();
-        return gsl_lite::not_null { std::make_unique<Real>(multiplicand.GetValue() * multiplier.GetValue()) };
-    }
 
-    if (auto ImgCase = RecursiveCast<Multiply<Imaginary>>(simplifiedMultiply); ImgCase != nullptr) {
-        return gsl_lite::not_null { std::make_unique<Real>(-1.0) };
-    }
+        const Expression* simplified = simplifiedFactors.emplace_back(std::move(simplifiedResult).value()).get();
 
-    if (auto multCase = RecursiveCast<Multiply<Real, Divide<Expression>>>(simplifiedMultiply); multCase != nullptr) {
-        auto m = Multiply<Expression> { multCase->GetMostSigOp(), multCase->GetLeastSigOp().GetMostSigOp() }.Accept(*this);
-        if (!m) {
-            return m;
+        // -a = -1 * a, so that the sign joins the coefficient, as when i^3 simplifies to -i
+        if (simplified->Is<Negate>() && simplified->GetOperandAt(0) != nullptr) {
+            multiplies.push_back(simplifiedFactors.emplace_back(std::make_unique<Real>(-1.0)).get());
+            simplified = simplified->GetOperandAt(0);
         }
-        return gsl_lite::not_null { Divide<Expression> { *(m.value()), (multCase->GetLeastSigOp().GetLeastSigOp()) }.Generalize() };
-    }
 
-    if (auto exprCase = RecursiveCast<Multiply<Expression>>(simplifiedMultiply); exprCase != nullptr) {
-        if (exprCase->GetMostSigOp().Equals(exprCase->GetLeastSigOp())) {
-            return gsl_lite::not_null { std::make_unique<Exponent<Expression, Expression>>(exprCase->GetMostSigOp(), Real { 2.0 }) };
+        if (!simplified->Is<Multiply>()) {
+            multiplies.push_back(simplified);
+        } else if (const auto* product = dynamic_cast<const Multiply<>*>(simplified)) {
+            product->Flatten(multiplies);
+        } else {
+            // Generalizing shares the operands, so they are still owned by simplifiedFactors.
+            static_cast<const Multiply<>&>(*simplified->Generalize()).Flatten(multiplies);
         }
     }
 
-    if (auto rMatrixCase = RecursiveCast<Multiply<Real, Matrix>>(simplifiedMultiply); rMatrixCase != nullptr) {
-        return gsl_lite::not_null { std::make_unique<Matrix>(rMatrixCase->GetLeastSigOp().GetMatrix() * rMatrixCase->GetMostSigOp().GetValue()) };
+    RuleScope rule { profiler.get(), "Multiply: collect factors" };
+    rule.Apply();
+
+    // 0 * a = 0
+    if (std::ranges::any_of(multiplies, [](const Expression* factor) { return factor->Is<Real>() && std::abs(static_cast<const Real&>(*factor).GetValue()) <= EPSILON; })) {
+        return gsl_lite::not_null { std::make_unique<Real>(0.0) };
     }
 
-    if (auto matrixCase = RecursiveCast<Multiply<Matrix, Matrix>>(simplifiedMultiply); matrixCase != nullptr) {
-        const Oasis::IExpression auto& leftTerm = matrixCase->GetMostSigOp();
-        const Oasis::IExpression auto& rightTerm = matrixCase->GetLeastSigOp();
+    // a * (b / c) = ab / c
+    if (std::ranges::any_of(multiplies, [](const Expression* factor) { return factor->Is<Divide>(); })) {
+        std::vector<std::unique_ptr<Expression>> numerators;
+        std::vector<std::unique_ptr<Expression>> denominators;
 
-        if (leftTerm.GetCols() == rightTerm.GetRows()) {
-            return gsl_lite::not_null { std::make_unique<Matrix>(leftTerm.GetMatrix() * rightTerm.GetMatrix()) };
-        } else {
-            // ERROR: INVALID DIMENSION
-            return gsl_lite::not_null { std::make_unique<Multiply<Expression>>(leftTerm, rightTerm) };
+        for (const Expression* factor : multiplies) {
+            if (auto divideCase = Match<Divide<>>(*factor)) {
+                numerators.push_back(divideCase->GetMostSigOp().Copy());
+                denominators.push_back(divideCase->GetLeastSigOp().Copy());
+            } else {
+                numerators.push_back(factor->Copy());
+            }
         }
-    }
 
-    if (auto multCase = RecursiveCast<Multiply<Expression, Divide<Expression>>>(simplifiedMultiply); multCase != nullptr) {
-        auto m = Multiply<Expression> { multCase->GetMostSigOp(), multCase->GetLeastSigOp().GetMostSigOp() }.Accept(*this);
-        if (!m) {
-            return m;
-        }
-        return Divide<Expression> { *(m.value()), (multCase->GetLeastSigOp().GetLeastSigOp()) }.Accept(*this);
-    }
+        const auto product = [](std::vector<std::unique_ptr<Expression>>&& operands) -> std::unique_ptr<Expression> {
+            return operands.size() == 1 ? std::move(operands.front()) : BuildFromVector<Multiply>(std::move(operands));
+        };
 
-    if (auto multCase = RecursiveCast<Multiply<Divide<Expression>, Divide<Expression>>>(simplifiedMultiply); multCase != nullptr) {
-        auto m = Multiply<Expression> { multCase->GetMostSigOp(), multCase->GetLeastSigOp().GetMostSigOp() }.Accept(*this);
-        if (!m) {
-            return m;
-        }
-        auto n = Multiply<Expression> { multCase->GetMostSigOp().GetLeastSigOp(), multCase->GetLeastSigOp().GetLeastSigOp() }.Accept(*this);
-        if (!n) {
-            return n;
-        }
-        return Divide<Expression> { *(m.value()), *(n.value()) }.Accept(*this);
+        return Divide<Expression> { product(std::move(numerators)), product(std::move(denominators)) }.Accept(*this);
     }
 
-    if (auto exprCase = RecursiveCast<Multiply<Expression, Exponent<Expression, Expression>>>(simplifiedMultiply); exprCase != nullptr) {
-        if (exprCase->GetMostSigOp().Equals(exprCase->GetLeastSigOp().GetMostSigOp())) {
-            auto lsOp = Add<Expression> { exprCase->GetLeastSigOp().GetLeastSigOp(), Real { 1.0 } }.Accept(*this);
-            if (!lsOp) {
-                return lsOp;
-            }
-            return gsl_lite::not_null { std::make_unique<Exponent<Expression>>(exprCase->GetMostSigOp(), *(lsOp.value())) };
-        }
-    }
+    // Each factor is split into a base and an exponent, and factors are grouped by the hash of
+    // their base, so x * x^n * x^m = x^(1 + n + m) for bases of any shape in a single pass.
+    // Numbers are multiplied into a single coefficient, and matrices are multiplied in order, as
+    // their product does not commute. Groups are kept in the order their bases first appear.
+    struct LikeFactors {
+        const Expression* base = nullptr;
+        CompensatedSum exponent {};
+        std::size_t realExponents = 0;
+        std::vector<const Expression*> symbolicExponents {};
+    };
+
+    std::vector<LikeFactors> groups;
+    std::unordered_map<const Expression*, std::size_t, ExpressionHash, ExpressionEqual> groupsByBase;
+    std::vector<MatrixXXD> matrices;
+    std::optional<size_t> constantIndex;
+    std::optional<size_t> matrixIndex;
+    double constant = 1.0;
 
-    // x*x^n
-    if (auto exprCase = RecursiveCast<Multiply<Expression, Exponent<Expression>>>(simplifiedMultiply); exprCase != nullptr) {
-        if (exprCase->GetMostSigOp().Equals(exprCase->GetLeastSigOp().GetMostSigOp())) {
-            auto lsOp = Add<Expression> { exprCase->GetLeastSigOp().GetLeastSigOp(), Real { 1.0 } }.Accept(*this);
-            if (!lsOp) {
-                return lsOp;
+    for (const Expression* multiplicand : multiplies) {
+        if (multiplicand->Is<Real>()) {
+            constant *= static_cast<const Real&>(*multiplicand).GetValue();
+            if (!constantIndex) {
+                constantIndex = groups.size();
+                groups.emplace_back();
             }
-            return gsl_lite::not_null { std::make_unique<Exponent<Expression>>(exprCase->GetMostSigOp(), *(lsOp.value())) };
+            continue;
         }
-    }
 
-    if (auto exprCase = RecursiveCast<Multiply<Exponent<Expression>, Expression>>(simplifiedMultiply); exprCase != nullptr) {
-        if (exprCase->GetLeastSigOp().Equals(exprCase->GetMostSigOp().GetMostSigOp())) {
-            auto lsOp = Add<Expression> { exprCase->GetMostSigOp().GetLeastSigOp(), Real { 1.0 } }.Accept(*this);
-            if (!lsOp) {
-                return lsOp;
+        if (multiplicand->Is<Matrix>()) {
+            MatrixXXD matrix = static_cast<const Matrix&>(*multiplicand).GetMatrix();
+
+            // ERROR: INVALID DIMENSION, in which case the matrices are left unmultiplied, as they
+            // are without matrix rules
+            if (ruleGroups.matrix && !matrices.empty() && matrices.back().cols() == matrix.rows()) {
+                matrices.back() = matrices.back() * matrix;
+            } else {
+                matrices.push_back(std::move(matrix));
             }
-            return gsl_lite::not_null { std::make_unique<Exponent<Expression>>(exprCase->GetLeastSigOp(), *(lsOp.value())) };
-        }
-    }
 
-    // x^n*x^m
-    if (auto exprCase = RecursiveCast<Multiply<Exponent<Expression>, Exponent<Expression>>>(simplifiedMultiply); exprCase != nullptr) {
-        if (exprCase->GetMostSigOp().GetMostSigOp().Equals(exprCase->GetLeastSigOp().GetMostSigOp())) {
-            auto lsOp = Add<Expression> { exprCase->GetMostSigOp().GetLeastSigOp(), exprCase->GetLeastSigOp().GetLeastSigOp() }.Accept(*this);
-            if (!lsOp) {
-                return lsOp;
+            if (!matrixIndex) {
+                matrixIndex = groups.size();
+                groups.emplace_back();
             }
-            return gsl_lite::not_null { std::make_unique<Exponent<Expression>>(exprCase->GetMostSigOp().GetMostSigOp(), *(lsOp.value())) };
+            continue;
         }
-    }
 
-    // a*x*x
-    if (auto exprCase = RecursiveCast<Multiply<Multiply<Expression>, Expression>>(simplifiedMultiply); exprCase != nullptr) {
-        if (exprCase->GetMostSigOp().GetLeastSigOp().Equals(exprCase->GetLeastSigOp())) {
-            return gsl_lite::not_null { std::make_unique<Multiply<Expression, Expression>>(exprCase->GetMostSigOp().GetMostSigOp(),
-                Exponent<Expression> { exprCase->GetMostSigOp().GetLeastSigOp(), Real { 2.0 } }) };
-        }
-    }
+        const Expression* base = multiplicand;
+        const Expression* exponent = nullptr;
 
-    // a*x*b*x
-    if (auto exprCase = RecursiveCast<Multiply<Multiply<Expression>, Multiply<Expression>>>(simplifiedMultiply); exprCase != nullptr) {
-        if (exprCase->GetMostSigOp().GetLeastSigOp().Equals(exprCase->GetLeastSigOp().GetLeastSigOp())) {
-            auto msOp = Multiply<Expression> { exprCase->GetMostSigOp().GetMostSigOp(), exprCase->GetLeastSigOp().GetMostSigOp() }.Accept(*this);
-            if (!msOp) {
-                return msOp;
-            }
-            auto lsOp = Exponent<Expression> { exprCase->GetMostSigOp().GetLeastSigOp(), Real { 2.0 } }.Accept(*this);
-            if (!lsOp) {
-                return lsOp;
-            }
-            return gsl_lite::not_null { std::make_unique<Multiply<Expression>>(*(msOp.value()), *(lsOp.value())) };
+        if (auto exponentCase = Match<Exponent<>>(*multiplicand)) {
+            base = &exponentCase->GetMostSigOp();
+            exponent = &exponentCase->GetLeastSigOp();
         }
-    }
 
-    // a*x^n*x
-    if (auto exprCase = RecursiveCast<Multiply<Multiply<Expression, Exponent<Expression>>, Expression>>(simplifiedMultiply); exprCase != nullptr) {
-        if (exprCase->GetMostSigOp().GetLeastSigOp().GetMostSigOp().Equals(exprCase->GetLeastSigOp())) {
-            auto lsOp = Add<Expression> { exprCase->GetMostSigOp().GetLeastSigOp().GetLeastSigOp(), Real { 1.0 } }.Accept(*this);
-            if (!lsOp) {
-                return lsOp;
-            }
-            return gsl_lite::not_null { std::make_unique<Multiply<Expression>>(exprCase->GetMostSigOp().GetMostSigOp(),
-                Exponent<Expression> { exprCase->GetMostSigOp().GetLeastSigOp().GetMostSigOp(), *(lsOp.value()) }) };
+        const auto [it, inserted] = groupsByBase.try_emplace(base, groups.size());
+        if (inserted) {
+            groups.push_back({ base });
         }
-    }
 
-    // a*x*x^n
-    if (auto exprCase = RecursiveCast<Multiply<Multiply<Expression>, Exponent<Expression>>>(simplifiedMultiply); exprCase != nullptr) {
-        if (exprCase->GetMostSigOp().GetLeastSigOp().Equals(exprCase->GetLeastSigOp().GetMostSigOp())) {
-            auto lsOp = Add<Expression> { exprCase->GetLeastSigOp().GetLeastSigOp(), Real { 1.0 } }.Accept(*this);
-            if (!lsOp) {
-                return lsOp;
-            }
-            return gsl_lite::not_null { std::make_unique<Multiply<Expression>>(exprCase->GetMostSigOp().GetMostSigOp(),
-                Exponent<Expression> { exprCase->GetMostSigOp().GetLeastSigOp(), *(lsOp.value()) }) };
-        }
-        if (exprCase->GetMostSigOp().GetMostSigOp().Equals(exprCase->GetLeastSigOp().GetMostSigOp())) {
-            auto lsOp = Add<Expression> { exprCase->GetLeastSigOp().GetLeastSigOp(), Real { 1.0 } }.Accept(*this);
-            if (!lsOp) {
-                return lsOp;
-            }
-            return gsl_lite::not_null { std::make_unique<Multiply<Expression>>(exprCase->GetMostSigOp().GetLeastSigOp(),
-                Exponent<Expression> { exprCase->GetMostSigOp().GetMostSigOp(), *(lsOp.value()) }) };
+        LikeFactors& group = groups[it->second];
+        if (exponent == nullptr) {
+            group.exponent += 1.0;
+            ++group.realExponents;
+        } else if (exponent->Is<Real>()) {
+            group.exponent += static_cast<const Real&>(*exponent).GetValue();
+            ++group.realExponents;
+        } else {
+            group.symbolicExponents.push_back(exponent);
         }
     }
 
-    // a*x^n*b*x
-    if (auto exprCase = RecursiveCast<Multiply<Multiply<Expression>, Multiply<Expression, Exponent<Expression>>>>(simplifiedMultiply); exprCase != nullptr) {
-        if (exprCase->GetMostSigOp().GetLeastSigOp().Equals(exprCase->GetLeastSigOp().GetLeastSigOp().GetMostSigOp())) {
-            auto msOp = Multiply<Expression> { exprCase->GetMostSigOp().GetMostSigOp(), exprCase->GetLeastSigOp().GetMostSigOp() }.Accept(*this);
-            if (!msOp) {
-                return msOp;
-            }
-            auto lsLsOp = Add<Expression> { exprCase->GetLeastSigOp().GetLeastSigOp().GetLeastSigOp(), Real { 1.0 } }.Accept(*this);
-            if (!lsLsOp) {
-                return lsLsOp;
-            }
-            return gsl_lite::not_null { std::make_unique<Multiply<Expression>>(
-                *(msOp.value()), Exponent<Expression> { exprCase->GetMostSigOp().GetLeastSigOp(), *(lsLsOp.value()) }) };
+    // i^n cycles through 1, i, -1 and -i
+    for (LikeFactors& group : groups) {
+        if (!ruleGroups.complex || group.base == nullptr || !group.base->Is<Imaginary>() || !group.symbolicExponents.empty()) {
+            continue;
         }
-    }
 
-    if (auto exprCase = RecursiveCast<Multiply<Multiply<Expression>, Multiply<Exponent<Expression>, Expression>>>(simplifiedMultiply); exprCase != nullptr) {
-        if (exprCase->GetMostSigOp().GetLeastSigOp().Equals(exprCase->GetLeastSigOp().GetMostSigOp().GetMostSigOp())) {
-            auto msOp = Multiply<Expression> { exprCase->GetMostSigOp().GetMostSigOp(), exprCase->GetLeastSigOp().GetLeastSigOp() }.Accept(*this);
-            if (!msOp) {
-                return msOp;
-            }
-            auto lsLsOp = Add<Expression> { exprCase->GetLeastSigOp().GetMostSigOp().GetLeastSigOp(), Real { 1.0 } }.Accept(*this);
-            if (!lsLsOp) {
-                return lsLsOp;
-            }
-            return gsl_lite::not_null { std::make_unique<Multiply<Expression>>(
-                *(msOp.value()), Exponent<Expression> { exprCase->GetMostSigOp().GetLeastSigOp(), *(lsLsOp.value()) }) };
+        const double power = group.exponent.Get();
+        if (power != std::floor(power)) {
+            continue;
         }
-    }
 
-    if (auto exprCase = RecursiveCast<Multiply<Multiply<Expression, Exponent<Expression>>, Multiply<Expression>>>(simplifiedMultiply); exprCase != nullptr) {
-        if (exprCase->GetMostSigOp().GetLeastSigOp().GetMostSigOp().Equals(exprCase->GetLeastSigOp().GetLeastSigOp())) {
-            auto msOp = Multiply<Expression> { exprCase->GetMostSigOp().GetMostSigOp(), exprCase->GetLeastSigOp().GetLeastSigOp() }.Accept(*this);
-            if (!msOp) {
-                return msOp;
-            }
-            auto lsLsOp = Add<Expression> { exprCase->GetMostSigOp().GetLeastSigOp().GetLeastSigOp(), Real { 1.0 } }.Accept(*this);
-            if (!lsLsOp) {
-                return lsLsOp;
-            }
-            return gsl_lite::not_null { std::make_unique<Multiply<Expression>>(
-                *(msOp.value()),
-                Exponent<Expression> { exprCase->GetLeastSigOp().GetLeastSigOp(), *(lsLsOp.value()) }) };
+        const auto cycle = static_cast<int>(std::fmod(std::fmod(power, 4.0) + 4.0, 4.0));
+        if (cycle >= 2) {
+            constant = -constant;
         }
-    }
 
-    // a*x^n*x^m
-    if (auto exprCase = RecursiveCast<Multiply<Multiply<Expression, Exponent<Expression>>, Exponent<Expression>>>(simplifiedMultiply); exprCase != nullptr) {
-        if (exprCase->GetMostSigOp().GetLeastSigOp().GetMostSigOp().Equals(exprCase->GetLeastSigOp().GetLeastSigOp())) {
-            auto lsOp = Add<Expression> { exprCase->GetLeastSigOp().GetMostSigOp(), exprCase->GetMostSigOp().GetLeastSigOp().GetLeastSigOp() }.Accept(*this);
-            if (!lsOp) {
-                return lsOp;
-            }
-            return gsl_lite::not_null { std::make_unique<Multiply<Expression>>(
-                exprCase->GetMostSigOp().GetMostSigOp(),
-                Exponent<Expression> { exprCase->GetMostSigOp().GetLeastSigOp().GetMostSigOp(),
-                    *(lsOp.value()) }) };
-        }
+        group.exponent = {};
+        group.exponent += cycle % 2;
     }
 
-    // a*x^n*b*x^m
-    if (auto exprCase = RecursiveCast<Multiply<Multiply<Expression, Exponent<Expression>>, Multiply<Expression, Exponent<Expression>>>>(simplifiedMultiply); exprCase != nullptr) {
-        if (exprCase->GetMostSigOp().GetLeastSigOp().GetMostSigOp().Equals(exprCase->GetLeastSigOp().GetLeastSigOp().GetMostSigOp())) {
-            auto msOp = Multiply<Expression> { exprCase->GetMostSigOp().GetMostSigOp(), exprCase->GetLeastSigOp().GetMostSigOp() }.Accept(*this);
-            if (!msOp) {
-                return msOp;
-            }
-            auto lsOp = Add<Expression> { exprCase->GetLeastSigOp().GetLeastSigOp().GetLeastSigOp(), exprCase->GetMostSigOp().GetLeastSigOp().GetLeastSigOp() }.Accept(*this);
-            if (!lsOp) {
-                return lsOp;
-            }
-            return gsl_lite::not_null { std::make_unique<Multiply<Expression>>(
-                *(msOp.value()),
-                Exponent<Expression> { exprCase->GetMostSigOp().GetLeastSigOp().GetMostSigOp(),
-                    *(lsOp.value()) }) };
-        }
+    if (std::abs(constant) <= EPSILON) {
+        return gsl_lite::not_null { std::make_unique<Real>(0.0) };
     }
 
-    if (auto mul = RecursiveCast<Multiply<Real, Add<>>>(simplifiedMultiply); mul != nullptr) {
-        auto lhs = mul->GetMostSigOp();
-        auto rhs = mul->GetLeastSigOp();
-        if (options.distributivePolicy == SimplifyOpts::DistributivePolicy::PREFER
-            || std::abs(lhs.GetValue() + 1.0) <= EPSILON) {
-            return Add { Multiply { lhs, rhs.GetMostSigOp() },
-                Multiply { lhs, rhs.GetLeastSigOp() } }
-                .Accept(*this);
-        }
+    // a scalar multiple of a matrix is folded into the matrix
+    if (ruleGroups.matrix && !matrices.empty() && constant != 1.0) {
+        matrices.front() *= constant;
+        constant = 1.0;
     }
 
-    // multiply add like terms
-    std::vector<std::unique_ptr<Expression>> multiplies;
     std::vector<std::unique_ptr<Expression>> vals;
-    simplifiedMultiply.Flatten(multiplies);
-    for (const auto& multiplicand : multiplies) {
-        size_t i = 0;
-        if (auto real = RecursiveCast<Real>(*multiplicand); real != nullptr) {
-            for (; i < vals.size(); i++) {
-                if (auto valI = RecursiveCast<Real>(*vals[i]); valI != nullptr) {
-                    vals[i] = Real { valI->GetValue() * real->GetValue() }.Generalize();
-                    break;
-                }
-            }
-            if (i >= vals.size()) {
-                // check to make sure it is one thing only
-                vals.push_back(multiplicand->Generalize());
+    vals.reserve(groups.size() + matrices.size());
+
+    for (std::size_t i = 0; i < groups.size(); ++i) {
+        const LikeFactors& group = groups[i];
+
+        if (i == constantIndex) {
+            if (constant != 1.0) {
+                vals.push_back(std::make_unique<Real>(constant));
             }
             continue;
         }
-        // single i
-        if (auto img = RecursiveCast<Imaginary>(*multiplicand); img != nullptr) {
-            for (; i < vals.size(); i++) {
-                if (auto valI = RecursiveCast<Exponent<Imaginary, Expression>>(*vals[i]); valI != nullptr) {
-                    auto lsOp = Add<Expression> { valI->GetLeastSigOp(), Real { 1.0 } }.Accept(*this);
-                    if (!lsOp) {
-                        return lsOp;
-                    }
-                    vals[i] = Exponent<Expression> { Imaginary {}, *(lsOp.value()) }.Generalize();
-                    break;
-                }
-            }
-            if (i >= vals.size()) {
-                // check to make sure it is one thing only
-                vals.push_back(Exponent<Expression> { Imaginary {}, Real { 1.0 } }.Generalize());
+
+        if (i == matrixIndex) {
+            for (MatrixXXD& matrix : matrices) {
+                vals.push_back(std::make_unique<Matrix>(std::move(matrix)));
             }
             continue;
         }
-        // i^n
-        if (auto img = RecursiveCast<Exponent<Imaginary, Expression>>(*multiplicand); img != nullptr) {
-            for (; i < vals.size(); i++) {
-                if (auto valI = RecursiveCast<Exponent<Imaginary, Expression>>(*vals[i]); valI != nullptr) {
-                    auto lsOp = Add<Expression> { valI->GetLeastSigOp(), img->GetLeastSigOp() }.Accept(*this);
-                    if (!lsOp) {
-                        return lsOp;
-                    }
-                    vals[i] = Exponent<Expression> { Imaginary {}, *(lsOp.value()) }.Generalize();
-                    break;
-                }
-            }
-            if (i >= vals.size()) {
-                // check to make sure it is one thing only
-                // vals.push_back(Multiply<Expression> { img->GetMostSigOp(), Imaginary {} }.Generalize());
-                vals.push_back(img->Generalize());
+
+        const double power = group.exponent.Get();
+
+        if (group.symbolicExponents.empty()) {
+            if (power == 1.0) {
+                vals.push_back(group.base->Generalize());
+            } else if (power != 0.0) {
+                vals.push_back(std::make_unique<Exponent<Expression>>(*group.base, Real { power }));
             }
             continue;
         }
-        // expr^n
-        if (auto expr = RecursiveCast<Exponent<Expression, Expression>>(*multiplicand); expr != nullptr) {
-            for (; i < vals.size(); i++) {
-                if (auto valI = RecursiveCast<Exponent<Expression, Expression>>(*vals[i]); valI != nullptr) {
-                    if (valI->GetMostSigOp().Equals(expr->GetMostSigOp())) {
-                        auto lsOp = Add<Expression> { valI->GetLeastSigOp(), expr->GetLeastSigOp() }.Accept(*this);
-                        if (!lsOp) {
-                            return lsOp;
-                        }
-                        vals[i] = Exponent<Expression> { valI->GetMostSigOp(), *(lsOp.value()) }.Generalize();
-                        break;
-                    }
-                }
-            }
-            if (i >= vals.size()) {
-                // check to make sure it is one thing only
-                // vals.push_back(Multiply<Expression> { img->GetMostSigOp(), Imaginary {} }.Generalize());
-                vals.push_back(expr->Generalize());
-            }
-            continue;
+
+        std::vector<std::unique_ptr<Expression>> exponents;
+        if (group.realExponents > 0) {
+            exponents.push_back(std::make_unique<Real>(power));
         }
-        // single expr
-        if (auto expr = RecursiveCast<Expression>(*multiplicand); expr != nullptr) {
-            for (; i < vals.size(); i++) {
-                if (auto valI = RecursiveCast<Exponent<Expression, Expression>>(*vals[i]); valI != nullptr) {
-                    auto lsOp = Add<Expression> { valI->GetLeastSigOp(), Real { 1.0 } }.Accept(*this);
-                    if (!lsOp) {
-                        return lsOp;
-                    }
-                    if (valI->GetMostSigOp().Equals(*expr)) {
-                        vals[i] = Exponent<Expression> { valI->GetMostSigOp(), *(lsOp.value()) }.Generalize();
-                        break;
-                    }
-                }
-            }
-            if (i >= vals.size()) {
-                // check to make sure it is one thing only
-                vals.push_back(Exponent<Expression> { *expr, Real { 1.0 } }.Generalize());
-            }
+        for (const Expression* symbolic : group.symbolicExponents) {
+            exponents.push_back(symbolic->Copy());
+        }
+
+        if (exponents.size() == 1) {
+            vals.push_back(std::make_unique<Exponent<Expression>>(group.base->Copy(), std::move(exponents.front())));
             continue;
         }
-    }
 
-    // makes all expr^1 into expr
-    for (auto& val : vals) {
-        if (auto exp = RecursiveCast<Exponent<Expression, Real>>(*val); exp != nullptr) {
-            if (exp->GetLeastSigOp().GetValue() == 1.0) {
-                val = exp->GetMostSigOp().Generalize();
-            }
+        auto addResult = BuildFromVector<Add>(std::move(exponents))->Accept(*this);
+        if (!addResult) {
+            return addResult;
         }
-        if (auto mul = RecursiveCast<Multiply<Real, Expression>>(*val); mul != nullptr) {
-            if (mul->GetMostSigOp().GetValue() == 1.0) {
-                val = mul->GetLeastSigOp().Generalize();
-            }
+        vals.push_back(std::make_unique<Exponent<Expression>>(group.base->Copy(), std::move(addResult).value()));
+    }
+
+    // Powers of i may have negated the coefficient of a product without a number, in which case
+    // the coefficient leads the product.
+    if (!constantIndex && constant != 1.0) {
+        vals.insert(vals.begin(), std::make_unique<Real>(constant));
+        constantIndex = 0;
+    }
+
+    if (vals.empty()) {
+        return gsl_lite::not_null { std::make_unique<Real>(constant) };
+    }
+
+    if (vals.size() == 1) {
+        return gsl_lite::not_null { std::move(vals.front()) };
+    }
+
+    // a(b + c) = ab + ac, when distributing is preferred or a is -1
+    if (vals.size() == 2 && constant != 1.0 && vals[constantIndex == 0 ? 1 : 0]->Is<Add>()
+        && (options.distributivePolicy == SimplifyOpts::DistributivePolicy::PREFER || std::abs(constant + 1.0) <= EPSILON)) {
+        std::vector<const Expression*> addends;
+        static_cast<const Add<>&>(*vals[constantIndex == 0 ? 1 : 0]->Generalize()).Flatten(addends);
+
+        std::vector<std::unique_ptr<Expression>> distributed;
+        for (const Expression* addend : addends) {
+            distributed.push_back(std::make_unique<Multiply<Expression>>(Real { constant }, *addend));
         }
+
+        return BuildFromVector<Add>(std::move(distributed))->Accept(*this);
     }
 
-    return gsl_lite::not_null { BuildFromVector<Multiply>(vals) };
+    return gsl_lite::not_null<std::unique_ptr<Expression>> { BuildFromVector<Multiply>(std::move(vals)) };
 }
 
-auto SimplifyVisitor::TypedVisit(const Divide<>& divide) -> RetT
+auto SimplifyVisitor::Simplify(const Divide<>& divide) -> RetT
 {
-    auto mostSigOp = divide.GetMostSigOp().Copy();
-    auto leastSigOp = divide.GetLeastSigOp().Copy();
-    if (!mostSigOp) {
+    if (!divide.HasMostSigOp()) {
         return std::unexpected { "Missing most significant operand." };
     }
-    if (!leastSigOp) {
+    if (!divide.HasLeastSigOp()) {
         return std::unexpected { "Missing least significant operand." };
     }
 
-    auto simplifiedMostSigOpResult = mostSigOp->Accept(*this);
-    auto simplifiedLeastSigOpResult = leastSigOp->Accept(*this);
+    auto [simplifiedMostSigOpResult, simplifiedLeastSigOpResult] = SimplifyOperands(divide.GetMostSigOp(), divide.GetLeastSigOp());
 
     if (!simplifiedMostSigOpResult) {
         return std::unexpected { simplifiedMostSigOpResult.error() };
@@ -869,251 +1019,162 @@ auto SimplifyVisitor::TypedVisit(const Divide<>& divide) -> RetT
         return std::unexpected { simplifiedLeastSigOpResult.error() };
     }
 
-    auto simplifiedDividend = std::move(simplifiedMostSigOpResult).value();
-    auto simplifiedDivider = std::move(simplifiedLeastSigOpResult).value();
-
-    Divide simplifiedDivide { *simplifiedDividend, *simplifiedDivider };
+    Divide<> simplifiedDivide { std::move(simplifiedMostSigOpResult).value(), std::move(simplifiedLeastSigOpResult).value() };
+    const auto& simplifiedDividend = simplifiedDivide.GetMostSigOp();
+    const auto& simplifiedDivider = simplifiedDivide.GetLeastSigOp();
 
-    if (auto realCase = RecursiveCast<Divide<Real>>(simplifiedDivide); realCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Divide: a / b" }; auto realCase = rule.Match<Divide<Real>>(simplifiedDivide)) {
         const Real& dividend = realCase->GetMostSigOp();
         const Real& divisor = realCase->GetLeastSigOp();
         return gsl_lite::not_null { std::make_unique<Real>(dividend.GetValue() / divisor.GetValue()) };
     }
 
     // log(a)/log(b)=log[b](a)
-    if (auto logCase = RecursiveCast<Divide<Log<Expression, Expression>, Log<Expression, Expression>>>(simplifiedDivide); logCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Divide: log(a) / log(b)" }; auto logCase = ruleGroups.logarithm ? rule.Match<Divide<Log<Expression, Expression>, Log<Expression, Expression>>>(simplifiedDivide) : nullptr) {
         if (logCase->GetMostSigOp().GetMostSigOp().Equals(logCase->GetLeastSigOp().GetMostSigOp())) {
             const IExpression auto& base = logCase->GetLeastSigOp().GetLeastSigOp();
             const IExpression auto& argument = logCase->GetMostSigOp().GetLeastSigOp();
             return gsl_lite::not_null { std::make_unique<Log<Expression>>(base, argument) };
         }
     }
-    // convert the terms in numerator and denominator into a vector to make manipulations easier
-    std::vector<std::unique_ptr<Expression>> numerator;
-    std::vector<std::unique_ptr<Expression>> denominator;
-    std::vector<std::unique_ptr<Expression>> result;
-    std::vector<std::unique_ptr<Expression>> numeratorVals;
-    std::vector<std::unique_ptr<Expression>> denominatorVals;
+    RuleScope rule { profiler.get(), "Divide: cancel factors" };
+    rule.Apply();
+
+    // Both sides are split into factors and each factor into a base and an exponent. Factors are
+    // grouped by the hash of their base, so that the exponents of a base in the denominator are
+    // subtracted from its exponents in the numerator, and the quotient is rebuilt once.
+    struct CancelledFactors {
+        const Expression* base = nullptr;
+        CompensatedSum exponent {};
+        std::size_t realExponents = 0;
+        std::vector<const Expression*> numeratorExponents {};
+        std::vector<const Expression*> denominatorExponents {};
+        bool inNumerator = false;
+    };
+
+    std::vector<CancelledFactors> groups;
+    std::unordered_map<const Expression*, std::size_t, ExpressionHash, ExpressionEqual> groupsByBase;
+    double numeratorConstant = 1.0;
+    double denominatorConstant = 1.0;
+
+    // Each factor is paired with whether it is in the numerator. Nested quotients are unpacked, as
+    // (a / b) / (c / d) = ad / bc.
+    std::vector<std::pair<const Expression*, bool>> factors { { &simplifiedDividend, true }, { &simplifiedDivider, false } };
+
+    for (std::size_t i = 0; i < factors.size(); ++i) {
+        const auto [factor, inNumerator] = factors[i];
+
+        if (auto divideCase = Match<Divide<>>(*factor)) {
+            factors.emplace_back(&divideCase->GetMostSigOp(), inNumerator);
+            factors.emplace_back(&divideCase->GetLeastSigOp(), !inNumerator);
+            continue;
+        }
 
-    if (auto multipliedNumerator = RecursiveCast<Multiply<Expression>>(*simplifiedDividend); multipliedNumerator != nullptr) {
-        multipliedNumerator->Flatten(numerator);
-    } else {
-        numerator.push_back(simplifiedDividend->Copy());
-    }
+        if (factor->Is<Multiply>()) {
+            // Generalizing shares the operands, so they are still owned by simplifiedDivide.
+            std::vector<const Expression*> flattened;
+            static_cast<const Multiply<>&>(*factor->Generalize()).Flatten(flattened);
+            for (const Expression* operand : flattened) {
+                factors.emplace_back(operand, inNumerator);
+            }
+            continue;
+        }
 
-    if (auto multipliedDenominator = RecursiveCast<Multiply<Expression>>(*simplifiedDivider); multipliedDenominator != nullptr) {
-        multipliedDenominator->Flatten(denominator);
-    } else {
-        denominator.push_back(simplifiedDivider->Copy());
-    }
+        if (factor->Is<Real>()) {
+            (inNumerator ? numeratorConstant : denominatorConstant) *= static_cast<const Real&>(*factor).GetValue();
+            continue;
+        }
 
-    // now that we have the terms in a vector, we have to cancel like terms and simplify them
-    result.reserve(numerator.size());
-    for (const auto& num : numerator) {
-        if (auto div = RecursiveCast<Divide<Expression>>(*num); div != nullptr) {
-            std::vector<std::unique_ptr<Expression>> flat_n;
-            std::vector<std::unique_ptr<Expression>> flat_d;
-            if (auto mN = RecursiveCast<Multiply<Expression>>(*div); mN != nullptr) {
-                mN->Flatten(flat_n);
-            } else {
-                result.push_back(div->GetMostSigOp().Copy());
-            }
+        const Expression* base = factor;
+        const Expression* exponent = nullptr;
 
-            if (auto mD = RecursiveCast<Multiply<Expression>>(*div); mD != nullptr) {
-                mD->Flatten(flat_d);
-            } else {
-                denominator.push_back(div->GetLeastSigOp().Copy());
-            }
+        if (auto exponentCase = Match<Exponent<>>(*factor)) {
+            base = &exponentCase->GetMostSigOp();
+            exponent = &exponentCase->GetLeastSigOp();
+        }
 
-            for (const auto& v : flat_n) {
-                result.push_back(v->Copy());
-            }
-            for (const auto& v : flat_d) {
-                denominator.push_back(v->Copy());
-            }
+        const auto [it, inserted] = groupsByBase.try_emplace(base, groups.size());
+        if (inserted) {
+            groups.push_back({ base });
+        }
+
+        CancelledFactors& group = groups[it->second];
+        group.inNumerator = group.inNumerator || inNumerator;
+        const double sign = inNumerator ? 1.0 : -1.0;
+
+        if (exponent == nullptr) {
+            group.exponent += sign;
+            ++group.realExponents;
+        } else if (exponent->Is<Real>()) {
+            group.exponent += sign * static_cast<const Real&>(*exponent).GetValue();
+            ++group.realExponents;
         } else {
-            result.push_back(num->Copy());
+            (inNumerator ? group.numeratorExponents : group.denominatorExponents).push_back(exponent);
         }
     }
 
-    for (const auto& denom : denominator) {
-        size_t i = 0;
-        if (auto real = RecursiveCast<Real>(*denom); real != nullptr) {
-            for (; i < result.size(); i++) {
-                if (auto resI = RecursiveCast<Real>(*result[i]); resI != nullptr) {
-                    result[i] = Real { resI->GetValue() / real->GetValue() }.Generalize();
-                    break;
-                }
-            }
-            if (i >= result.size()) {
-                result.push_back(Real { 1 / real->GetValue() }.Generalize());
-            }
-            continue;
-        }
-        if (auto img = RecursiveCast<Imaginary>(*denom); img != nullptr) {
-            for (; i < result.size(); i++) {
-                if (auto resI = RecursiveCast<Imaginary>(*result[i]); resI != nullptr) {
-                    result[i] = Real { 1.0 }.Generalize();
-                    break;
-                }
-            }
-            if (i >= result.size()) {
-                result.push_back(Exponent<Expression> { Imaginary {}, Real { -1.0 } }.Generalize());
-            }
-            continue;
-        }
-        if (auto var = RecursiveCast<Variable>(*denom); var != nullptr) {
-            for (; i < result.size(); i++) {
-                if (auto resIexp = RecursiveCast<Exponent<Variable, Expression>>(*result[i]); resIexp != nullptr) {
-                    if (resIexp->GetMostSigOp().Equals(*var)) {
-                        auto lsOp = Subtract<Expression> { resIexp->GetLeastSigOp(), Real { 1.0 } }.Accept(*this);
-                        if (!lsOp) {
-                            return lsOp;
-                        }
-                        result[i] = Exponent<Expression> { *var, *(lsOp.value()) }.Generalize();
-                        break;
-                    }
-                } else if (auto resI = RecursiveCast<Variable>(*result[i]); resI != nullptr) {
-                    if (resI->Equals(*var)) {
-                        result[i] = Real { 1.0 }.Generalize();
-                        break;
-                    }
-                }
-            }
-            if (i >= result.size()) {
-                result.push_back(Exponent<Expression> { *var, Real { -1.0 } }.Generalize());
-            }
-            continue;
+    // Dividing by zero is undefined, so neither the constants nor the other factors are folded.
+    if (denominatorConstant == 0.0) {
+        return gsl_lite::not_null { simplifiedDivide.Copy() };
+    }
+
+    if (std::abs(numeratorConstant) <= EPSILON) {
+        return gsl_lite::not_null { std::make_unique<Real>(0.0) };
+    }
+
+    std::vector<std::unique_ptr<Expression>> numeratorVals;
+    std::vector<std::unique_ptr<Expression>> denominatorVals;
+
+    if (const double constant = numeratorConstant / denominatorConstant; constant != 1.0) {
+        numeratorVals.push_back(std::make_unique<Real>(constant));
+    }
+
+    const auto emit = [&numeratorVals, &denominatorVals](const Expression& base, double power) {
+        auto& vals = power < 0.0 ? denominatorVals : numeratorVals;
+        if (std::abs(power) == 1.0) {
+            vals.push_back(base.Copy());
+        } else if (power != 0.0) {
+            vals.push_back(std::make_unique<Exponent<Expression>>(base, Real { std::abs(power) }));
         }
-        if (auto var = RecursiveCast<Exponent<Variable, Expression>>(*denom); var != nullptr) {
-            for (; i < result.size(); i++) {
-                if (auto resIexp = RecursiveCast<Exponent<Variable, Expression>>(*result[i]); resIexp != nullptr) {
-                    if (resIexp->GetMostSigOp().Equals(var->GetMostSigOp())) {
-                        auto lsOp = Subtract<Expression> { resIexp->GetLeastSigOp(), var->GetLeastSigOp() }.Accept(*this);
-                        if (!lsOp) {
-                            return lsOp;
-                        }
-                        result[i] = Exponent<Expression> { var->GetMostSigOp(), *(lsOp.value()) }.Generalize();
-                        break;
-                    }
-                } else if (auto resI = RecursiveCast<Variable>(*result[i]); resI != nullptr) {
-                    if (resI->Equals(*var)) {
-                        auto lsOp = Subtract<Expression> { Real { 1.0 }, var->GetLeastSigOp() }.Accept(*this);
-                        if (!lsOp) {
-                            return lsOp;
-                        }
-                        result[i] = Exponent<Expression> { var->GetMostSigOp(), *(lsOp.value()) }.Generalize();
-                    }
-                }
-            }
-            if (i >= result.size()) {
-                result.push_back(Exponent<Expression> { var->GetMostSigOp(), Multiply { Real { -1.0 }, var->GetLeastSigOp() } }.Generalize());
-            }
+    };
+
+    for (const CancelledFactors& group : groups) {
+        const double power = group.exponent.Get();
+
+        if (group.numeratorExponents.empty() && group.denominatorExponents.empty()) {
+            emit(*group.base, power);
             continue;
         }
-        if (auto expExpr = RecursiveCast<Exponent<Expression>>(*denom); expExpr != nullptr) {
-            for (; i < result.size(); i++) {
-                if (auto resExpr = RecursiveCast<Exponent<Expression, Expression>>(*result[i]); resExpr != nullptr) {
-                    if (expExpr->GetMostSigOp().Equals(resExpr->GetMostSigOp())) {
-                        auto lsOp = Subtract { resExpr->GetLeastSigOp(), expExpr->GetLeastSigOp() }.Accept(*this);
-                        if (!lsOp) {
-                            return lsOp;
-                        }
-                        auto resultVisited = Exponent { expExpr->GetMostSigOp(), *(lsOp.value()) }.Accept(*this);
-                        if (!resultVisited) {
-                            return resultVisited;
-                        }
-                        result[i] = std::move(resultVisited).value();
-                        break;
-                    }
-                } else if (result[i]->Equals(expExpr->GetMostSigOp())) {
-                    auto lsOp = Subtract { Real { 1.0 }, expExpr->GetLeastSigOp() }.Accept(*this);
-                    if (!lsOp) {
-                        return lsOp;
-                    }
-                    auto resultVisited = Exponent { expExpr->GetMostSigOp(), *(lsOp.value()) }.Accept(*this);
-                    if (!resultVisited) {
-                        return resultVisited;
-                    }
-                    result[i] = std::move(resultVisited).value();
-                    break;
-                }
-            }
-            if (i >= result.size()) {
-                auto resultVisited = Exponent<Expression> { expExpr->GetMostSigOp(), Multiply { Real { -1.0 }, expExpr->GetLeastSigOp() } }.Accept(*this);
-                if (!resultVisited) {
-                    return resultVisited;
-                }
-                result.push_back(std::move(resultVisited).value());
-            }
-            continue;
+
+        // A base that only appears in the denominator stays there, otherwise the difference of its
+        // exponents is moved to the numerator.
+        const bool inNumerator = group.inNumerator;
+        const double sign = inNumerator ? 1.0 : -1.0;
+
+        std::vector<std::unique_ptr<Expression>> exponents;
+        if (group.realExponents > 0) {
+            exponents.push_back(std::make_unique<Real>(sign * power));
         }
-        for (; i < result.size(); i++) {
-            if (auto resExpr = RecursiveCast<Exponent<Expression, Expression>>(*result[i]); resExpr != nullptr) {
-                if (denom->Equals(resExpr->GetMostSigOp())) {
-                    auto lsOp = Subtract { resExpr->GetLeastSigOp(), Real { 1.0 } }.Accept(*this);
-                    if (!lsOp) {
-                        return lsOp;
-                    }
-                    auto resultVisited = Exponent { *denom, *(lsOp.value()) }.Accept(*this);
-                    if (!resultVisited) {
-                        return resultVisited;
-                    }
-                    result[i] = std::move(resultVisited).value();
-                    break;
-                }
-            } else if (result[i]->Equals(*denom)) {
-                result[i] = Real { 1.0 }.Generalize();
-                break;
-            }
+        for (const Expression* exponent : group.numeratorExponents) {
+            exponents.push_back(exponent->Copy());
         }
-        if (i >= result.size()) {
-            result.push_back(Exponent<Expression> { *denom, Real { -1.0 } }.Generalize());
+        for (const Expression* exponent : group.denominatorExponents) {
+            exponents.push_back(inNumerator ? std::make_unique<Multiply<Expression>>(Real { -1.0 }, *exponent) : exponent->Copy());
         }
-    }
 
-    // rebuild into tree
-    for (const auto& val : result) {
-        if (auto valI = RecursiveCast<Real>(*val); valI != nullptr) {
-            if (valI->GetValue() != 1.0) {
-                numeratorVals.push_back(valI->Generalize());
-            }
-        } else if (auto var = RecursiveCast<Variable>(*val); var != nullptr) {
-            numeratorVals.push_back(val->Generalize());
-        } else if (auto img = RecursiveCast<Imaginary>(*val); img != nullptr) {
-            numeratorVals.push_back(val->Generalize());
-        } else if (auto expR = RecursiveCast<Exponent<Expression, Real>>(*val); expR != nullptr) {
-            if (expR->GetLeastSigOp().GetValue() < 0.0) {
-                denominatorVals.push_back(Exponent { expR->GetMostSigOp(), Real { expR->GetLeastSigOp().GetValue() * -1.0 } }.Generalize());
-            } else {
-                numeratorVals.push_back(val->Generalize());
-            }
-        } else if (auto exp = RecursiveCast<Exponent<Expression, Multiply<Real, Expression>>>(*val); exp != nullptr) {
-            if (exp->GetLeastSigOp().GetMostSigOp().GetValue() < 0.0) {
-                denominatorVals.push_back(Exponent { exp->GetMostSigOp(), exp->GetLeastSigOp().GetLeastSigOp() }.Generalize());
-            } else {
-                numeratorVals.push_back(val->Generalize());
-            }
-        } else {
-            numeratorVals.push_back(val->Generalize());
+        const auto exponentSum = exponents.size() == 1 ? std::move(exponents.front()) : BuildFromVector<Add>(std::move(exponents));
+        auto exponentResult = exponentSum->Accept(*this);
+        if (!exponentResult) {
+            return exponentResult;
         }
-    }
 
-    // makes expr^1 into expr
-    for (auto& val : numeratorVals) {
-        if (auto exp = RecursiveCast<Exponent<Expression, Real>>(*val); exp != nullptr) {
-            if (exp->GetLeastSigOp().GetValue() == 1.0) {
-                val = exp->GetMostSigOp().Generalize();
-            }
+        std::unique_ptr<Expression> exponent = std::move(exponentResult).value();
+        if (exponent->Is<Real>()) {
+            emit(*group.base, sign * static_cast<const Real&>(*exponent).GetValue());
+            continue;
         }
-    }
 
-    for (auto& val : denominatorVals) {
-        if (auto exp = RecursiveCast<Exponent<Expression, Real>>(*val); exp != nullptr) {
-            if (exp->GetLeastSigOp().GetValue() == 1.0) {
-                val = exp->GetMostSigOp().Generalize();
-            }
-        }
+        (inNumerator ? numeratorVals : denominatorVals).push_back(std::make_unique<Exponent<Expression>>(group.base->Copy(), std::move(exponent)));
     }
 
     auto dividend = numeratorVals.size() == 1 ? std::move(numeratorVals.front()) : BuildFromVector<Multiply>(numeratorVals);
@@ -1124,7 +1185,7 @@ auto SimplifyVisitor::TypedVisit(const Divide<>& divide) -> RetT
         return gsl_lite::not_null { Divide { Real { 1.0 }, *divisor }.Copy() };
 
     if (dividend && !divisor)
-        return gsl_lite::not_null { dividend->Copy() };
+        return gsl_lite::not_null { std::move(dividend) };
 
     if (!dividend && !divisor)
         return gsl_lite::not_null { Real { 1.0 }.Copy() };
@@ -1132,12 +1193,11 @@ auto SimplifyVisitor::TypedVisit(const Divide<>& divide) -> RetT
     return gsl_lite::not_null { Divide { *dividend, *divisor }.Copy() };
 }
 
-auto SimplifyVisitor::TypedVisit(const Exponent<>& exponent) -> RetT
+auto SimplifyVisitor::Simplify(const Exponent<>& exponent) -> RetT
 {
     static auto match_cast = MatchCast<Expression>()
                                  .Case(
                                      [](const Exponent<Expression, Real>& zeroCase) -> bool {
-                                         // TODO: Optimize. We're calling RecursiveCast<Expression<Real, Expression> twice. Perhaps a map of expression types to a vector of lambdas?
                                          const Real& power = zeroCase.GetLeastSigOp();
                                          return power.GetValue() == 0.0;
                                      },
@@ -1175,35 +1235,6 @@ auto SimplifyVisitor::TypedVisit(const Exponent<>& exponent) -> RetT
                                      [](const Exponent<Real, Expression>&, const void*) -> std::expected<gsl_lite::not_null<std::unique_ptr<Expression>>, std::string_view> {
                                          return gsl_lite::make_not_null(std::make_unique<Real>(1.0));
                                      })
-                                 .Case(
-                                     [](const Exponent<Imaginary, Real>&) -> bool { return true; },
-                                     [](const Exponent<Imaginary, Real>& ImgCase, const void*) -> std::expected<gsl_lite::not_null<std::unique_ptr<Expression>>, std::string_view> {
-                                         switch (const auto power = std::fmod((ImgCase.GetLeastSigOp()).GetValue(), 4); static_cast<int>(power)) {
-                                         case 0:
-                                             return gsl_lite::make_not_null(std::make_unique<Real>(1));
-                                         case 1:
-                                             return gsl_lite::make_not_null(std::make_unique<Imaginary>());
-                                         case 2:
-                                             return gsl_lite::make_not_null(std::make_unique<Real>(-1));
-                                         case 3:
-                                             return gsl_lite::make_not_null(std::make_unique<Negate<Imaginary>>(Imaginary {}));
-                                         default:
-                                             return std::unexpected { "std::fmod returned an invalid value" };
-                                         }
-                                     })
-                                 .Case(
-                                     [](const Exponent<Multiply<Real, Expression>, Real>& ImgCase) -> bool {
-                                         return ImgCase.GetMostSigOp().GetMostSigOp().GetValue() < 0 && ImgCase.GetLeastSigOp().GetValue() == 0.5;
-                                     },
-                                     [](const Exponent<Multiply<Real, Expression>, Real>& ImgCase, const void*) -> std::expected<gsl_lite::not_null<std::unique_ptr<Expression>>, std::string_view> {
-                                         Multiply mul {
-                                             Multiply { Real { pow(std::abs(ImgCase.GetMostSigOp().GetMostSigOp().GetValue()), 0.5) },
-                                                 Exponent { ImgCase.GetMostSigOp().GetLeastSigOp(), Real { 0.5 } } },
-                                             Imaginary {}
-                                         };
-
-                                         return gsl_lite::make_not_null(mul.Copy());
-                                     })
                                  .Case(
                                      [](const Exponent<Exponent<>, Expression>&) -> bool { return true; },
                                      [](const Exponent<Exponent<>, Expression>& expExpCase, SimplifyVisitor* visitor) -> std::expected<gsl_lite::not_null<std::unique_ptr<Expression>>, std::string_view> {
@@ -1213,26 +1244,59 @@ auto SimplifyVisitor::TypedVisit(const Exponent<>& exponent) -> RetT
                                          }
                                          Exponent exp { expExpCase.GetMostSigOp().GetMostSigOp(), *(lsOp.value()) };
                                          return gsl_lite::make_not_null(exp.Copy());
-                                     })
-                                 .Case(
-                                     [](const Exponent<Expression, Log<>>& logCase) -> bool {
-                                         return logCase.GetMostSigOp().Equals(logCase.GetLeastSigOp().GetMostSigOp());
-                                     },
-                                     [](const Exponent<Expression, Log<>>& logCase, const void*) -> std::expected<gsl_lite::not_null<std::unique_ptr<Expression>>, std::string_view> {
-                                         return gsl_lite::make_not_null(logCase.GetLeastSigOp().GetLeastSigOp().Copy());
                                      });
 
-    auto mostSigOp = exponent.GetMostSigOp().Copy();
-    auto leastSigOp = exponent.GetLeastSigOp().Copy();
-    if (!mostSigOp) {
+    // The rules for the imaginary unit and for logarithms are kept apart, so that they can be skipped
+    // when their groups are disabled. They are tried after the rules above, which changes no result,
+    // as none of them matches the same expressions as a rule it is now tried after.
+    static auto complex_match_cast = MatchCast<Expression>()
+                                         .Case(
+                                             [](const Exponent<Imaginary, Real>&) -> bool { return true; },
+                                             [](const Exponent<Imaginary, Real>& ImgCase, const void*) -> std::expected<gsl_lite::not_null<std::unique_ptr<Expression>>, std::string_view> {
+                                                 switch (const auto power = std::fmod((ImgCase.GetLeastSigOp()).GetValue(), 4); static_cast<int>(power)) {
+                                                 case 0:
+                                                     return gsl_lite::make_not_null(std::make_unique<Real>(1));
+                                                 case 1:
+                                                     return gsl_lite::make_not_null(std::make_unique<Imaginary>());
+                                                 case 2:
+                                                     return gsl_lite::make_not_null(std::make_unique<Real>(-1));
+                                                 case 3:
+                                                     return gsl_lite::make_not_null(std::make_unique<Negate<Imaginary>>(Imaginary {}));
+                                                 default:
+                                                     return std::unexpected { "std::fmod returned an invalid value" };
+                                                 }
+                                             })
+                                         .Case(
+                                             [](const Exponent<Multiply<Real, Expression>, Real>& ImgCase) -> bool {
+                                                 return ImgCase.GetMostSigOp().GetMostSigOp().GetValue() < 0 && ImgCase.GetLeastSigOp().GetValue() == 0.5;
+                                             },
+                                             [](const Exponent<Multiply<Real, Expression>, Real>& ImgCase, const void*) -> std::expected<gsl_lite::not_null<std::unique_ptr<Expression>>, std::string_view> {
+                                                 Multiply mul {
+                                                     Multiply { Real { pow(std::abs(ImgCase.GetMostSigOp().GetMostSigOp().GetValue()), 0.5) },
+                                                         Exponent { ImgCase.GetMostSigOp().GetLeastSigOp(), Real { 0.5 } } },
+                                                     Imaginary {}
+                                                 };
+
+                                                 return gsl_lite::make_not_null(mul.Copy());
+                                             });
+
+    static auto logarithm_match_cast = MatchCast<Expression>()
+                                           .Case(
+                                               [](const Exponent<Expression, Log<>>& logCase) -> bool {
+                                                   return logCase.GetMostSigOp().Equals(logCase.GetLeastSigOp().GetMostSigOp());
+                                               },
+                                               [](const Exponent<Expression, Log<>>& logCase, const void*) -> std::expected<gsl_lite::not_null<std::unique_ptr<Expression>>, std::string_view> {
+                                                   return gsl_lite::make_not_null(logCase.GetLeastSigOp().GetLeastSigOp().Copy());
+                                               });
+
+    if (!exponent.HasMostSigOp()) {
         return std::unexpected { "Missing most significant operand." };
     }
-    if (!leastSigOp) {
+    if (!exponent.HasLeastSigOp()) {
         return std::unexpected { "Missing least significant operand." };
     }
 
-    auto simplifiedMostSigOpResult = mostSigOp->Accept(*this);
-    auto simplifiedLeastSigOpResult = leastSigOp->Accept(*this);
+    auto [simplifiedMostSigOpResult, simplifiedLeastSigOpResult] = SimplifyOperands(exponent.GetMostSigOp(), exponent.GetLeastSigOp());
 
     if (!simplifiedMostSigOpResult) {
         return std::unexpected { simplifiedMostSigOpResult.error() };
@@ -1241,28 +1305,41 @@ auto SimplifyVisitor::TypedVisit(const Exponent<>& exponent) -> RetT
         return std::unexpected { simplifiedLeastSigOpResult.error() };
     }
 
-    auto simplifiedBase = std::move(simplifiedMostSigOpResult).value();
-    auto simplifiedPower = std::move(simplifiedLeastSigOpResult).value();
+    const Exponent<> simplifiedExponent { std::move(simplifiedMostSigOpResult).value(), std::move(simplifiedLeastSigOpResult).value() };
+    static constexpr std::array<std::string_view, 6> rules {
+        "Exponent: x^0", "Exponent: 0^x", "Exponent: a^b", "Exponent: x^1", "Exponent: 1^x", "Exponent: (x^a)^b"
+    };
+    static constexpr std::array<std::string_view, 2> complexRules { "Exponent: i^n", "Exponent: (-ax)^0.5" };
+    static constexpr std::array<std::string_view, 1> logarithmRules { "Exponent: a^log[a](b)" };
+
+    const auto execute = [this, &simplifiedExponent](auto& cases, const auto& names) {
+        return RuleProfiler::Enabled && profiler
+            ? cases.Execute(simplifiedExponent, this, [this, &names](std::size_t index, bool hit, std::chrono::nanoseconds matchTime, std::chrono::nanoseconds transformTime) {
+                         profiler->Record(names[index], hit, matchTime, transformTime);
+                     }).value()
+            : cases.Execute(simplifiedExponent, this).value();
+    };
 
-    const Exponent simplifiedExponent { *simplifiedBase, *simplifiedPower };
-    auto matchResult = match_cast.Execute(simplifiedExponent, this).value();
+    auto matchResult = execute(match_cast, rules);
+    if (!matchResult && ruleGroups.complex) {
+        matchResult = execute(complex_match_cast, complexRules);
+    }
+    if (!matchResult && ruleGroups.logarithm) {
+        matchResult = execute(logarithm_match_cast, logarithmRules);
+    }
     return gsl_lite::not_null { matchResult ? std::move(matchResult) : std::move(simplifiedExponent.Copy()) };
 }
 
-auto SimplifyVisitor::TypedVisit(const Log<>& logIn) -> RetT
+auto SimplifyVisitor::Simplify(const Log<>& logIn) -> RetT
 {
-    auto mostSigOp = logIn.GetMostSigOp().Copy();
-    auto leastSigOp = logIn.GetLeastSigOp().Copy();
-
-    if (!mostSigOp) {
+    if (!logIn.HasMostSigOp()) {
         return std::unexpected { "Missing most significant operand." };
     }
-    if (!leastSigOp) {
+    if (!logIn.HasLeastSigOp()) {
         return std::unexpected { "Missing least significant operand." };
     }
 
-    auto simplifiedMostSigOpResult = mostSigOp->Accept(*this);
-    auto simplifiedLeastSigOpResult = leastSigOp->Accept(*this);
+    auto [simplifiedMostSigOpResult, simplifiedLeastSigOpResult] = SimplifyOperands(logIn.GetMostSigOp(), logIn.GetLeastSigOp());
 
     if (!simplifiedMostSigOpResult) {
         return std::unexpected { simplifiedMostSigOpResult.error() };
@@ -1271,18 +1348,19 @@ auto SimplifyVisitor::TypedVisit(const Log<>& logIn) -> RetT
         return std::unexpected { simplifiedLeastSigOpResult.error() };
     }
 
-    auto simplifiedBase = std::move(simplifiedMostSigOpResult).value();
-    auto simplifiedPower = std::move(simplifiedLeastSigOpResult).value();
+    const Log<> simplifiedLog { std::move(simplifiedMostSigOpResult).value(), std::move(simplifiedLeastSigOpResult).value() };
 
-    const Log simplifiedLog { *simplifiedBase, *simplifiedPower };
+    if (!ruleGroups.logarithm) {
+        return gsl_lite::not_null { simplifiedLog.Copy() };
+    }
 
-    if (const auto realBaseCase = RecursiveCast<Log<Real, Expression>>(simplifiedLog); realBaseCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Log: log[b](x), b <= 0 or b = 1" }; const auto realBaseCase = rule.Match<Log<Real, Expression>>(simplifiedLog)) {
         if (const Real& b = realBaseCase->GetMostSigOp(); b.GetValue() <= 0.0 || b.GetValue() == 1) {
             return gsl_lite::not_null { std::make_unique<Undefined>() };
         }
     }
 
-    if (const auto realExponentCase = RecursiveCast<Log<Expression, Real>>(simplifiedLog); realExponentCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Log: log[b](a), a <= 0 or a = 1" }; const auto realExponentCase = rule.Match<Log<Expression, Real>>(simplifiedLog)) {
         const Real& argument = realExponentCase->GetLeastSigOp();
 
         if (argument.GetValue() <= 0.0) {
@@ -1294,7 +1372,7 @@ auto SimplifyVisitor::TypedVisit(const Log<>& logIn) -> RetT
         }
     }
 
-    if (const auto realCase = RecursiveCast<Log<Real>>(simplifiedLog); realCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Log: log[b](a)" }; const auto realCase = rule.Match<Log<Real>>(simplifiedLog)) {
         const Real& base = realCase->GetMostSigOp();
         const Real& argument = realCase->GetLeastSigOp();
 
@@ -1302,21 +1380,21 @@ auto SimplifyVisitor::TypedVisit(const Log<>& logIn) -> RetT
     }
 
     // log(a) with a < 0 log(-a)
-    if (auto negCase = RecursiveCast<Log<Expression, Real>>(simplifiedLog); negCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Log: log(-a)" }; auto negCase = ruleGroups.complex ? rule.Match<Log<Expression, Real>>(simplifiedLog) : nullptr) {
         if (negCase->GetLeastSigOp().GetValue() < 0) {
             return gsl_lite::not_null { Add<Expression> { Log { negCase->GetMostSigOp(), Real { -1 * negCase->GetLeastSigOp().GetValue() } }, Multiply<Expression> { Imaginary {}, Pi {} } }.Generalize() };
         }
     }
 
     // log[a](a) = 1
-    if (const auto sameCase = RecursiveCast<Log<Expression, Expression>>(simplifiedLog); sameCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Log: log[a](a)" }; const auto sameCase = rule.Match<Log<Expression, Expression>>(simplifiedLog)) {
         if (sameCase->leastSigOp->Equals(*sameCase->mostSigOp)) {
             return gsl_lite::not_null { Real { 1 }.Generalize() };
         }
     }
 
     // log[a](b^x) = x * log[a](b)
-    if (const auto expCase = RecursiveCast<Log<Expression, Exponent<>>>(simplifiedLog); expCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Log: log[a](b^x)" }; const auto expCase = rule.Match<Log<Expression, Exponent<>>>(simplifiedLog)) {
         const auto exponent = expCase->GetLeastSigOp();
         const IExpression auto& log = Log<Expression>(expCase->GetMostSigOp(), exponent.GetMostSigOp()); // might need to check that it isnt nullptr
         const IExpression auto& factor = exponent.GetLeastSigOp();
@@ -1326,14 +1404,13 @@ auto SimplifyVisitor::TypedVisit(const Log<>& logIn) -> RetT
     return gsl_lite::not_null { simplifiedLog.Copy() };
 }
 
-auto SimplifyVisitor::TypedVisit(const Negate<Expression>& negate) -> RetT
+auto SimplifyVisitor::Simplify(const Negate<Expression>& negate) -> RetT
 {
-    auto op = negate.GetOperand().Copy();
-    if (!op) {
+    if (!negate.HasOperand()) {
         return std::unexpected { "Missing operand." };
     }
 
-    auto simplifiedMostSigOpResult = op->Accept(*this);
+    auto simplifiedMostSigOpResult = negate.GetOperand().Accept(*this);
 
     if (!simplifiedMostSigOpResult) {
         return std::unexpected { simplifiedMostSigOpResult.error() };
@@ -1344,14 +1421,13 @@ auto SimplifyVisitor::TypedVisit(const Negate<Expression>& negate) -> RetT
     return std::move(Multiply { Real { -1 }, *simplifiedOp }.Accept(*this)).value();
 }
 
-auto SimplifyVisitor::TypedVisit(const Sine<Expression>& sine) -> RetT
+auto SimplifyVisitor::Simplify(const Sine<Expression>& sine) -> RetT
 {
-    auto op = sine.GetOperand().Copy();
-    if (!op) {
+    if (!sine.HasOperand()) {
         return std::unexpected { "Missing operand." };
     }
 
-    auto simplifiedMostSigOpResult = op->Accept(*this);
+    auto simplifiedMostSigOpResult = sine.GetOperand().Accept(*this);
 
     if (!simplifiedMostSigOpResult) {
         return std::unexpected { simplifiedMostSigOpResult.error() };
@@ -1359,22 +1435,24 @@ auto SimplifyVisitor::TypedVisit(const Sine<Expression>& sine) -> RetT
 
     auto simplifiedOp = std::move(simplifiedMostSigOpResult).value();
 
+    if (!ruleGroups.trig) {
+        return gsl_lite::not_null { std::make_unique<Sine<Expression>>(*simplifiedOp) };
+    }
+
     return simplifiedOp->Accept(*this);
 }
 
-auto SimplifyVisitor::TypedVisit(const Derivative<>& derivative) -> RetT
+auto SimplifyVisitor::Simplify(const Derivative<>& derivative) -> RetT
 {
-    auto mostSigOp = derivative.GetMostSigOp().Copy();
-    auto leastSigOp = derivative.GetLeastSigOp().Copy();
-    if (!mostSigOp) {
+    if (!derivative.HasMostSigOp()) {
         return std::unexpected { "Missing most significant operand." };
     }
-    if (!leastSigOp) {
+    if (!derivative.HasLeastSigOp()) {
         return std::unexpected { "Missing least significant operand." };
     }
 
-    auto simplifiedMostSigOpResult = mostSigOp->Accept(*this);
-    auto simplifiedLeastSigOpResult = leastSigOp->Accept(*this);
+    auto simplifiedMostSigOpResult = derivative.GetMostSigOp().Accept(*this);
+    auto simplifiedLeastSigOpResult = derivative.GetLeastSigOp().Accept(*this);
 
     if (!simplifiedMostSigOpResult) {
         return simplifiedMostSigOpResult;
@@ -1385,6 +1463,11 @@ auto SimplifyVisitor::TypedVisit(const Derivative<>& derivative) -> RetT
 
     auto simplifiedExpression = std::move(simplifiedMostSigOpResult).value();
     auto simplifiedVar = std::move(simplifiedLeastSigOpResult).value();
+
+    if (!ruleGroups.calculus) {
+        return gsl_lite::not_null { std::make_unique<Derivative<Expression>>(*simplifiedExpression, *simplifiedVar) };
+    }
+
     auto simplifiedDiff = simplifiedExpression->Differentiate(*simplifiedVar);
     auto s = simplifiedDiff->Accept(*this);
     if (!s) {
@@ -1393,19 +1476,17 @@ auto SimplifyVisitor::TypedVisit(const Derivative<>& derivative) -> RetT
     return gsl_lite::not_null { std::move(s).value()->Accept(*this).value() };
 }
 
-auto SimplifyVisitor::TypedVisit(const Integral<>& integral) -> RetT
+auto SimplifyVisitor::Simplify(const Integral<>& integral) -> RetT
 {
-    auto mostSigOp = integral.GetMostSigOp().Copy();
-    auto leastSigOp = integral.GetLeastSigOp().Copy();
-    if (!mostSigOp) {
+    if (!integral.HasMostSigOp()) {
         return std::unexpected { "Missing most significant operand." };
     }
-    if (!leastSigOp) {
+    if (!integral.HasLeastSigOp()) {
         return std::unexpected { "Missing least significant operand." };
     }
 
-    auto simplifiedMostSigOpResult = mostSigOp->Accept(*this);
-    auto simplifiedLeastSigOpResult = leastSigOp->Accept(*this);
+    auto simplifiedMostSigOpResult = integral.GetMostSigOp().Accept(*this);
+    auto simplifiedLeastSigOpResult = integral.GetLeastSigOp().Accept(*this);
 
     if (!simplifiedMostSigOpResult) {
         return simplifiedMostSigOpResult;
@@ -1417,6 +1498,10 @@ auto SimplifyVisitor::TypedVisit(const Integral<>& integral) -> RetT
     auto simplifiedIntegrand = std::move(simplifiedMostSigOpResult).value();
     auto simplifiedDifferential = std::move(simplifiedLeastSigOpResult).value();
 
+    if (!ruleGroups.calculus) {
+        return gsl_lite::not_null { std::make_unique<Integral<Expression>>(*simplifiedIntegrand, *simplifiedDifferential) };
+    }
+
     auto integrated = simplifiedIntegrand->Integrate(*simplifiedDifferential);
     return gsl_lite::not_null { std::move(integrated) };
 }
@@ -1436,36 +1521,36 @@ auto SimplifyVisitor::TypedVisit(const Pi&) -> RetT
     return gsl_lite::not_null { Pi {}.Copy() };
 }
 
-auto SimplifyVisitor::TypedVisit(const Magnitude<Expression>& magnitude) -> RetT
+auto SimplifyVisitor::Simplify(const Magnitude<Expression>& magnitude) -> RetT
 {
     auto simplified = magnitude.GetOperand().Accept(*this);
     if (!simplified) {
         return simplified;
     }
     auto simpOp = std::move(simplified).value();
-    if (auto realCase = RecursiveCast<Real>(*simpOp); realCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Magnitude: |a|" }; auto realCase = rule.Match<Real>(*simpOp)) {
         double val = realCase->GetValue();
         return gsl_lite::not_null { val >= 0.0 ? std::make_unique<Real>(val) : std::make_unique<Real>(-val) };
     }
-    if (auto imgCase = RecursiveCast<Imaginary>(*simpOp); imgCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Magnitude: |i|" }; auto imgCase = ruleGroups.complex ? rule.Match<Imaginary>(*simpOp) : nullptr) {
         return gsl_lite::not_null { std::make_unique<Real>(1.0) };
     }
-    if (auto mulImgCase = RecursiveCast<Multiply<Expression, Imaginary>>(*simpOp); mulImgCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Magnitude: |ai|" }; auto mulImgCase = ruleGroups.complex ? rule.Match<Multiply<Expression, Imaginary>>(*simpOp) : nullptr) {
         return Magnitude<Expression> { mulImgCase->GetMostSigOp() }.Accept(*this);
     }
-    if (auto addCase = RecursiveCast<Add<Expression, Imaginary>>(*simpOp); addCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Magnitude: |a + i|" }; auto addCase = ruleGroups.complex ? rule.Match<Add<Expression, Imaginary>>(*simpOp) : nullptr) {
         return Exponent { Add<Expression> { Exponent<Expression> { addCase->GetMostSigOp(), Real { 2 } },
                               Real { 1.0 } },
             Real { 0.5 } }
             .Accept(*this);
     }
-    if (auto addCase = RecursiveCast<Add<Expression, Multiply<Expression, Imaginary>>>(*simpOp); addCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Magnitude: |a + bi|" }; auto addCase = ruleGroups.complex ? rule.Match<Add<Expression, Multiply<Expression, Imaginary>>>(*simpOp) : nullptr) {
         return Exponent { Add<Expression> { Exponent<Expression> { addCase->GetMostSigOp(), Real { 2 } },
                               Exponent<Expression> { addCase->GetLeastSigOp().GetMostSigOp(), Real { 2 } } },
             Real { 0.5 } }
             .Accept(*this);
     }
-    if (auto matrixCase = RecursiveCast<Matrix>(*simpOp); matrixCase != nullptr) {
+    if (RuleScope rule { profiler.get(), "Magnitude: |A|" }; auto matrixCase = ruleGroups.matrix ? rule.Match<Matrix>(*simpOp) : nullptr) {
         double sum = 0;
         for (size_t i = 0; i < matrixCase->GetRows(); i++) {
             for (size_t j = 0; j < matrixCase->GetCols(); j++) {
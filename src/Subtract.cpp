@@ -4,6 +4,7 @@
 
 #include "Oasis/Subtract.hpp"
 #include "Oasis/Add.hpp"
+#include "Oasis/CancellationToken.hpp"
 #include "Oasis/Divide.hpp"
 #include "Oasis/Integral.hpp"
 #include "Oasis/Log.hpp"
@@ -19,8 +20,17 @@ Subtract<Expression>::Subtract(const Expression& minuend, const Expression& subt
 {
 }
 
+Subtract<Expression>::Subtract(std::unique_ptr<Expression>&& minuend, std::unique_ptr<Expression>&& subtrahend)
+    : BinaryExpression(std::move(minuend), std::move(subtrahend))
+{
+}
+
 auto Subtract<Expression>::Integrate(const Expression& integrationVariable) const -> std::unique_ptr<Expression>
 {
+    if (CheckCancellation()) {
+        return Integral<Expression> { *this, integrationVariable }.Generalize();
+    }
+
     SimplifyVisitor simplifyVisitor {};
     // Single integration variable
     if (auto variable = RecursiveCast<Variable>(integrationVariable); variable != nullptr) {
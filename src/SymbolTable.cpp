@@ -0,0 +1,55 @@
+#include <cassert>
+#include <mutex>
+
+#include "Oasis/SymbolTable.hpp"
+
+namespace Oasis {
+
+SymbolTable::SymbolTable()
+{
+    Intern("");
+}
+
+auto SymbolTable::Global() -> SymbolTable&
+{
+    static SymbolTable table;
+    return table;
+}
+
+auto SymbolTable::Intern(std::string_view name) -> SymbolId
+{
+    {
+        std::shared_lock lock { mutex };
+        if (const auto it = ids.find(name); it != ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock lock { mutex };
+
+    // Another thread may have interned the name between the two locks.
+    if (const auto it = ids.find(name); it != ids.end()) {
+        return it->second;
+    }
+
+    const auto id = static_cast<SymbolId>(names.size());
+    const std::string& stored = names.emplace_back(name);
+    ids.emplace(stored, id);
+
+    return id;
+}
+
+auto SymbolTable::GetName(SymbolId id) const -> const std::string&
+{
+    std::shared_lock lock { mutex };
+    assert(id < names.size());
+    return names[id];
+}
+
+auto SymbolTable::Size() const -> std::size_t
+{
+    std::shared_lock lock { mutex };
+    return names.size();
+}
+
+} // Oasis
@@ -0,0 +1,123 @@
+#include "Oasis/ThreadPool.hpp"
+
+namespace {
+// The pool the current thread is a worker of, and the queue it owns.
+thread_local const Oasis::ThreadPool* currentPool = nullptr;
+thread_local std::size_t currentQueue = 0;
+}
+
+namespace Oasis {
+
+ThreadPool::ThreadPool(std::size_t threadCount)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    queues.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+
+    workers.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back([this, i] { WorkerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock { sleepMutex };
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+auto ThreadPool::GetThreadCount() const -> std::size_t
+{
+    return workers.size();
+}
+
+auto ThreadPool::GetDefault() -> std::shared_ptr<ThreadPool>
+{
+    static const auto pool = std::make_shared<ThreadPool>();
+    return pool;
+}
+
+auto ThreadPool::Push(Task task) -> void
+{
+    const std::size_t index = currentPool == this ? currentQueue : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+    // Counted before the task is queued, so that a worker never misses it on its way to sleep.
+    {
+        std::lock_guard lock { sleepMutex };
+        pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        Queue& queue = *queues[index];
+        std::lock_guard lock { queue.mutex };
+        queue.tasks.push_back(std::move(task));
+    }
+
+    wake.notify_one();
+}
+
+auto ThreadPool::RunPendingTask() -> bool
+{
+    const bool isWorker = currentPool == this;
+    const std::size_t first = isWorker ? currentQueue : nextQueue.load(std::memory_order_relaxed);
+
+    for (std::size_t offset = 0; offset < queues.size(); ++offset) {
+        Queue& queue = *queues[(first + offset) % queues.size()];
+        Task task;
+
+        {
+            std::lock_guard lock { queue.mutex };
+            if (queue.tasks.empty()) {
+                continue;
+            }
+
+            // Workers take their own newest task, and steal the oldest task of anyone else.
+            if (isWorker && offset == 0) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+        }
+
+        pending.fetch_sub(1, std::memory_order_relaxed);
+        task();
+        return true;
+    }
+
+    return false;
+}
+
+auto ThreadPool::WorkerLoop(std::size_t index) -> void
+{
+    currentPool = this;
+    currentQueue = index;
+
+    while (true) {
+        if (RunPendingTask()) {
+            continue;
+        }
+
+        std::unique_lock lock { sleepMutex };
+        wake.wait(lock, [this] { return stopping || pending.load(std::memory_order_relaxed) > 0; });
+
+        if (stopping && pending.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+    }
+}
+
+} // Oasis
@@ -14,18 +14,28 @@
 namespace Oasis {
 
 Variable::Variable(std::string name)
-    : name(std::move(name))
+    : symbol(SymbolTable::Global().Intern(name))
 {
 }
 
 auto Variable::Equals(const Expression& other) const -> bool
 {
-    return other.Is<Variable>() && name == dynamic_cast<const Variable&>(other).name;
+    return other.Is<Variable>() && symbol == static_cast<const Variable&>(other).symbol;
 }
 
-auto Variable::GetName() const -> std::string
+auto Variable::ComputeHash() const -> std::uint64_t
 {
-    return name;
+    return CombineHash(Expression::ComputeHash(), symbol);
+}
+
+auto Variable::GetName() const -> const std::string&
+{
+    return SymbolTable::Global().GetName(symbol);
+}
+
+auto Variable::GetSymbol() const -> SymbolId
+{
+    return symbol;
 }
 
 auto Variable::Integrate(const Expression& integrationVariable) const -> std::unique_ptr<Expression>
@@ -35,10 +45,10 @@ auto Variable::Integrate(const Expression& integrationVariable) const -> std::un
     if (auto variable = RecursiveCast<Variable>(integrationVariable); variable != nullptr) {
 
         // Power rule
-        if (name == (*variable).GetName()) {
+        if (symbol == variable->GetSymbol()) {
             Add adder {
                 Divide {
-                    Exponent { Variable { (*variable).GetName() }, Real { 2.0f } },
+                    Exponent { *variable, Real { 2.0f } },
                     Real { 2.0f } },
                 Variable { "C" }
             };
@@ -47,7 +57,7 @@ auto Variable::Integrate(const Expression& integrationVariable) const -> std::un
 
         // Different variable, treat as constant
         Add adder {
-            Multiply { Variable { name }, Variable { (*variable).GetName() } },
+            Multiply { *this, *variable },
             Variable { "C" }
         };
         return adder.Accept(simplifyVisitor).value();
@@ -64,7 +74,7 @@ auto Variable::Substitute(const Expression& var, const Expression& val) -> std::
     if (varclone == nullptr) {
         throw std::invalid_argument("Variable was not a variable.");
     }
-    if (varclone->GetName() == GetName()) {
+    if (varclone->GetSymbol() == symbol) {
         return val.Copy();
     }
     return Copy();
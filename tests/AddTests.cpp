@@ -291,4 +291,55 @@ TEST_CASE("Complex Addition Associativity With Variables", "[Add][Associativity]
     const auto simplified = add.Accept(simplifyVisitor).value();
 
     REQUIRE(expected.Equals(*simplified));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Long Sum Of Constants", "[Add]")
+{
+    constexpr int terms = 2000;
+
+    std::vector<std::unique_ptr<Oasis::Expression>> ops;
+    for (int i = 1; i <= terms; ++i) {
+        ops.push_back(std::make_unique<Oasis::Real>(i));
+        if (i == terms / 2) {
+            ops.push_back(std::make_unique<Oasis::Variable>("x"));
+        }
+    }
+
+    const auto sum = Oasis::BuildFromVector<Oasis::Add>(std::move(ops));
+    auto simplified = sum->Accept(simplifyVisitor).value();
+
+    const Oasis::Add expected { Oasis::Real { terms * (terms + 1) / 2.0 }, Oasis::Variable { "x" } };
+    REQUIRE(simplified->Equals(expected));
+}
+
+TEST_CASE("Like Terms Of Any Shape Are Collected", "[Add][Simplification]")
+{
+    const Oasis::Log logX { Oasis::Real { 10.0 }, Oasis::Variable { "x" } };
+    const Oasis::Add<> add { Oasis::Multiply { Oasis::Real { 2.0 }, logX }, Oasis::Variable { "y" }, Oasis::Multiply { logX, Oasis::Real { 3.0 } } };
+
+    const auto simplified = add.Accept(simplifyVisitor).value();
+
+    const Oasis::Add expected { Oasis::Multiply { Oasis::Real { 5.0 }, logX }, Oasis::Variable { "y" } };
+    REQUIRE(simplified->Equals(expected));
+}
+
+TEST_CASE("Long Sum Of Like Terms", "[Add]")
+{
+    constexpr int terms = 50000;
+    constexpr int variables = 10;
+
+    std::vector<std::unique_ptr<Oasis::Expression>> ops;
+    for (int i = 0; i < terms; ++i) {
+        ops.push_back(std::make_unique<Oasis::Multiply<>>(Oasis::Real { 0.5 }, Oasis::Variable { "x_" + std::to_string(i % variables) }));
+    }
+
+    const auto sum = Oasis::BuildFromVector<Oasis::Add>(std::move(ops));
+    const auto simplified = sum->Accept(simplifyVisitor).value();
+
+    std::vector<std::unique_ptr<Oasis::Expression>> expectedOps;
+    for (int i = 0; i < variables; ++i) {
+        expectedOps.push_back(std::make_unique<Oasis::Multiply<>>(Oasis::Real { terms / variables * 0.5 }, Oasis::Variable { "x_" + std::to_string(i) }));
+    }
+
+    REQUIRE(simplified->Equals(*Oasis::BuildFromVector<Oasis::Add>(std::move(expectedOps))));
+}
@@ -1,18 +1,92 @@
 //
 // Created by Matthew McCall on 10/6/23.
 //
+#include "catch2/benchmark/catch_benchmark.hpp"
 #include "catch2/catch_test_macros.hpp"
 
+#include <unordered_map>
+
 #include "Oasis/Add.hpp"
+#include "Oasis/Derivative.hpp"
+#include "Oasis/Divide.hpp"
+#include "Oasis/EulerNumber.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/Imaginary.hpp"
+#include "Oasis/Integral.hpp"
+#include "Oasis/Log.hpp"
+#include "Oasis/Magnitude.hpp"
+#include "Oasis/Matrix.hpp"
 #include "Oasis/Multiply.hpp"
 #include "Oasis/Negate.hpp"
+#include "Oasis/Pi.hpp"
 #include "Oasis/Real.hpp"
 #include "Oasis/RecursiveCast.hpp"
 #include "Oasis/SimplifyVisitor.hpp"
+#include "Oasis/Sine.hpp"
+#include "Oasis/Subtract.hpp"
+#include "Oasis/Undefined.hpp"
 #include "Oasis/Variable.hpp"
 
 inline Oasis::SimplifyVisitor simplifyVisitor {};
 
+// Walks the whole tree and returns the address of the node it was handed, so tests can check that
+// dispatch does not copy the visited expression.
+class AddressVisitor final : public Oasis::TypedVisitor<const Oasis::Expression*> {
+public:
+    std::size_t visited = 0;
+
+    auto TypedVisit(const Oasis::Real& real) -> RetT override { return Leaf(real); }
+    auto TypedVisit(const Oasis::Imaginary& imaginary) -> RetT override { return Leaf(imaginary); }
+    auto TypedVisit(const Oasis::Matrix& matrix) -> RetT override { return Leaf(matrix); }
+    auto TypedVisit(const Oasis::Variable& variable) -> RetT override { return Leaf(variable); }
+    auto TypedVisit(const Oasis::Undefined& undefined) -> RetT override { return Leaf(undefined); }
+    auto TypedVisit(const Oasis::EulerNumber& e) -> RetT override { return Leaf(e); }
+    auto TypedVisit(const Oasis::Pi& pi) -> RetT override { return Leaf(pi); }
+    auto TypedVisit(const Oasis::Add<>& add) -> RetT override { return Binary(add); }
+    auto TypedVisit(const Oasis::Subtract<>& subtract) -> RetT override { return Binary(subtract); }
+    auto TypedVisit(const Oasis::Multiply<>& multiply) -> RetT override { return Binary(multiply); }
+    auto TypedVisit(const Oasis::Divide<>& divide) -> RetT override { return Binary(divide); }
+    auto TypedVisit(const Oasis::Exponent<>& exponent) -> RetT override { return Binary(exponent); }
+    auto TypedVisit(const Oasis::Log<>& log) -> RetT override { return Binary(log); }
+    auto TypedVisit(const Oasis::Negate<>& negate) -> RetT override { return Unary(negate); }
+    auto TypedVisit(const Oasis::Sine<Oasis::Expression>& sine) -> RetT override { return Unary(sine); }
+    auto TypedVisit(const Oasis::Magnitude<Oasis::Expression>& magnitude) -> RetT override { return Unary(magnitude); }
+    auto TypedVisit(const Oasis::Derivative<>& derivative) -> RetT override { return Binary(derivative); }
+    auto TypedVisit(const Oasis::Integral<>& integral) -> RetT override { return Binary(integral); }
+
+private:
+    auto Leaf(const Oasis::Expression& leaf) -> RetT
+    {
+        ++visited;
+        return &leaf;
+    }
+
+    auto Binary(const Oasis::DerivedFromBinaryExpression auto& binary) -> RetT
+    {
+        ++visited;
+        (void)binary.GetMostSigOp().Accept(*this);
+        (void)binary.GetLeastSigOp().Accept(*this);
+        return &binary;
+    }
+
+    auto Unary(const Oasis::DerivedFromUnaryExpression auto& unary) -> RetT
+    {
+        ++visited;
+        (void)unary.GetOperand().Accept(*this);
+        return &unary;
+    }
+};
+
+// Builds ((x + 1) + 2) + ... + n, the worst case for any per-level copying.
+auto BuildDeepSum(std::size_t terms) -> std::unique_ptr<Oasis::Expression>
+{
+    std::unique_ptr<Oasis::Expression> sum = std::make_unique<Oasis::Variable>("x");
+    for (std::size_t i = 1; i <= terms; ++i) {
+        sum = std::make_unique<Oasis::Add<>>(*sum, Oasis::Real { static_cast<double>(i) });
+    }
+    return sum;
+}
+
 TEST_CASE("Recursive Cast Considers Commutative Property", "[Symbolic]")
 {
     Oasis::Add add {
@@ -95,6 +169,49 @@ TEST_CASE("Flatten Function", "[TreeManip]")
     }
 }
 
+TEST_CASE("Flatten Without Copying", "[TreeManip]")
+{
+    const Oasis::Add<> add {
+        Oasis::Add<> {
+            Oasis::Real { 1.0 },
+            Oasis::Multiply { Oasis::Real { 2.0 }, Oasis::Variable { "x" } } },
+        Oasis::Add<Oasis::Real> { Oasis::Real { 3.0 }, Oasis::Real { 4.0 } }
+    };
+
+    std::vector<const Oasis::Expression*> flattened;
+    add.Flatten(flattened);
+
+    REQUIRE(flattened.size() == 4);
+    REQUIRE(flattened[0]->Equals(Oasis::Real { 1.0 }));
+    REQUIRE(flattened[1]->Is<Oasis::Multiply>());
+    REQUIRE(flattened[2]->Equals(Oasis::Real { 3.0 }));
+    REQUIRE(flattened[3]->Equals(Oasis::Real { 4.0 }));
+
+    const auto& augend = static_cast<const Oasis::Add<>&>(add.GetMostSigOp());
+    REQUIRE(flattened[0] == &augend.GetMostSigOp());
+}
+
+TEST_CASE("Constructing From Owned Operands Adopts Them", "[TreeManip]")
+{
+    auto augend = std::make_unique<Oasis::Real>(1.0);
+    auto addend = std::make_unique<Oasis::Variable>("x");
+    const Oasis::Expression* augendAddress = augend.get();
+    const Oasis::Expression* addendAddress = addend.get();
+
+    Oasis::Add<> add { std::move(augend), std::move(addend) };
+
+    REQUIRE(&add.GetMostSigOp() == augendAddress);
+    REQUIRE(&add.GetLeastSigOp() == addendAddress);
+    REQUIRE(add.Equals(Oasis::Add { Oasis::Real { 1.0 }, Oasis::Variable { "x" } }));
+
+    auto replacement = std::make_unique<Oasis::Real>(2.0);
+    const Oasis::Expression* replacementAddress = replacement.get();
+    add.SetLeastSigOp(std::move(replacement));
+
+    REQUIRE(&add.GetLeastSigOp() == replacementAddress);
+    REQUIRE(add.Equals(Oasis::Add { Oasis::Real { 1.0 }, Oasis::Real { 2.0 } }));
+}
+
 TEST_CASE("BuildFromVector Function", "[TreeManip]")
 {
     Oasis::Real real1 { 1.0 };
@@ -236,4 +353,74 @@ TEST_CASE("Substitute Binary", "[Substitute]")
     auto after = before.Substitute(Oasis::Variable { "x" }, Oasis::Real { 4.0 }); // after should some std::unique_ptr<Expression> such that it equals 2(4) + 3(4)
     Oasis::Real twenty { 20 };
     REQUIRE(after->Equals(*(twenty.Accept(simplifyVisitor).value())));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Visitors Receive The Original Node", "[Visitor]")
+{
+    AddressVisitor visitor;
+
+    const Oasis::Add<> add { Oasis::Variable { "x" }, Oasis::Real { 1.0 } };
+    REQUIRE(add.Accept(visitor).value() == &add);
+
+    const Oasis::Negate<> negate { Oasis::Variable { "x" } };
+    REQUIRE(negate.Accept(visitor).value() == &negate);
+
+    const Oasis::Real real { 2.0 };
+    REQUIRE(real.Accept(visitor).value() == &real);
+}
+
+TEST_CASE("Visiting A Deep Sum Touches Each Node Once", "[Visitor]")
+{
+    constexpr std::size_t terms = 2000;
+    const auto sum = BuildDeepSum(terms);
+
+    AddressVisitor visitor;
+    REQUIRE(sum->Accept(visitor).value() == sum.get());
+    REQUIRE(visitor.visited == 2 * terms + 1);
+}
+
+TEST_CASE("Deep Sum Traversal Benchmark", "[Visitor][!benchmark]")
+{
+    // Traversal time should grow linearly with the number of terms.
+    for (const std::size_t terms : { 1000, 2000, 4000, 8000 }) {
+        const auto sum = BuildDeepSum(terms);
+        AddressVisitor visitor;
+
+        BENCHMARK("Visit " + std::to_string(terms) + " terms")
+        {
+            return sum->Accept(visitor);
+        };
+    }
+}
+
+TEST_CASE("Hash Ignores Order And Grouping Of Associative Operands", "[Hash]")
+{
+    const Oasis::Add lhs { Oasis::Variable { "x" }, Oasis::Add { Oasis::Real { 1.0 }, Oasis::Variable { "y" } } };
+    const Oasis::Add rhs { Oasis::Add { Oasis::Variable { "y" }, Oasis::Variable { "x" } }, Oasis::Real { 1.0 } };
+
+    REQUIRE(lhs.GetHash() == rhs.GetHash());
+    REQUIRE(lhs.Equals(rhs));
+
+    const Oasis::Subtract difference { Oasis::Variable { "x" }, Oasis::Variable { "y" } };
+    const Oasis::Subtract swapped { Oasis::Variable { "y" }, Oasis::Variable { "x" } };
+
+    REQUIRE(difference.GetHash() != swapped.GetHash());
+    REQUIRE_FALSE(difference.Equals(swapped));
+
+    const Oasis::Multiply product { Oasis::Variable { "x" }, Oasis::Real { 2.0 } };
+    REQUIRE(product.GetHash() != Oasis::Add { Oasis::Variable { "x" }, Oasis::Real { 2.0 } }.GetHash());
+    REQUIRE(product.GetHash() == product.Copy()->GetHash());
+}
+
+TEST_CASE("Expressions As Unordered Map Keys", "[Hash]")
+{
+    std::unordered_map<std::unique_ptr<Oasis::Expression>, int, Oasis::ExpressionHash, Oasis::ExpressionEqual> counts;
+
+    counts[Oasis::Multiply { Oasis::Variable { "x" }, Oasis::Variable { "y" } }.Copy()] = 1;
+    counts[Oasis::Real { 2.0 }.Copy()] = 2;
+
+    const Oasis::Multiply swapped { Oasis::Variable { "y" }, Oasis::Variable { "x" } };
+    REQUIRE(counts.find(swapped) != counts.end());
+    REQUIRE(counts.find(swapped)->second == 1);
+    REQUIRE(counts.find(Oasis::Real { -2.0 }) == counts.end());
+}
@@ -0,0 +1,94 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/CancellationToken.hpp"
+#include "Oasis/Derivative.hpp"
+#include "Oasis/DifferentiateVisitor.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/Integral.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/SimplifyVisitor.hpp"
+#include "Oasis/Variable.hpp"
+
+namespace {
+auto LongSum(int terms) -> std::unique_ptr<Oasis::Expression>
+{
+    std::vector<std::unique_ptr<Oasis::Expression>> ops;
+    for (int i = 0; i < terms; ++i) {
+        ops.push_back(std::make_unique<Oasis::Multiply<>>(Oasis::Real { 2.0 }, Oasis::Variable { "x_" + std::to_string(i % 10) }));
+    }
+    return Oasis::BuildFromVector<Oasis::Add>(std::move(ops));
+}
+}
+
+TEST_CASE("Unlimited Computations Finish", "[Cancellation]")
+{
+    const auto sum = LongSum(100);
+    Oasis::SimplifyVisitor simplifyVisitor {};
+
+    Oasis::CancellationToken token;
+    const auto result = Oasis::WithCancellation(token, [&] { return sum->Accept(simplifyVisitor); });
+
+    REQUIRE(result.has_value());
+    REQUIRE((*result)->Equals(*sum->Accept(simplifyVisitor).value()));
+    REQUIRE(token.GetVisits() > 0);
+    REQUIRE(Oasis::CancellationToken::Current() == nullptr);
+}
+
+TEST_CASE("Simplification Stops When A Budget Runs Out", "[Cancellation]")
+{
+    const auto sum = LongSum(100);
+    Oasis::SimplifyVisitor simplifyVisitor {};
+    const auto simplified = sum->Accept(simplifyVisitor).value();
+
+    Oasis::CancellationToken visits;
+    visits.SetVisitBudget(10);
+    auto result = Oasis::WithCancellation(visits, [&] { return sum->Accept(simplifyVisitor); });
+
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().reason == Oasis::CancellationReason::VisitBudgetExceeded);
+
+    // The partial result is equal to the input, so simplifying it further reaches the same result.
+    REQUIRE(result.error().partialResult != nullptr);
+    REQUIRE(result.error().partialResult->Accept(simplifyVisitor).value()->Equals(*simplified));
+
+    Oasis::CancellationToken memory;
+    memory.SetMemoryBudget(1024);
+    result = Oasis::WithCancellation(memory, [&] { return sum->Accept(simplifyVisitor); });
+
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().reason == Oasis::CancellationReason::MemoryBudgetExceeded);
+
+    Oasis::CancellationToken deadline;
+    deadline.SetDeadline(Oasis::CancellationToken::Clock::now());
+    result = Oasis::WithCancellation(deadline, [&] { return sum->Accept(simplifyVisitor); });
+
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().reason == Oasis::CancellationReason::DeadlineExceeded);
+    REQUIRE(result.error().partialResult->Equals(*sum));
+}
+
+TEST_CASE("Cancelled Calculus Is Left Unevaluated", "[Cancellation]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Add polynomial { Oasis::Exponent { x, Oasis::Real { 2.0 } }, x };
+
+    Oasis::CancellationToken cancelled;
+    cancelled.Cancel();
+
+    Oasis::DifferentiateVisitor differentiateVisitor { x.Copy() };
+    const auto derivative = Oasis::WithCancellation(cancelled, [&] { return polynomial.Accept(differentiateVisitor); });
+
+    REQUIRE_FALSE(derivative.has_value());
+    REQUIRE(derivative.error().reason == Oasis::CancellationReason::Cancelled);
+    REQUIRE(derivative.error().partialResult->Equals(Oasis::Derivative { polynomial, x }));
+
+    const auto integral = Oasis::WithCancellation(cancelled, [&] { return polynomial.Integrate(x); });
+
+    REQUIRE_FALSE(integral.has_value());
+    REQUIRE(integral.error().partialResult->Equals(Oasis::Integral { polynomial, x }));
+}
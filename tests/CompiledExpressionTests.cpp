@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/CompiledExpression.hpp"
+#include "Oasis/CompiledExpressionCache.hpp"
+#include "Oasis/Divide.hpp"
+#include "Oasis/EulerNumber.hpp"
+#include "Oasis/EvaluateVisitor.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/Imaginary.hpp"
+#include "Oasis/Log.hpp"
+#include "Oasis/Magnitude.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Pi.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/Sine.hpp"
+#include "Oasis/Subtract.hpp"
+#include "Oasis/Variable.hpp"
+
+namespace {
+auto CountOps(const Oasis::CompiledExpression& compiled, Oasis::CompiledExpression::OpCode op) -> std::size_t
+{
+    return std::ranges::count(compiled.GetInstructions(), op, &Oasis::CompiledExpression::Instruction::op);
+}
+}
+
+TEST_CASE("Compiled Expressions Match Evaluation", "[Compile]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Variable y { "y" };
+
+    // 3x^3 - log[2](y) * sin(pi * x) + |x - y| / e^y + x^0.5
+    const Oasis::Add expression {
+        Oasis::Subtract {
+            Oasis::Multiply { Oasis::Real { 3.0 }, Oasis::Exponent { x, Oasis::Real { 3.0 } } },
+            Oasis::Multiply { Oasis::Log { Oasis::Real { 2.0 }, y }, Oasis::Sine<Oasis::Expression> { Oasis::Multiply { Oasis::Pi {}, x } } } },
+        Oasis::Add {
+            Oasis::Divide { Oasis::Magnitude<Oasis::Expression> { Oasis::Subtract { x, y } }, Oasis::Exponent { Oasis::EulerNumber {}, y } },
+            Oasis::Exponent { x, Oasis::Real { 0.5 } } }
+    };
+
+    const auto compiled = Oasis::Compile(expression, { "x", "y" });
+    REQUIRE(compiled.has_value());
+
+    for (const auto& [xValue, yValue] : std::array { std::pair { 0.25, 1.0 }, std::pair { 2.0, 0.5 }, std::pair { 7.5, 3.0 } }) {
+        const auto expected = Oasis::Evaluate(expression, Oasis::VariableBindings {}.Bind("x", xValue).Bind("y", yValue));
+        REQUIRE(std::abs(compiled->Evaluate(std::array { xValue, yValue }) - expected.value()) < 1e-12);
+    }
+}
+
+TEST_CASE("Compiling Folds Constants And Reduces Powers", "[Compile]")
+{
+    using OpCode = Oasis::CompiledExpression::OpCode;
+    const Oasis::Variable x { "x" };
+
+    const auto folded = Oasis::Compile(Oasis::Multiply { Oasis::Add { Oasis::Real { 2.0 }, Oasis::Real { 3.0 } }, Oasis::Exponent { Oasis::Pi {}, Oasis::Real { 2.0 } } }, {});
+    REQUIRE(folded->GetInstructions().size() == 1);
+    REQUIRE(std::abs(folded->Evaluate({}) - 5.0 * std::numbers::pi * std::numbers::pi) < 1e-12);
+
+    const auto square = Oasis::Compile(Oasis::Exponent { x, Oasis::Real { 2.0 } }, { "x" });
+    REQUIRE(CountOps(*square, OpCode::Multiply) == 1);
+    REQUIRE(CountOps(*square, OpCode::Power) == 0);
+
+    const auto cube = Oasis::Compile(Oasis::Exponent { x, Oasis::Real { -3.0 } }, { "x" });
+    REQUIRE(CountOps(*cube, OpCode::IntegerPower) == 1);
+    REQUIRE(cube->Evaluate(std::array { 2.0 }) == 0.125);
+
+    // The repeated subexpression x + 1 is computed once
+    const Oasis::Add xPlusOne { x, Oasis::Real { 1.0 } };
+    const auto shared = Oasis::Compile(Oasis::Multiply { xPlusOne, Oasis::Sine<Oasis::Expression> { xPlusOne } }, { "x" });
+    REQUIRE(CountOps(*shared, OpCode::Add) == 1);
+    REQUIRE(shared->GetRegisterCount() <= 3);
+}
+
+TEST_CASE("Compiling Unsupported Expressions Fails", "[Compile]")
+{
+    const Oasis::Variable x { "x" };
+
+    const auto missing = Oasis::Compile(Oasis::Add { x, Oasis::Variable { "y" } }, { "x" });
+    REQUIRE_FALSE(missing.has_value());
+    REQUIRE(missing.error() == "Variable y is not in the variable order.");
+
+    REQUIRE_FALSE(Oasis::Compile(Oasis::Multiply { x, Oasis::Imaginary {} }, { "x" }).has_value());
+}
+
+TEST_CASE("Compiled Expressions Are Cached", "[Compile]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Variable y { "y" };
+    const std::array xy { x.GetSymbol(), y.GetSymbol() };
+    const std::array yx { y.GetSymbol(), x.GetSymbol() };
+
+    Oasis::CompiledExpressionCache cache { 16 };
+
+    const auto first = cache.Get(Oasis::Subtract { x, y }, xy).value();
+    const auto second = cache.Get(Oasis::Subtract { x, y }, xy).value();
+    REQUIRE(first == second);
+    REQUIRE(cache.GetHits() == 1);
+
+    // The same expression in another variable order is another program
+    const auto swapped = cache.Get(Oasis::Subtract { x, y }, yx).value();
+    REQUIRE(swapped != first);
+    REQUIRE(swapped->Evaluate(std::array { 1.0, 3.0 }) == 2.0);
+    REQUIRE(cache.Size() == 2);
+}
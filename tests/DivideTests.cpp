@@ -210,4 +210,69 @@ TEST_CASE("Divide Operator Overload", "[Divide][Operator Overload]")
 
     REQUIRE(realSum != nullptr);
     REQUIRE(realSum->GetValue() == 2.0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Cancelling Factors Of Any Shape", "[Division][Symbolic]")
+{
+    const Oasis::Add sum { Oasis::Variable { "a" }, Oasis::Variable { "b" } };
+
+    // 6x^3(a + b)^2 y^n / (2x(a + b)^2 y)
+    const Oasis::Divide quotient {
+        Oasis::Multiply<> {
+            Oasis::Real { 6 },
+            Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 3 } },
+            Oasis::Exponent { sum, Oasis::Real { 2 } },
+            Oasis::Exponent { Oasis::Variable { "y" }, Oasis::Variable { "n" } } },
+        Oasis::Multiply<> {
+            Oasis::Real { 2 },
+            Oasis::Variable { "x" },
+            Oasis::Exponent { sum, Oasis::Real { 2 } },
+            Oasis::Variable { "y" } }
+    };
+
+    const auto simplified = quotient.Accept(simplifyVisitor).value();
+
+    // 3x^2 y^(n - 1)
+    const Oasis::Multiply<> expected {
+        Oasis::Real { 3 },
+        Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 2 } },
+        Oasis::Exponent { Oasis::Variable { "y" }, Oasis::Add { Oasis::Variable { "n" }, Oasis::Real { -1 } } }
+    };
+
+    REQUIRE(simplified->Equals(expected));
+}
+
+TEST_CASE("Quotients By Zero Are Not Folded", "[Division][Symbolic]")
+{
+    const Oasis::Variable x { "x" };
+
+    // x / 0
+    const Oasis::Divide byZero { x, Oasis::Real { 0 } };
+    REQUIRE(byZero.Accept(simplifyVisitor).value()->Equals(byZero));
+
+    // (x / 0) / y
+    const Oasis::Divide nested { byZero, Oasis::Variable { "y" } };
+    REQUIRE(nested.Accept(simplifyVisitor).value()->Equals(nested));
+}
+
+TEST_CASE("Long Quotient Of Like Factors", "[Division][Symbolic]")
+{
+    constexpr int factors = 1000;
+
+    std::vector<std::unique_ptr<Oasis::Expression>> numerator;
+    std::vector<std::unique_ptr<Oasis::Expression>> denominator;
+    for (int i = 0; i < factors; ++i) {
+        numerator.push_back(std::make_unique<Oasis::Exponent<>>(Oasis::Variable { "x_" + std::to_string(i) }, Oasis::Real { 2 }));
+        denominator.push_back(std::make_unique<Oasis::Variable>("x_" + std::to_string(factors - 1 - i)));
+    }
+
+    const Oasis::Divide quotient { *Oasis::BuildFromVector<Oasis::Multiply>(std::move(numerator)), *Oasis::BuildFromVector<Oasis::Multiply>(std::move(denominator)) };
+    const auto simplified = quotient.Accept(simplifyVisitor).value();
+
+    std::vector<std::unique_ptr<Oasis::Expression>> expected;
+    for (int i = 0; i < factors; ++i) {
+        expected.push_back(std::make_unique<Oasis::Variable>("x_" + std::to_string(i)));
+    }
+
+    REQUIRE(simplified->Equals(*Oasis::BuildFromVector<Oasis::Multiply>(std::move(expected))));
+}
@@ -0,0 +1,59 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/Divide.hpp"
+#include "Oasis/EGraph.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/Log.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/Variable.hpp"
+
+TEST_CASE("EGraph Merges Terms That Are Not Adjacent", "[EGraph][Simplify]")
+{
+    const Oasis::Variable x { "x" }, y { "y" }, z { "z" };
+
+    // log(x) + (y + log(z)) = y + log(xz)
+    const Oasis::Add logs { Oasis::Log { Oasis::Real { 10.0 }, x }, Oasis::Add { y, Oasis::Log { Oasis::Real { 10.0 }, z } } };
+    const auto mergedLogs = Oasis::SimplifyWithEGraph(logs);
+    REQUIRE(mergedLogs.saturated);
+    REQUIRE(mergedLogs.expression->Equals(Oasis::Add { y, Oasis::Log { Oasis::Real { 10.0 }, Oasis::Multiply { x, z } } }));
+
+    // 2x + (y + 3x) = y + 5x
+    const Oasis::Add terms { Oasis::Multiply { Oasis::Real { 2.0 }, x }, Oasis::Add { y, Oasis::Multiply { Oasis::Real { 3.0 }, x } } };
+    const auto combinedTerms = Oasis::SimplifyWithEGraph(terms);
+    REQUIRE(combinedTerms.saturated);
+    REQUIRE(combinedTerms.expression->Equals(Oasis::Add { y, Oasis::Multiply { Oasis::Real { 5.0 }, x } }));
+}
+
+TEST_CASE("EGraph Extraction Uses The Cost Function", "[EGraph][Simplify]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Multiply cube { x, Oasis::Multiply { x, x } };
+
+    const auto nodeCount = Oasis::SimplifyWithEGraph(cube);
+    REQUIRE(nodeCount.expression->Equals(Oasis::Exponent { x, Oasis::Real { 3.0 } }));
+
+    // Pricing exponentiation out keeps the product, with x * x still cheaper than x^2.
+    const auto noExponents = Oasis::SimplifyWithEGraph(cube, { .costFunction = [](const Oasis::ENode& node, std::span<const double> childCosts) {
+        return Oasis::NodeCountCost(node, childCosts) + (node.type == Oasis::ExpressionType::Exponent ? 100.0 : 0.0);
+    } });
+    REQUIRE(noExponents.expression->Equals(cube));
+}
+
+TEST_CASE("EGraph Limits", "[EGraph][Simplify]")
+{
+    const Oasis::Variable x { "x" }, y { "y" };
+    const Oasis::Divide quotient { Oasis::Multiply { x, y }, x };
+
+    const auto unlimited = Oasis::SimplifyWithEGraph(quotient);
+    REQUIRE(unlimited.expression->Equals(y));
+
+    const auto noIterations = Oasis::SimplifyWithEGraph(quotient, { .maxIterations = 0 });
+    REQUIRE_FALSE(noIterations.saturated);
+    REQUIRE(noIterations.expression->Equals(quotient));
+
+    const auto fewNodes = Oasis::SimplifyWithEGraph(quotient, { .maxNodes = 32 });
+    REQUIRE_FALSE(fewNodes.saturated);
+    REQUIRE(fewNodes.nodes < 64);
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/CompiledExpression.hpp"
+#include "Oasis/Divide.hpp"
+#include "Oasis/EulerNumber.hpp"
+#include "Oasis/EvaluateBatch.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/Log.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/Sine.hpp"
+#include "Oasis/Subtract.hpp"
+#include "Oasis/ThreadPool.hpp"
+#include "Oasis/Variable.hpp"
+
+TEST_CASE("Batch Evaluation Matches Evaluation", "[EvaluateBatch]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Variable y { "y" };
+
+    // x^5 / y - e^(sin(x)) + log[10](y) * x^y
+    const Oasis::Add expression {
+        Oasis::Subtract { Oasis::Divide { Oasis::Exponent { x, Oasis::Real { 5.0 } }, y }, Oasis::Exponent { Oasis::EulerNumber {}, Oasis::Sine<Oasis::Expression> { x } } },
+        Oasis::Multiply { Oasis::Log { Oasis::Real { 10.0 }, y }, Oasis::Exponent { x, y } }
+    };
+    const auto compiled = Oasis::Compile(expression, { "x", "y" }).value();
+
+    // Not a multiple of the block size, so the last block is partial
+    constexpr std::size_t count = 3 * Oasis::BatchBlockSize + 17;
+    std::vector<double> xValues(count);
+    std::vector<double> yValues(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        xValues[i] = 0.01 * static_cast<double>(i);
+        yValues[i] = 1.0 + 0.001 * static_cast<double>(i);
+    }
+    const std::array<std::span<const double>, 2> values { xValues, yValues };
+
+    std::vector<double> results(count);
+    REQUIRE(Oasis::EvaluateBatch(compiled, values, results).has_value());
+
+    std::vector<double> parallelResults(count);
+    REQUIRE(Oasis::EvaluateBatch(compiled, values, parallelResults, std::make_shared<Oasis::ThreadPool>(2)).has_value());
+
+    REQUIRE(parallelResults == results);
+
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const double expected = compiled.Evaluate(std::array { xValues[i], yValues[i] });
+        mismatches += std::abs(results[i] - expected) > 1e-12 * std::max(1.0, std::abs(expected));
+    }
+    REQUIRE(mismatches == 0);
+}
+
+TEST_CASE("Batch Evaluation Checks Its Inputs", "[EvaluateBatch]")
+{
+    const Oasis::Variable x { "x" };
+    const auto compiled = Oasis::Compile(Oasis::Multiply { x, x }, { "x" }).value();
+
+    const std::vector<double> xValues(4, 1.0);
+    std::vector<double> results(8);
+
+    REQUIRE_FALSE(Oasis::EvaluateBatch(compiled, {}, results).has_value());
+
+    const std::array<std::span<const double>, 1> values { xValues };
+    REQUIRE_FALSE(Oasis::EvaluateBatch(compiled, values, results).has_value());
+    REQUIRE(Oasis::EvaluateBatch(compiled, values, std::span { results }.first(4)).has_value());
+    REQUIRE(results[3] == 1.0);
+}
+
+TEST_CASE("Grid Evaluation Matches Evaluation", "[EvaluateBatch][EvaluateGrid]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Variable y { "y" };
+    const Oasis::Variable z { "z" };
+
+    // sin(x) * log[2](y + 2) + x^2 * z - e^y
+    const Oasis::Subtract expression {
+        Oasis::Add {
+            Oasis::Multiply { Oasis::Sine<Oasis::Expression> { x }, Oasis::Log { Oasis::Real { 2.0 }, Oasis::Add { y, Oasis::Real { 2.0 } } } },
+            Oasis::Multiply { Oasis::Exponent { x, Oasis::Real { 2.0 } }, z } },
+        Oasis::Exponent { Oasis::EulerNumber {}, y }
+    };
+    const auto compiled = Oasis::Compile(expression, { "x", "y", "z" }).value();
+
+    // Only the terms in z are left to the last stage
+    REQUIRE(std::ranges::none_of(compiled.GetStage(2), [](const auto& instruction) { return instruction.op == Oasis::CompiledExpression::OpCode::Sine; }));
+
+    const std::array<Oasis::GridAxis, 3> axes { { { -1.0, 1.0, 5 }, { 0.0, 2.0, 4 }, { -3.0, 3.0, Oasis::BatchBlockSize + 44 } } };
+    std::vector<double> results(5 * 4 * axes[2].count);
+    REQUIRE(Oasis::EvaluateGrid(compiled, axes, results).has_value());
+
+    std::vector<double> parallelResults(results.size());
+    REQUIRE(Oasis::EvaluateGrid(compiled, axes, parallelResults, std::make_shared<Oasis::ThreadPool>(2)).has_value());
+    REQUIRE(parallelResults == results);
+
+    const auto coordinate = [](const Oasis::GridAxis& axis, std::size_t i) {
+        return axis.first + (axis.last - axis.first) / static_cast<double>(axis.count - 1) * static_cast<double>(i);
+    };
+
+    std::size_t point = 0;
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i < axes[0].count; ++i) {
+        for (std::size_t j = 0; j < axes[1].count; ++j) {
+            for (std::size_t k = 0; k < axes[2].count; ++k, ++point) {
+                const double expected = compiled.Evaluate(std::array { coordinate(axes[0], i), coordinate(axes[1], j), coordinate(axes[2], k) });
+                mismatches += std::abs(results[point] - expected) > 1e-12 * std::max(1.0, std::abs(expected));
+            }
+        }
+    }
+    REQUIRE(mismatches == 0);
+}
+
+TEST_CASE("Grid Evaluation Checks Its Inputs", "[EvaluateBatch][EvaluateGrid]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Variable y { "y" };
+    const auto compiled = Oasis::Compile(Oasis::Multiply { x, x }, { "x", "y" }).value();
+
+    const std::array<Oasis::GridAxis, 2> axes { { { 0.0, 1.0, 3 }, { 0.0, 1.0, 2 } } };
+    std::vector<double> results(5);
+
+    REQUIRE_FALSE(Oasis::EvaluateGrid(compiled, std::span { axes }.first(1), results).has_value());
+    REQUIRE_FALSE(Oasis::EvaluateGrid(compiled, axes, results).has_value());
+
+    // An expression that does not depend on the last variable is constant along each row
+    results.resize(6);
+    REQUIRE(Oasis::EvaluateGrid(compiled, axes, results).has_value());
+    REQUIRE(results == std::vector { 0.0, 0.0, 0.25, 0.25, 1.0, 1.0 });
+}
@@ -0,0 +1,84 @@
+#include <cmath>
+#include <complex>
+#include <numbers>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/Derivative.hpp"
+#include "Oasis/Divide.hpp"
+#include "Oasis/EulerNumber.hpp"
+#include "Oasis/EvaluateVisitor.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/Imaginary.hpp"
+#include "Oasis/Log.hpp"
+#include "Oasis/Magnitude.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Negate.hpp"
+#include "Oasis/Pi.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/Sine.hpp"
+#include "Oasis/Undefined.hpp"
+#include "Oasis/Variable.hpp"
+
+namespace {
+auto Near(std::complex<double> value, std::complex<double> expected) -> bool
+{
+    return std::abs(value - expected) < 1e-12;
+}
+}
+
+TEST_CASE("Evaluating A Polynomial", "[Evaluate]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Add polynomial { Oasis::Multiply { Oasis::Real { 3.0 }, Oasis::Exponent { x, Oasis::Real { 2.0 } } }, Oasis::Add { Oasis::Multiply { Oasis::Real { 2.0 }, x }, Oasis::Real { 1.0 } } };
+
+    REQUIRE(Oasis::Evaluate(polynomial, Oasis::VariableBindings {}.Bind("x", 2.0)) == 17.0);
+
+    Oasis::EvaluateVisitor visitor { Oasis::VariableBindings {}.Bind("x", -1.0) };
+    REQUIRE(polynomial.Accept(visitor) == std::complex<double> { 2.0 });
+
+    visitor.GetBindings().Bind(x.GetSymbol(), 0.5);
+    REQUIRE(polynomial.Accept(visitor) == std::complex<double> { 2.75 });
+}
+
+TEST_CASE("Evaluating Constants And Functions", "[Evaluate]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::VariableBindings bindings = Oasis::VariableBindings {}.Bind("x", -3.0);
+
+    REQUIRE(Near(Oasis::Evaluate(Oasis::Log { Oasis::Real { 10.0 }, Oasis::Real { 1000.0 } }).value(), 3.0));
+    REQUIRE(Near(Oasis::Evaluate(Oasis::Sine<Oasis::Expression> { Oasis::Divide { Oasis::Pi {}, Oasis::Real { 2.0 } } }).value(), 1.0));
+    REQUIRE(Near(Oasis::Evaluate(Oasis::Log { Oasis::EulerNumber {}, Oasis::EulerNumber {} }).value(), 1.0));
+    REQUIRE(Oasis::Evaluate(Oasis::Exponent { x, Oasis::Real { 3.0 } }, bindings) == -27.0);
+    REQUIRE(Oasis::Evaluate(Oasis::Magnitude { Oasis::Negate { x } }, bindings) == 3.0);
+    REQUIRE(std::isnan(Oasis::Evaluate(Oasis::Undefined {}).value()));
+}
+
+TEST_CASE("Evaluating To Complex Numbers", "[Evaluate]")
+{
+    Oasis::EvaluateVisitor visitor {};
+
+    REQUIRE(Oasis::Multiply { Oasis::Imaginary {}, Oasis::Imaginary {} }.Accept(visitor) == std::complex<double> { -1.0 });
+    REQUIRE(Oasis::Exponent { Oasis::Imaginary {}, Oasis::Real { 3.0 } }.Accept(visitor) == std::complex<double> { 0.0, -1.0 });
+    REQUIRE(Oasis::Magnitude { Oasis::Add { Oasis::Real { 3.0 }, Oasis::Multiply { Oasis::Real { 4.0 }, Oasis::Imaginary {} } } }.Accept(visitor) == std::complex<double> { 5.0 });
+
+    const auto root = Oasis::Exponent { Oasis::Real { -4.0 }, Oasis::Real { 0.5 } }.Accept(visitor).value();
+    REQUIRE(Near(root, { 0.0, 2.0 }));
+
+    const auto log = Oasis::Log { Oasis::EulerNumber {}, Oasis::Real { -1.0 } }.Accept(visitor).value();
+    REQUIRE(Near(log, { 0.0, std::numbers::pi }));
+
+    REQUIRE_FALSE(Oasis::Evaluate(Oasis::Imaginary {}).has_value());
+}
+
+TEST_CASE("Evaluating Unsupported Expressions Fails", "[Evaluate]")
+{
+    const Oasis::Variable x { "x" };
+
+    const auto unbound = Oasis::Evaluate(Oasis::Add { x, Oasis::Real { 1.0 } });
+    REQUIRE_FALSE(unbound.has_value());
+    REQUIRE(unbound.error() == "Variable x is not bound.");
+
+    REQUIRE_FALSE(Oasis::Evaluate(Oasis::Derivative { x, x }, Oasis::VariableBindings {}.Bind("x", 1.0)).has_value());
+}
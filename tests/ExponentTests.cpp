@@ -362,8 +362,10 @@ TEST_CASE("Variable with power Multiplication", "[Exponent][Variable][Multiplica
     REQUIRE(Oasis::Multiply<Oasis::Real, Oasis::Exponent<Oasis::Variable, Oasis::Real>> {
         Oasis::Real { 6.0 }, Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 3.0 } } }
             .Equals(*simplified6));
-    REQUIRE(Oasis::Multiply<Oasis::Real, Oasis::Exponent<Oasis::Variable, Oasis::Real>> {
-        Oasis::Real { 3.0 }, Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 4.0 } } }
+    // 2^x has a different base than x^2, so it is not merged into it
+    REQUIRE(Oasis::Multiply {
+        Oasis::Multiply { Oasis::Real { 3.0 }, Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 2.0 } } },
+        Oasis::Exponent { Oasis::Real { 2.0 }, Oasis::Variable { "x" } } }
             .Equals(*simplified7));
     REQUIRE(Oasis::Multiply<Oasis::Real, Oasis::Exponent<Oasis::Variable, Oasis::Real>> {
         Oasis::Real { 6.0 }, Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 4.0 } } }
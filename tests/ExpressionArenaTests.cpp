@@ -0,0 +1,71 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/ExpressionArena.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/SimplifyVisitor.hpp"
+#include "Oasis/Variable.hpp"
+
+inline Oasis::SimplifyVisitor simplifyVisitor {};
+
+TEST_CASE("Arenas Nest", "[ExpressionArena]")
+{
+    REQUIRE(Oasis::ExpressionArena::Current() == nullptr);
+
+    {
+        Oasis::ExpressionArena outer;
+        REQUIRE(Oasis::ExpressionArena::Current() == &outer);
+
+        {
+            Oasis::ExpressionArena inner;
+            REQUIRE(Oasis::ExpressionArena::Current() == &inner);
+        }
+
+        REQUIRE(Oasis::ExpressionArena::Current() == &outer);
+    }
+
+    REQUIRE(Oasis::ExpressionArena::Current() == nullptr);
+}
+
+TEST_CASE("Simplifying Inside An Arena", "[ExpressionArena][Simplify]")
+{
+    const Oasis::Add expression {
+        Oasis::Multiply { Oasis::Real { 2.0 }, Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 2.0 } } },
+        Oasis::Multiply { Oasis::Real { 3.0 }, Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 2.0 } } }
+    };
+
+    std::unique_ptr<Oasis::Expression> result;
+
+    {
+        Oasis::ExpressionArena arena;
+        auto simplified = expression.Accept(simplifyVisitor).value();
+        REQUIRE(arena.BytesAllocated() > 0);
+
+        result = arena.Relocate(*simplified);
+    }
+
+    const Oasis::Multiply expected { Oasis::Real { 5.0 }, Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 2.0 } } };
+    REQUIRE(result->Equals(expected));
+}
+
+TEST_CASE("Relocation Preserves Shared Operands", "[ExpressionArena]")
+{
+    std::unique_ptr<Oasis::Expression> result;
+
+    {
+        Oasis::ExpressionArena arena;
+        const Oasis::Add sum { Oasis::Variable { "x" }, Oasis::Real { 1.0 } };
+
+        Oasis::Multiply<> product;
+        product.SetMostSigOp(Oasis::ShareOperand(sum.Copy()));
+        product.SetLeastSigOp(product.mostSigOp);
+
+        result = arena.Relocate(product);
+    }
+
+    const auto& product = static_cast<const Oasis::Multiply<>&>(*result);
+    REQUIRE(&product.GetMostSigOp() == &product.GetLeastSigOp());
+    REQUIRE(product.GetMostSigOp().Equals(Oasis::Add { Oasis::Variable { "x" }, Oasis::Real { 1.0 } }));
+}
@@ -0,0 +1,68 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/ExpressionStore.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Negate.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/Variable.hpp"
+
+TEST_CASE("Interned Subtrees Are Shared", "[ExpressionStore]")
+{
+    Oasis::ExpressionStore store;
+
+    const Oasis::Exponent square { Oasis::Variable { "x" }, Oasis::Real { 2.0 } };
+    const auto sum = store.Intern(Oasis::Add { square, Oasis::Real { 1.0 } });
+    const auto product = store.Intern(Oasis::Multiply { square, Oasis::Real { 3.0 } });
+
+    const auto& sumAdd = static_cast<const Oasis::Add<>&>(*sum);
+    const auto& productMultiply = static_cast<const Oasis::Multiply<>&>(*product);
+
+    REQUIRE(&sumAdd.GetMostSigOp() == &productMultiply.GetMostSigOp());
+    REQUIRE(sumAdd.GetMostSigOp().Equals(square));
+
+    // x, 2, x^2, 1, x^2 + 1, 3, x^2 * 3
+    REQUIRE(store.Size() == 7);
+}
+
+TEST_CASE("Interning Equal Expressions Yields The Same Node", "[ExpressionStore]")
+{
+    Oasis::ExpressionStore store;
+
+    const auto first = store.Intern(Oasis::Negate { Oasis::Add { Oasis::Variable { "x" }, Oasis::Real { 1.0 } } });
+    const auto second = store.Intern(Oasis::Negate { Oasis::Add { Oasis::Variable { "x" }, Oasis::Real { 1.0 } } });
+    const auto different = store.Intern(Oasis::Negate { Oasis::Add { Oasis::Variable { "y" }, Oasis::Real { 1.0 } } });
+
+    REQUIRE(first == second);
+    REQUIRE(first != different);
+    REQUIRE(first->Equals(*second));
+    REQUIRE_FALSE(first->Equals(*different));
+}
+
+TEST_CASE("Interning An Interned Subtree Is A Lookup", "[ExpressionStore]")
+{
+    Oasis::ExpressionStore store;
+
+    const auto sum = store.Intern(Oasis::Add { Oasis::Variable { "x" }, Oasis::Real { 1.0 } });
+    const auto& augend = static_cast<const Oasis::Add<>&>(*sum).GetMostSigOp();
+
+    REQUIRE(store.Contains(augend));
+    REQUIRE(store.Intern(augend).get() == &augend);
+    REQUIRE(store.Intern(*sum) == sum);
+    REQUIRE_FALSE(store.Contains(Oasis::Variable { "x" }));
+
+    store.Clear();
+    REQUIRE(store.Size() == 0);
+    REQUIRE(sum->Equals(Oasis::Add { Oasis::Variable { "x" }, Oasis::Real { 1.0 } }));
+}
+
+TEST_CASE("Copies Share Operands", "[ExpressionStore]")
+{
+    const Oasis::Add sum { Oasis::Variable { "x" }, Oasis::Real { 1.0 } };
+    const auto copy = sum.Copy();
+
+    const auto& copiedSum = static_cast<const Oasis::Add<>&>(*copy);
+    REQUIRE(&copiedSum.GetMostSigOp() == &sum.GetMostSigOp());
+    REQUIRE(&copiedSum.GetLeastSigOp() == &sum.GetLeastSigOp());
+}
@@ -0,0 +1,69 @@
+#include "catch2/benchmark/catch_benchmark.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/MatchCast.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/RecursiveCast.hpp"
+#include "Oasis/SimplifyVisitor.hpp"
+#include "Oasis/Variable.hpp"
+
+namespace {
+
+using CaseResult = std::expected<gsl_lite::not_null<std::unique_ptr<Oasis::Expression>>, std::string_view>;
+
+constexpr auto match_cast = Oasis::MatchCast<Oasis::Expression>()
+                                .Case(
+                                    [](const Oasis::Add<Oasis::Real, Oasis::Variable>& add) -> bool {
+                                        return add.GetMostSigOp().GetValue() == 0.0;
+                                    },
+                                    [](const Oasis::Add<Oasis::Real, Oasis::Variable>& add, const void*) -> CaseResult {
+                                        return gsl_lite::make_not_null(add.GetLeastSigOp().Copy());
+                                    })
+                                .Case(
+                                    [](const Oasis::Add<Oasis::Real, Oasis::Variable>&) -> bool { return true; },
+                                    [](const Oasis::Add<Oasis::Real, Oasis::Variable>&, const void*) -> CaseResult {
+                                        return gsl_lite::make_not_null(std::make_unique<Oasis::Real>(1.0));
+                                    })
+                                .Case(
+                                    [](const Oasis::Expression&) -> bool { return true; },
+                                    [](const Oasis::Expression&, const void*) -> CaseResult {
+                                        return gsl_lite::make_not_null(std::make_unique<Oasis::Real>(2.0));
+                                    });
+
+}
+
+TEST_CASE("MatchCast Applies The First Matching Case", "[MatchCast]")
+{
+    const auto zero = match_cast.Execute(Oasis::Add { Oasis::Variable { "x" }, Oasis::Real { 0.0 } }, nullptr);
+    REQUIRE(zero.has_value());
+    REQUIRE((*zero)->Equals(Oasis::Variable { "x" }));
+
+    const auto nonzero = match_cast.Execute(Oasis::Add { Oasis::Real { 3.0 }, Oasis::Variable { "x" } }, nullptr);
+    REQUIRE(nonzero.has_value());
+    REQUIRE((*nonzero)->Equals(Oasis::Real { 1.0 }));
+}
+
+TEST_CASE("MatchCast Falls Through To Wildcard Cases", "[MatchCast]")
+{
+    const auto other = match_cast.Execute(Oasis::Add { Oasis::Real { 3.0 }, Oasis::Real { 4.0 } }, nullptr);
+    REQUIRE(other.has_value());
+    REQUIRE((*other)->Equals(Oasis::Real { 2.0 }));
+
+    const auto leaf = match_cast.Execute(Oasis::Variable { "x" }, nullptr);
+    REQUIRE(leaf.has_value());
+    REQUIRE((*leaf)->Equals(Oasis::Real { 2.0 }));
+}
+
+TEST_CASE("Exponent Simplification Benchmark", "[MatchCast][!benchmark]")
+{
+    Oasis::SimplifyVisitor simplifyVisitor {};
+    const Oasis::Exponent exponent { Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 2.0 } }, Oasis::Variable { "y" } };
+
+    BENCHMARK("Simplify (x^2)^y")
+    {
+        return exponent.Accept(simplifyVisitor);
+    };
+}
@@ -0,0 +1,70 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/ExpressionArena.hpp"
+#include "Oasis/Match.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Negate.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/RecursiveCast.hpp"
+#include "Oasis/Subtract.hpp"
+#include "Oasis/Variable.hpp"
+
+TEST_CASE("Match Views The Original Operands", "[Match]")
+{
+    const Oasis::Add<> add {
+        Oasis::Multiply { Oasis::Real { 2.0 }, Oasis::Variable { "x" } },
+        Oasis::Multiply { Oasis::Real { 3.0 }, Oasis::Variable { "x" } }
+    };
+
+    const auto likeTerms = Oasis::Match<Oasis::Add<Oasis::Multiply<Oasis::Real, Oasis::Expression>>>(add);
+    REQUIRE(likeTerms.has_value());
+
+    const auto& augend = static_cast<const Oasis::Multiply<>&>(add.GetMostSigOp());
+    REQUIRE(&likeTerms->GetExpression() == &add);
+    REQUIRE(&likeTerms->GetMostSigOp().GetExpression() == &augend);
+    REQUIRE(&likeTerms->GetMostSigOp().GetMostSigOp() == &augend.GetMostSigOp());
+    REQUIRE(likeTerms->GetMostSigOp().GetMostSigOp().GetValue() == 2.0);
+    REQUIRE(likeTerms->GetLeastSigOp().GetMostSigOp().GetValue() == 3.0);
+    REQUIRE(likeTerms->GetLeastSigOp().GetLeastSigOp().Equals(Oasis::Variable { "x" }));
+}
+
+TEST_CASE("Match Considers Commutative Property", "[Match]")
+{
+    const Oasis::Add<> add { Oasis::Variable { "x" }, Oasis::Real { 1.0 } };
+    const auto realCase = Oasis::Match<Oasis::Add<Oasis::Real, Oasis::Variable>>(add);
+
+    REQUIRE(realCase.has_value());
+    REQUIRE(realCase->GetMostSigOp().GetValue() == 1.0);
+    REQUIRE(realCase->GetLeastSigOp().GetName() == "x");
+
+    const Oasis::Subtract<> subtract { Oasis::Variable { "x" }, Oasis::Real { 1.0 } };
+    REQUIRE_FALSE(Oasis::Match<Oasis::Subtract<Oasis::Real, Oasis::Variable>>(subtract).has_value());
+    REQUIRE(Oasis::Match<Oasis::Subtract<Oasis::Variable, Oasis::Real>>(subtract).has_value());
+}
+
+TEST_CASE("Match Rejects Mismatched Expressions", "[Match]")
+{
+    const Oasis::Negate<> negate { Oasis::Add { Oasis::Variable { "x" }, Oasis::Real { 1.0 } } };
+
+    REQUIRE(Oasis::Match<Oasis::Negate<Oasis::Add<Oasis::Variable, Oasis::Real>>>(negate).has_value());
+    REQUIRE_FALSE(Oasis::Match<Oasis::Negate<Oasis::Add<Oasis::Real, Oasis::Real>>>(negate).has_value());
+    REQUIRE_FALSE(Oasis::Match<Oasis::Negate<Oasis::Multiply<Oasis::Expression, Oasis::Real>>>(negate).has_value());
+    REQUIRE_FALSE(Oasis::Match<Oasis::Real>(negate).has_value());
+}
+
+TEST_CASE("Match Does Not Allocate", "[Match][ExpressionArena]")
+{
+    const Oasis::Add<> add {
+        Oasis::Multiply { Oasis::Real { 2.0 }, Oasis::Variable { "x" } },
+        Oasis::Multiply { Oasis::Variable { "x" }, Oasis::Real { 3.0 } }
+    };
+
+    Oasis::ExpressionArena arena;
+
+    REQUIRE(Oasis::Match<Oasis::Add<Oasis::Multiply<Oasis::Real, Oasis::Variable>>>(add).has_value());
+    REQUIRE(arena.BytesAllocated() == 0);
+
+    REQUIRE(Oasis::RecursiveCast<Oasis::Add<Oasis::Multiply<Oasis::Real, Oasis::Variable>>>(add) != nullptr);
+    REQUIRE(arena.BytesAllocated() > 0);
+}
@@ -11,6 +11,7 @@
 #include "Oasis/Multiply.hpp"
 #include "Oasis/Real.hpp"
 #include "Oasis/RecursiveCast.hpp"
+#include "Oasis/Variable.hpp"
 #include <Oasis/Divide.hpp>
 
 inline Oasis::SimplifyVisitor simplifyVisitor {};
@@ -77,6 +78,23 @@ TEST_CASE("Imaginary Multiplication", "[Imaginary][Multiplication]")
     REQUIRE(Oasis::Real { 1.0 }.Equals(*simplified4));
 }
 
+TEST_CASE("Imaginary Multiplication Without A Coefficient", "[Imaginary][Multiplication]")
+{
+    const Oasis::Variable x { "x" };
+
+    // i * i * x = -x
+    const Oasis::Multiply<> i2x { Oasis::Imaginary {}, Oasis::Imaginary {}, x };
+    REQUIRE(i2x.Accept(simplifyVisitor).value()->Equals(Oasis::Multiply { Oasis::Real { -1 }, x }));
+
+    // i * (i * x) = -x
+    const Oasis::Multiply nested { Oasis::Imaginary {}, Oasis::Multiply { Oasis::Imaginary {}, x } };
+    REQUIRE(nested.Accept(simplifyVisitor).value()->Equals(Oasis::Multiply { Oasis::Real { -1 }, x }));
+
+    // i^3 * x = -ix
+    const Oasis::Multiply i3x { Oasis::Exponent { Oasis::Imaginary {}, Oasis::Real { 3 } }, x };
+    REQUIRE(i3x.Accept(simplifyVisitor).value()->Equals(Oasis::Multiply<> { Oasis::Real { -1 }, Oasis::Imaginary {}, x }));
+}
+
 TEST_CASE("Multiply Associativity", "[Multiply][Associativity]")
 {
     Oasis::Multiply m1 {
@@ -219,4 +237,55 @@ TEST_CASE("Multiplying Quadratics", "[Multiply]")
     OASIS_CAPTURE_WITH_SERIALIZER(*expected_simpl);
 
     REQUIRE(simplified->Equals(*expected_simpl));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Factors Of Any Shape Are Collected", "[Multiply]")
+{
+    const Oasis::Add sum { Oasis::Variable { "a" }, Oasis::Variable { "b" } };
+
+    // x * y * x^2 * 3 * y^n * (a + b) * (a + b)^2 * 2
+    const Oasis::Multiply<> product {
+        Oasis::Variable { "x" },
+        Oasis::Variable { "y" },
+        Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 2 } },
+        Oasis::Real { 3 },
+        Oasis::Exponent { Oasis::Variable { "y" }, Oasis::Variable { "n" } },
+        sum,
+        Oasis::Exponent { sum, Oasis::Real { 2 } },
+        Oasis::Real { 2 }
+    };
+
+    const auto simplified = product.Accept(simplifyVisitor).value();
+
+    // 6 * x^3 * y^(n + 1) * (a + b)^3
+    const Oasis::Multiply<> expected {
+        Oasis::Real { 6 },
+        Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 3 } },
+        Oasis::Exponent { Oasis::Variable { "y" }, Oasis::Add { Oasis::Variable { "n" }, Oasis::Real { 1 } } },
+        Oasis::Exponent { sum, Oasis::Real { 3 } }
+    };
+
+    OASIS_CAPTURE_WITH_SERIALIZER(*simplified);
+    REQUIRE(simplified->Equals(expected));
+}
+
+TEST_CASE("Long Product Of Like Factors", "[Multiply]")
+{
+    constexpr int factors = 50000;
+    constexpr int variables = 10;
+
+    std::vector<std::unique_ptr<Oasis::Expression>> ops;
+    for (int i = 0; i < factors; ++i) {
+        ops.push_back(std::make_unique<Oasis::Exponent<>>(Oasis::Variable { "x_" + std::to_string(i % variables) }, Oasis::Real { 0.5 }));
+    }
+
+    const auto product = Oasis::BuildFromVector<Oasis::Multiply>(std::move(ops));
+    const auto simplified = product->Accept(simplifyVisitor).value();
+
+    std::vector<std::unique_ptr<Oasis::Expression>> expectedOps;
+    for (int i = 0; i < variables; ++i) {
+        expectedOps.push_back(std::make_unique<Oasis::Exponent<>>(Oasis::Variable { "x_" + std::to_string(i) }, Oasis::Real { factors / variables * 0.5 }));
+    }
+
+    REQUIRE(simplified->Equals(*Oasis::BuildFromVector<Oasis::Multiply>(std::move(expectedOps))));
+}
@@ -0,0 +1,46 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Exponent.hpp"
+#include "Oasis/NormalForm.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/SimplifyVisitor.hpp"
+#include "Oasis/Variable.hpp"
+
+TEST_CASE("Simplifying To A Fixed Point", "[NormalForm][Simplify]")
+{
+    // (x^2)^0.5 takes more than one pass to simplify fully.
+    const Oasis::Exponent expression { Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 2.0 } }, Oasis::Real { 0.5 } };
+
+    Oasis::SimplifyVisitor simplifyVisitor {};
+    const auto onePass = expression.Accept(simplifyVisitor).value();
+    const auto twoPasses = onePass->Accept(simplifyVisitor).value();
+    REQUIRE_FALSE(onePass->Equals(*twoPasses));
+
+    const auto result = Oasis::SimplifyToNormalForm(expression);
+    REQUIRE(result.has_value());
+    REQUIRE(result->converged);
+    REQUIRE(result->passes > 2);
+    REQUIRE(result->simplifications > 0);
+
+    const auto again = result->expression->Accept(simplifyVisitor).value();
+    REQUIRE(again->Equals(*result->expression));
+}
+
+TEST_CASE("Normal Form Budget", "[NormalForm][Simplify]")
+{
+    const Oasis::Exponent expression { Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 2.0 } }, Oasis::Real { 0.5 } };
+
+    const auto onePass = Oasis::SimplifyToNormalForm(expression, { .maxPasses = 1 });
+    REQUIRE(onePass.has_value());
+    REQUIRE_FALSE(onePass->converged);
+    REQUIRE(onePass->passes == 1);
+
+    Oasis::SimplifyVisitor simplifyVisitor {};
+    REQUIRE(onePass->expression->Equals(*expression.Accept(simplifyVisitor).value()));
+
+    const auto noBudget = Oasis::SimplifyToNormalForm(expression, { .maxSimplifications = 0 });
+    REQUIRE(noBudget.has_value());
+    REQUIRE_FALSE(noBudget->converged);
+    REQUIRE(noBudget->passes == 0);
+    REQUIRE(noBudget->expression->Equals(expression));
+}
@@ -0,0 +1,82 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/Derivative.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/Imaginary.hpp"
+#include "Oasis/Log.hpp"
+#include "Oasis/Matrix.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/SimplifyVisitor.hpp"
+#include "Oasis/Variable.hpp"
+
+TEST_CASE("Detecting Rule Groups", "[RuleGroups]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Add polynomial { Oasis::Multiply { Oasis::Real { 3.0 }, Oasis::Exponent { x, Oasis::Real { 2.0 } } }, x };
+
+    REQUIRE(Oasis::DetectRuleGroups(polynomial) == Oasis::SimplifyOpts::RuleGroups { .matrix = false, .complex = false, .logarithm = false, .trig = false, .calculus = false });
+
+    const Oasis::Add logarithmic { polynomial, Oasis::Log { Oasis::Real { 10.0 }, x } };
+    REQUIRE(Oasis::DetectRuleGroups(logarithmic) == Oasis::SimplifyOpts::RuleGroups { .matrix = false, .complex = false, .logarithm = true, .trig = false, .calculus = false });
+
+    const Oasis::Exponent root { x, Oasis::Real { 0.5 } };
+    REQUIRE(Oasis::DetectRuleGroups(root).complex);
+    REQUIRE(Oasis::DetectRuleGroups(Oasis::Multiply { Oasis::Real { 2.0 }, Oasis::Imaginary {} }).complex);
+
+    // Calculus may introduce expressions of any type
+    REQUIRE(Oasis::DetectRuleGroups(Oasis::Derivative { polynomial, x }) == Oasis::SimplifyOpts::RuleGroups {});
+}
+
+TEST_CASE("Disabled Rule Groups Are Skipped", "[RuleGroups]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Variable y { "y" };
+    const Oasis::Add logs { Oasis::Log { Oasis::Real { 10.0 }, x }, Oasis::Log { Oasis::Real { 10.0 }, y } };
+
+    Oasis::SimplifyVisitor defaultVisitor {};
+    REQUIRE(logs.Accept(defaultVisitor).value()->Equals(Oasis::Log { Oasis::Real { 10.0 }, Oasis::Multiply { x, y } }));
+
+    Oasis::SimplifyOpts withoutLogarithms {};
+    withoutLogarithms.ruleGroups.logarithm = false;
+    Oasis::SimplifyVisitor withoutLogarithmsVisitor { withoutLogarithms };
+    REQUIRE(logs.Accept(withoutLogarithmsVisitor).value()->Equals(logs));
+
+    // Without matrix rules, matrices are left unmultiplied and in order
+    const Oasis::Matrix a { Oasis::MatrixXXD { { 1.0, 2.0 }, { 3.0, 4.0 } } };
+    const Oasis::Matrix b { Oasis::MatrixXXD { { 0.0, 1.0 }, { 1.0, 0.0 } } };
+    const Oasis::Multiply product { a, b };
+
+    Oasis::SimplifyOpts withoutMatrices {};
+    withoutMatrices.ruleGroups.matrix = false;
+    Oasis::SimplifyVisitor withoutMatricesVisitor { withoutMatrices };
+    REQUIRE(product.Accept(withoutMatricesVisitor).value()->Equals(product));
+    REQUIRE(product.Accept(defaultVisitor).value()->Equals(Oasis::Matrix { Oasis::MatrixXXD { { 2.0, 1.0 }, { 4.0, 3.0 } } }));
+
+    Oasis::SimplifyOpts withoutCalculus {};
+    withoutCalculus.ruleGroups.calculus = false;
+    Oasis::SimplifyVisitor withoutCalculusVisitor { withoutCalculus };
+    const Oasis::Derivative derivative { Oasis::Exponent { x, Oasis::Real { 2.0 } }, x };
+    REQUIRE(derivative.Accept(withoutCalculusVisitor).value()->Equals(derivative));
+}
+
+TEST_CASE("Detected Rule Groups Simplify Like Every Group", "[RuleGroups]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Variable y { "y" };
+
+    Oasis::SimplifyOpts detecting {};
+    detecting.detectRuleGroups = true;
+    Oasis::SimplifyVisitor detectingVisitor { detecting };
+    Oasis::SimplifyVisitor defaultVisitor {};
+
+    const Oasis::Add polynomial { Oasis::Multiply { Oasis::Real { 3.0 }, Oasis::Exponent { x, Oasis::Real { 2.0 } } }, Oasis::Multiply { x, x } };
+    const Oasis::Add logs { Oasis::Log { Oasis::Real { 10.0 }, x }, Oasis::Log { Oasis::Real { 10.0 }, y } };
+    const Oasis::Multiply imaginary { Oasis::Imaginary {}, Oasis::Multiply { Oasis::Imaginary {}, x } };
+    const Oasis::Derivative derivative { Oasis::Exponent { x, Oasis::Real { 2.0 } }, x };
+
+    for (const Oasis::Expression* expression : std::initializer_list<const Oasis::Expression*> { &polynomial, &logs, &imaginary, &derivative }) {
+        REQUIRE(expression->Accept(detectingVisitor).value()->Equals(*expression->Accept(defaultVisitor).value()));
+    }
+}
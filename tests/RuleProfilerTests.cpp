@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <memory>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Exponent.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/RuleProfiler.hpp"
+#include "Oasis/SimplifyVisitor.hpp"
+#include "Oasis/Subtract.hpp"
+#include "Oasis/Variable.hpp"
+
+TEST_CASE("Recording Rule Statistics", "[RuleProfiler]")
+{
+    using namespace std::chrono_literals;
+
+    Oasis::RuleProfiler profiler;
+    profiler.Record("a", false, 1us);
+    profiler.Record("a", true, 1us, 5us);
+    profiler.Record("b", true, 1us, 1us);
+
+    const auto stats = profiler.GetStats();
+    REQUIRE(stats.size() == 2);
+
+    REQUIRE(stats[0].name == "a");
+    REQUIRE(stats[0].attempts == 2);
+    REQUIRE(stats[0].hits == 1);
+    REQUIRE(stats[0].matchTime == 2us);
+    REQUIRE(stats[0].transformTime == 5us);
+
+    REQUIRE(stats[1].name == "b");
+    REQUIRE(stats[1].attempts == 1);
+    REQUIRE(stats[1].hits == 1);
+
+    profiler.Reset();
+    REQUIRE(profiler.GetStats().empty());
+}
+
+TEST_CASE("Profiling Simplification Rules", "[RuleProfiler][Simplify]")
+{
+    const auto profiler = std::make_shared<Oasis::RuleProfiler>();
+
+    Oasis::SimplifyVisitor simplifyVisitor {};
+    simplifyVisitor.SetProfiler(profiler);
+    REQUIRE(simplifyVisitor.GetProfiler() == profiler);
+
+    // 3 - 2 and x^1 each fire a rule.
+    const Oasis::Exponent expression { Oasis::Variable { "x" }, Oasis::Subtract { Oasis::Real { 3.0 }, Oasis::Real { 2.0 } } };
+    const auto simplified = expression.Accept(simplifyVisitor).value();
+    REQUIRE(simplified->Equals(Oasis::Variable { "x" }));
+
+    const auto stats = profiler->GetStats();
+
+    if constexpr (!Oasis::RuleProfiler::Enabled) {
+        REQUIRE(stats.empty());
+        return;
+    }
+
+    const auto hits = [&stats](std::string_view rule) {
+        const auto it = std::ranges::find(stats, rule, &Oasis::RuleStats::name);
+        return it == stats.end() ? 0 : it->hits;
+    };
+
+    REQUIRE(hits("Subtract: a - b") == 1);
+    REQUIRE(hits("Exponent: x^1") == 1);
+    REQUIRE(hits("Exponent: x^0") == 0);
+}
@@ -0,0 +1,78 @@
+#include <string>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/ExpressionArena.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/SimplifyBatch.hpp"
+#include "Oasis/Variable.hpp"
+
+TEST_CASE("Simplifying A Batch Of Expressions", "[SimplifyBatch][Simplify]")
+{
+    // Every expression shares the subexpression 2x^2 with the others.
+    const Oasis::Multiply shared { Oasis::Real { 2.0 }, Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 2.0 } } };
+
+    std::vector<std::unique_ptr<Oasis::Expression>> owned;
+    for (int i = 0; i < 200; ++i) {
+        owned.push_back(std::make_unique<Oasis::Add<>>(Oasis::Multiply { Oasis::Real { 1.0 }, shared }, Oasis::Multiply { Oasis::Real { static_cast<double>(i) }, Oasis::Variable { "y_" + std::to_string(i % 5) } }));
+    }
+
+    std::vector<const Oasis::Expression*> expressions;
+    for (const auto& expression : owned) {
+        expressions.push_back(expression.get());
+    }
+    expressions.push_back(nullptr);
+
+    const auto batch = Oasis::SimplifyBatch(expressions, {}, { .threadPool = std::make_shared<Oasis::ThreadPool>(4), .grainSize = 8 });
+
+    REQUIRE(batch.results.size() == expressions.size());
+    REQUIRE(batch.metrics.expressions == expressions.size());
+    REQUIRE(batch.metrics.failures == 1);
+    REQUIRE(batch.metrics.threads == 4);
+    REQUIRE(batch.metrics.cacheHits > 0);
+    REQUIRE_FALSE(batch.results.back().has_value());
+
+    Oasis::SimplifyVisitor simplifyVisitor {};
+    for (std::size_t i = 0; i < owned.size(); ++i) {
+        REQUIRE(batch.results[i].value()->Equals(*owned[i]->Accept(simplifyVisitor).value()));
+    }
+}
+
+TEST_CASE("Batches Share A Cache", "[SimplifyBatch][SimplifyCache]")
+{
+    const Oasis::Add expression { Oasis::Variable { "x" }, Oasis::Variable { "x" } };
+    const std::vector<const Oasis::Expression*> expressions { &expression };
+
+    const Oasis::SimplifyBatchOpts batchOpts { .cache = std::make_shared<Oasis::SimplifyCache>(64, 4) };
+
+    const auto first = Oasis::SimplifyBatch(expressions, {}, batchOpts);
+    REQUIRE(first.metrics.cacheHits == 0);
+
+    const auto second = Oasis::SimplifyBatch(expressions, {}, batchOpts);
+    REQUIRE(second.metrics.cacheHits == 1);
+    REQUIRE(second.metrics.cacheMisses == 0);
+    REQUIRE(second.results.front().value()->Equals(*first.results.front().value()));
+}
+
+TEST_CASE("Batches Do Not Cache Arena Nodes", "[SimplifyBatch][SimplifyCache][Arena]")
+{
+    const Oasis::Add expression { Oasis::Variable { "x" }, Oasis::Variable { "x" } };
+    const std::vector<const Oasis::Expression*> expressions { &expression };
+
+    const Oasis::SimplifyBatchOpts batchOpts { .cache = std::make_shared<Oasis::SimplifyCache>(64, 4) };
+
+    {
+        Oasis::ExpressionArena arena;
+        const auto first = Oasis::SimplifyBatch(expressions, {}, batchOpts);
+        REQUIRE(first.results.front().has_value());
+        REQUIRE(arena.BytesAllocated() == 0);
+    }
+
+    const auto second = Oasis::SimplifyBatch(expressions, {}, batchOpts);
+    REQUIRE(second.metrics.cacheHits == 1);
+    REQUIRE(second.results.front().value()->Equals(Oasis::Multiply { Oasis::Real { 2.0 }, Oasis::Variable { "x" } }));
+}
@@ -0,0 +1,120 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/CancellationToken.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/SimplifyCache.hpp"
+#include "Oasis/SimplifyVisitor.hpp"
+#include "Oasis/Variable.hpp"
+
+TEST_CASE("Repeated Subexpressions Are Simplified Once", "[SimplifyCache][Simplify]")
+{
+    const auto cache = std::make_shared<Oasis::SimplifyCache>(64);
+    Oasis::SimplifyVisitor simplifyVisitor { Oasis::SimplifyOpts {}, cache };
+
+    const Oasis::Multiply term { Oasis::Real { 2.0 }, Oasis::Exponent { Oasis::Variable { "x" }, Oasis::Real { 2.0 } } };
+    const Oasis::Add expression { Oasis::Exponent { term, Oasis::Real { 1.0 } }, Oasis::Exponent { term, Oasis::Real { 1.0 } } };
+
+    Oasis::SimplifyVisitor uncachedVisitor {};
+    const auto expected = expression.Accept(uncachedVisitor).value();
+
+    const auto first = expression.Accept(simplifyVisitor).value();
+    REQUIRE(first->Equals(*expected));
+    REQUIRE(cache->GetHits() > 0);
+
+    const auto misses = cache->GetMisses();
+    const auto second = expression.Accept(simplifyVisitor).value();
+    REQUIRE(second->Equals(*expected));
+    REQUIRE(cache->GetMisses() == misses);
+}
+
+TEST_CASE("Cache Entries Depend On Options", "[SimplifyCache][Simplify]")
+{
+    const auto cache = std::make_shared<Oasis::SimplifyCache>(64);
+    const Oasis::Add expression { Oasis::Variable { "x" }, Oasis::Variable { "x" } };
+
+    Oasis::SimplifyVisitor radians { Oasis::SimplifyOpts {}, cache };
+    std::ignore = expression.Accept(radians);
+    const auto hits = cache->GetHits();
+
+    Oasis::SimplifyVisitor degrees { Oasis::SimplifyOpts { .angleUnits = Oasis::SimplifyOpts::AngleUnits::DEGREES }, cache };
+    std::ignore = expression.Accept(degrees);
+    REQUIRE(cache->GetHits() == hits);
+
+    std::ignore = expression.Accept(radians);
+    REQUIRE(cache->GetHits() > hits);
+}
+
+TEST_CASE("Cancelled Simplifications Are Not Cached", "[SimplifyCache][Cancellation]")
+{
+    const auto cache = std::make_shared<Oasis::SimplifyCache>(64);
+    Oasis::SimplifyVisitor simplifyVisitor { Oasis::SimplifyOpts {}, cache };
+
+    // (1 + 2) + (3 + 4) * x
+    const Oasis::Add expression {
+        Oasis::Add { Oasis::Real { 1.0 }, Oasis::Real { 2.0 } },
+        Oasis::Multiply { Oasis::Add { Oasis::Real { 3.0 }, Oasis::Real { 4.0 } }, Oasis::Variable { "x" } }
+    };
+
+    Oasis::CancellationToken token;
+    token.SetVisitBudget(2);
+    REQUIRE_FALSE(Oasis::WithCancellation(token, [&] { return expression.Accept(simplifyVisitor); }).has_value());
+
+    Oasis::SimplifyVisitor uncachedVisitor {};
+    REQUIRE(expression.Accept(simplifyVisitor).value()->Equals(*expression.Accept(uncachedVisitor).value()));
+}
+
+TEST_CASE("Cache Evicts Least Recently Used Entries", "[SimplifyCache]")
+{
+    Oasis::SimplifyCache cache { 2 };
+
+    const Oasis::Variable x { "x" }, y { "y" }, z { "z" };
+    cache.Insert(x, 0, Oasis::Real { 1.0 });
+    cache.Insert(y, 0, Oasis::Real { 2.0 });
+
+    REQUIRE(cache.Find(x, 0) != nullptr);
+
+    cache.Insert(z, 0, Oasis::Real { 3.0 });
+    REQUIRE(cache.Size() == 2);
+    REQUIRE(cache.Find(y, 0) == nullptr);
+    REQUIRE(cache.Find(x, 0)->Equals(Oasis::Real { 1.0 }));
+    REQUIRE(cache.Find(z, 0)->Equals(Oasis::Real { 3.0 }));
+    REQUIRE(cache.Find(z, 1) == nullptr);
+
+    REQUIRE(cache.GetHits() == 3);
+    REQUIRE(cache.GetMisses() == 2);
+}
+
+TEST_CASE("Sharded Cache Is Shared Between Threads", "[SimplifyCache]")
+{
+    Oasis::SimplifyCache cache { 4096, 8 };
+    REQUIRE(cache.GetShardCount() == 8);
+    REQUIRE(cache.GetCapacity() == 4096);
+
+    std::atomic<int> found = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, &found, t] {
+            for (int i = 0; i < 250; ++i) {
+                const Oasis::Variable variable { "x_" + std::to_string(t * 250 + i) };
+                cache.Insert(variable, 0, Oasis::Real { static_cast<double>(i) });
+                found += cache.Find(variable, 0) != nullptr;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(found == 1000);
+    REQUIRE(cache.GetHits() == 1000);
+    REQUIRE(cache.Size() == 1000);
+}
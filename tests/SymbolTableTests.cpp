@@ -0,0 +1,32 @@
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/SymbolTable.hpp"
+#include "Oasis/Variable.hpp"
+
+TEST_CASE("Interning A Name Twice Yields The Same Id", "[SymbolTable]")
+{
+    Oasis::SymbolTable table;
+
+    const auto x = table.Intern("x");
+    const auto y = table.Intern("y");
+
+    REQUIRE(x != y);
+    REQUIRE(table.Intern(std::string { "x" }) == x);
+    REQUIRE(table.GetName(x) == "x");
+    REQUIRE(table.GetName(y) == "y");
+    REQUIRE(table.Intern("") == 0);
+    REQUIRE(table.Size() == 3);
+}
+
+TEST_CASE("Variables Share Symbols", "[SymbolTable][Variable]")
+{
+    const Oasis::Variable x { "x" };
+    const Oasis::Variable alsoX { std::string { "x" } };
+    const Oasis::Variable y { "y" };
+
+    REQUIRE(x.GetSymbol() == alsoX.GetSymbol());
+    REQUIRE(x.GetSymbol() != y.GetSymbol());
+    REQUIRE(&x.GetName() == &alsoX.GetName());
+    REQUIRE(x.GetName() == "x");
+    REQUIRE(Oasis::Variable {}.GetName().empty());
+}
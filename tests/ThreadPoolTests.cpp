@@ -0,0 +1,184 @@
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "Oasis/Add.hpp"
+#include "Oasis/CancellationToken.hpp"
+#include "Oasis/DifferentiateVisitor.hpp"
+#include "Oasis/Exponent.hpp"
+#include "Oasis/ExpressionArena.hpp"
+#include "Oasis/Multiply.hpp"
+#include "Oasis/Real.hpp"
+#include "Oasis/SimplifyVisitor.hpp"
+#include "Oasis/Subtract.hpp"
+#include "Oasis/ThreadPool.hpp"
+#include "Oasis/Variable.hpp"
+
+namespace {
+auto Fibonacci(Oasis::ThreadPool& pool, int n) -> int
+{
+    if (n < 2) {
+        return n;
+    }
+
+    const auto [first, second] = pool.ParallelInvoke([&] { return Fibonacci(pool, n - 1); }, [&] { return Fibonacci(pool, n - 2); });
+    return first + second;
+}
+
+// A balanced tree of sums and differences of terms like 3x^2, with depth levels.
+auto BalancedTree(int depth, int& index) -> std::unique_ptr<Oasis::Expression>
+{
+    if (depth == 0) {
+        const Oasis::Variable variable { "x_" + std::to_string(index % 7) };
+        const Oasis::Real coefficient { static_cast<double>(++index % 5 + 1) };
+        return Oasis::Multiply { coefficient, Oasis::Exponent { variable, Oasis::Real { 2.0 } } }.Copy();
+    }
+
+    auto left = BalancedTree(depth - 1, index);
+    auto right = BalancedTree(depth - 1, index);
+
+    if (depth % 2 == 0) {
+        return std::make_unique<Oasis::Subtract<>>(*left, *right);
+    }
+    return std::make_unique<Oasis::Add<>>(*left, *right);
+}
+}
+
+TEST_CASE("Running Tasks On A Thread Pool", "[ThreadPool]")
+{
+    Oasis::ThreadPool pool { 2 };
+    REQUIRE(pool.GetThreadCount() == 2);
+
+    auto answer = pool.Submit([] { return 42; });
+    REQUIRE(pool.Wait(answer) == 42);
+
+    std::atomic<long> sum = 0;
+    pool.ParallelFor(1000, 10, [&sum](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            sum += static_cast<long>(i);
+        }
+    });
+    REQUIRE(sum == 499500);
+
+    // Tasks waiting on their own subtasks run other tasks meanwhile, so two workers are enough.
+    REQUIRE(Fibonacci(pool, 16) == 987);
+}
+
+TEST_CASE("Exceptions Wait For Outstanding Tasks", "[ThreadPool]")
+{
+    Oasis::ThreadPool pool { 2 };
+
+    // The tasks on the pool outlast the callable that throws, and still finish before it rethrows.
+    std::atomic<int> finished = 0;
+    const auto slowly = [&finished] {
+        std::this_thread::sleep_for(std::chrono::milliseconds { 20 });
+        ++finished;
+        return 0;
+    };
+
+    REQUIRE_THROWS_AS(pool.ParallelInvoke([]() -> int { throw std::runtime_error { "first" }; }, slowly), std::runtime_error);
+    REQUIRE(finished == 1);
+
+    finished = 0;
+    REQUIRE_THROWS_AS(pool.ParallelFor(8, 1, [&](std::size_t begin, std::size_t) {
+        if (begin == 0) {
+            throw std::runtime_error { "first chunk" };
+        }
+        slowly();
+    }),
+        std::runtime_error);
+    REQUIRE(finished == 7);
+}
+
+TEST_CASE("Tasks Run With The Submitting Cancellation Token", "[ThreadPool]")
+{
+    Oasis::ThreadPool pool { 1 };
+    Oasis::CancellationToken token;
+
+    auto current = [&] {
+        Oasis::CancellationScope scope { token };
+        return pool.Submit([] { return Oasis::CancellationToken::Current(); });
+    }();
+
+    REQUIRE(pool.Wait(current) == &token);
+
+    auto none = pool.Submit([] { return Oasis::CancellationToken::Current(); });
+    REQUIRE(pool.Wait(none) == nullptr);
+}
+
+TEST_CASE("Tasks Stolen By A Waiting Thread Keep Their Own Context", "[ThreadPool]")
+{
+    Oasis::ThreadPool pool { 1 };
+
+    // Keeps the only worker busy, so that the next task runs on this thread while it waits.
+    std::atomic<bool> started = false;
+    std::atomic<bool> released = false;
+    auto blocker = pool.Submit([&] {
+        started = true;
+        while (!released) {
+            std::this_thread::yield();
+        }
+    });
+
+    while (!started) {
+        std::this_thread::yield();
+    }
+
+    auto context = pool.Submit([] { return std::pair { Oasis::CancellationToken::Current(), Oasis::ExpressionArena::Current() }; });
+
+    {
+        Oasis::CancellationToken token;
+        Oasis::CancellationScope scope { token };
+        Oasis::ExpressionArena arena;
+
+        REQUIRE(pool.Wait(context) == std::pair<Oasis::CancellationToken*, Oasis::ExpressionArena*> { nullptr, nullptr });
+        REQUIRE(Oasis::CancellationToken::Current() == &token);
+        REQUIRE(Oasis::ExpressionArena::Current() == &arena);
+    }
+
+    released = true;
+    pool.Wait(blocker);
+}
+
+TEST_CASE("Parallel Simplification Matches Sequential Simplification", "[ThreadPool][Simplify]")
+{
+    int index = 0;
+    const auto tree = BalancedTree(10, index);
+
+    Oasis::SimplifyVisitor sequential {};
+    const auto expected = tree->Accept(sequential).value();
+
+    Oasis::SimplifyVisitor parallel {};
+    parallel.SetThreadPool(std::make_shared<Oasis::ThreadPool>(4), 16);
+
+    REQUIRE(tree->Accept(parallel).value()->Equals(*expected));
+
+    std::vector<std::unique_ptr<Oasis::Expression>> terms;
+    for (int i = 0; i < 500; ++i) {
+        terms.push_back(Oasis::Multiply { Oasis::Real { 2.0 }, Oasis::Variable { "x_" + std::to_string(i % 10) } }.Copy());
+    }
+    const auto sum = Oasis::BuildFromVector<Oasis::Add>(std::move(terms));
+
+    REQUIRE(sum->Accept(parallel).value()->Equals(*sum->Accept(sequential).value()));
+}
+
+TEST_CASE("Parallel Differentiation Matches Sequential Differentiation", "[ThreadPool][Differentiate]")
+{
+    int index = 0;
+    const auto tree = BalancedTree(6, index);
+    const std::unique_ptr<Oasis::Expression> x = Oasis::Variable { "x_0" }.Copy();
+
+    Oasis::DifferentiateVisitor sequential { x };
+    const auto expected = tree->Accept(sequential).value();
+
+    Oasis::DifferentiateVisitor parallel { x };
+    parallel.SetThreadPool(std::make_shared<Oasis::ThreadPool>(4), 16);
+
+    REQUIRE(tree->Accept(parallel).value()->Equals(*expected));
+}
@@ -22,4 +22,15 @@ TEST_CASE("Substitute Unary", "[Substitute]")
 
     const auto after = before.Substitute(Oasis::Variable { "x" }, Oasis::Real { 4.0 }); // after should some std::unique_ptr<Expression> such that it equals 2(-4) + 3(4)
     REQUIRE(after->Equals(Oasis::Real { 4 }));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Constructing From An Owned Operand Adopts It", "[TreeManip]")
+{
+    auto operand = std::make_unique<Oasis::Variable>("x");
+    const Oasis::Expression* operandAddress = operand.get();
+
+    const Oasis::Negate<> negate { std::move(operand) };
+
+    REQUIRE(&negate.GetOperand() == operandAddress);
+    REQUIRE(negate.Equals(Oasis::Negate { Oasis::Variable { "x" } }));
+}